@@ -0,0 +1,5 @@
+(define (adder n) (lambda (x) (+ x n)))
+(define (compose f g) (lambda (x) (f (g x))))
+(define (apply-n f n x) (if (equal? n 0) x (apply-n f (- n 1) (f x))))
+(define (repeat n) (if (equal? n 0) 0 (+ (apply-n (compose (adder 1) (adder 2)) 2000 0) (repeat (- n 1)))))
+(repeat 40)
@@ -0,0 +1,2 @@
+(define (fib n) (if (equal? n 0) 0 (if (equal? n 1) 1 (+ (fib (- n 1)) (fib (- n 2))))))
+(fib 25)
@@ -0,0 +1,6 @@
+(define (square x) (* x x))
+(define (zero? n) (equal? n 0))
+(define (dec n) (- n 1))
+(define (sum-squares n acc) (if (zero? n) acc (sum-squares (dec n) (+ acc (square n)))))
+(define (repeat n) (if (zero? n) 0 (+ (sum-squares 2000 0) (repeat (dec n)))))
+(repeat 60)
@@ -0,0 +1,5 @@
+(define (iota n) (if (equal? n 0) (quote ()) (cons n (iota (- n 1)))))
+(define (sum l) (if (null? l) 0 (+ (car l) (sum (cdr l)))))
+(define (rev l acc) (if (null? l) acc (rev (cdr l) (cons (car l) acc))))
+(define (repeat n) (if (equal? n 0) 0 (+ (sum (rev (iota 2000) (quote ()))) (repeat (- n 1)))))
+(repeat 40)
@@ -0,0 +1,7 @@
+(define (build n acc) (if (equal? n 0) acc (build (- n 1) (cons n acc))))
+(define (nest n acc) (if (equal? n 0) acc (nest (- n 1) (cons acc n))))
+(length (build 2000000 (quote ())))
+(equal? (build 2000000 (quote ())) (build 2000000 (quote ())))
+(equal? (nest 2000000 (quote ())) (nest 2000000 (quote ())))
+(build 2000000 (quote ()))
+(nest 2000000 (quote ()))
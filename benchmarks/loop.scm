@@ -0,0 +1,3 @@
+(define (count i acc) (if (equal? i 0) acc (count (- i 1) (+ acc 1))))
+(define (repeat n) (if (equal? n 0) 0 (+ (count 5000 0) (repeat (- n 1)))))
+(repeat 40)
@@ -0,0 +1,3 @@
+(define (build n acc) (if (equal? n 0) acc (build (- n 1) (cons n acc))))
+(define (walk n l acc) (if (equal? n 0) acc (walk (- n 1) l (+ acc (length l)))))
+(walk 200 (build 200000 (quote ())) 0)
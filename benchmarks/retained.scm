@@ -0,0 +1,5 @@
+(define (make-adder n) (lambda (x) (+ x n)))
+(define (build n acc) (if (equal? n 0) acc (build (- n 1) (cons (make-adder n) acc))))
+(define (sum lst acc) (if (null? lst) acc (sum (cdr lst) ((car lst) acc))))
+(define (repeat n total) (if (equal? n 0) total (repeat (- n 1) (sum (build 20000 (quote ())) total))))
+(repeat 40 0)
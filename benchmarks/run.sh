@@ -0,0 +1,27 @@
+#!/bin/bash
+#
+# Time every benchmark with each evaluation engine.
+#
+# Usage: benchmarks/run.sh [path to scheme] [engine ...]
+
+SCHEME=${1:-scheme}
+shift
+ENGINES=${@:-tree node vm}
+
+cd "$(dirname "$0")"
+
+TIMEFORMAT=%R
+printf "%-16s" "benchmark"
+for engine in $ENGINES; do
+    printf "%10s" "$engine"
+done
+printf "\n"
+
+for benchmark in *.scm; do
+    printf "%-16s" "${benchmark%.scm}"
+    for engine in $ENGINES; do
+        seconds=$( { time "$SCHEME" --engine=$engine < "$benchmark" > /dev/null 2>&1; } 2>&1 )
+        printf "%10s" "$seconds"
+    done
+    printf "\n"
+done
@@ -0,0 +1,204 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config-info.h"
+
+#include "scheme-data-types.h"
+#include "parser.h"
+#include "translator.h"
+
+#define SCHEME_INCLUDE_FOLDER "/include/" SCHEME_PROGRAM_NAME
+
+// Largest length of a path or of a command.
+#define SCHEME_COMPILE_BUFFER_SIZE 4096
+
+// Options given to the C compiler to build a procedure module, whose
+// undefined symbols are found in the interpreter when it is loaded.
+#ifdef __APPLE__
+#define SCHEME_COMPILE_MODULE_FLAGS "-shared -fPIC -O2 -std=c99 -undefined dynamic_lookup"
+#else
+#define SCHEME_COMPILE_MODULE_FLAGS "-shared -fPIC -O2 -std=c99"
+#endif
+
+/**
+ * Get the path of a procedure module, without extension. Characters of the
+ * identifier that may not be safe in a file name are replaced with their
+ * hexadecimal code.
+ *
+ * @param  buffer  Buffer of SCHEME_COMPILE_BUFFER_SIZE characters.
+ * @param  folder  Folder of the module.
+ * @param  name    Identifier the procedure is defined as.
+ */
+static void _module_path(char *buffer, const char *folder, scheme_symbol *name)
+{
+    int length = snprintf(buffer, SCHEME_COMPILE_BUFFER_SIZE, "%s/procedure-", folder);
+    for (const char *c = scheme_symbol_get_value_ref(name); *c != '\0' && length < SCHEME_COMPILE_BUFFER_SIZE - 4; ++c)
+    {
+        if (isalnum((unsigned char)*c) || *c == '-')
+            buffer[length++] = *c;
+        else
+            length += sprintf(buffer + length, "_%02x", (unsigned char)*c);
+    }
+
+    buffer[length] = '\0';
+}
+
+/**
+ * Translate a procedure definition into C, and build it into a procedure
+ * module unless told otherwise.
+ *
+ * @param  definition     A Scheme expression.
+ * @param  outputFolder   Folder to write files to.
+ * @param  includeFolder  Folder of the interpreter's header files.
+ * @param  emitOnly       1 to keep the C source code without building it.
+ *
+ * @return 1 on success, 0 if an error occurred.
+ */
+static int _compile(scheme_element *definition, const char *outputFolder, const char *includeFolder, int emitOnly)
+{
+    scheme_symbol *name = scheme_translator_get_name(definition);
+    if (name == NULL)
+    {
+        printf("Not a procedure definition: ");
+        scheme_element_print(definition);
+        putchar('\n');
+        return 0;
+    }
+
+    char modulePath[SCHEME_COMPILE_BUFFER_SIZE];
+    char sourcePath[SCHEME_COMPILE_BUFFER_SIZE + 2];
+    _module_path(modulePath, outputFolder, name);
+    sprintf(sourcePath, "%s.c", modulePath);
+    strcat(modulePath, ".so");
+
+    // Translate into C.
+    FILE *source = fopen(sourcePath, "w");
+    if (source == NULL)
+    {
+        printf("Could not write '%s'.\n", sourcePath);
+        return 0;
+    }
+
+    scheme_element *failure;
+    int translated = scheme_translate(definition, source, &failure);
+    fclose(source);
+
+    if (!translated)
+    {
+        remove(sourcePath);
+
+        printf("Could not translate: ");
+        scheme_element_print(failure);
+        putchar('\n');
+        return 0;
+    }
+
+    if (emitOnly)
+    {
+        printf("%s\n", sourcePath);
+        return 1;
+    }
+
+    // Build with the system C compiler. The source code is kept if it does
+    // not build.
+    const char *compiler = getenv("CC");
+    if (compiler == NULL || compiler[0] == '\0')
+        compiler = "cc";
+
+    char command[SCHEME_COMPILE_BUFFER_SIZE * 4];
+    snprintf(command, sizeof(command), "%s " SCHEME_COMPILE_MODULE_FLAGS " -I\"%s\" -o \"%s\" \"%s\"",
+             compiler, includeFolder, modulePath, sourcePath);
+
+    if (system(command) != 0)
+    {
+        printf("Could not build '%s'.\n", sourcePath);
+        return 0;
+    }
+
+    remove(sourcePath);
+    printf("%s\n", modulePath);
+    return 1;
+}
+
+/**
+ * Compile the procedure definitions of a Scheme file into procedure
+ * modules, one per procedure, which the interpreter loads from its
+ * procedures folder like built-in procedures.
+ *
+ * @param  argc  Argument count.
+ * @param  argv  Arguments.
+ */
+int main(int argc, char *argv[])
+{
+    // Parse options.
+    const char *outputFolder = ".";
+    const char *includeFolder = SCHEME_INSTALL_PREFIX SCHEME_INCLUDE_FOLDER;
+    const char *path = NULL;
+    int emitOnly = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            outputFolder = argv[++i];
+        }
+        else if (strcmp(argv[i], "-I") == 0 && i + 1 < argc)
+        {
+            includeFolder = argv[++i];
+        }
+        else if (strcmp(argv[i], "--emit-c") == 0)
+        {
+            emitOnly = 1;
+        }
+        else if (path == NULL && argv[i][0] != '-')
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = NULL;
+            break;
+        }
+    }
+
+    if (path == NULL)
+    {
+        fprintf(stderr, "Usage: %s [-o FOLDER] [-I FOLDER] [--emit-c] FILE\n", argv[0]);
+        return 1;
+    }
+
+    scheme_file *f = scheme_open_path(path);
+    if (f == NULL)
+    {
+        fprintf(stderr, "Could not open '%s'.\n", path);
+        return 1;
+    }
+
+    // Compile every definition, even after one fails.
+    int status = 0;
+    while (1)
+    {
+        enum scheme_parser_error parserError;
+        scheme_element *definition = scheme_expression(f, &parserError);
+
+        if (definition == NULL)
+        {
+            if (parserError != SCHEME_PARSER_ERROR_EOF)
+            {
+                printf("Syntax error.\n");
+                status = 1;
+            }
+
+            break;
+        }
+
+        if (!_compile(definition, outputFolder, includeFolder, emitOnly))
+            status = 1;
+
+        scheme_element_free(definition);
+    }
+
+    scheme_close(f);
+    return status;
+}
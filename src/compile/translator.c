@@ -0,0 +1,1050 @@
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "translator.h"
+#include "utils.h"
+
+// Initial capacity of the code buffer and of the arrays of a translator.
+#define SCHEME_TRANSLATOR_INITIAL_SIZE 16
+
+// Largest length of the name of a C variable, or of an array item.
+#define SCHEME_TRANSLATOR_NAME_SIZE 32
+
+// Growable text.
+struct _buffer {
+    char *text;
+    size_t length;
+    size_t size;
+};
+
+// State of the translation of a procedure definition.
+struct _translator {
+    // Statements of the body of the procedure.
+    struct _buffer code;
+    // Statements creating the constants.
+    struct _buffer constantCode;
+    // Indentation of the next statement of the body, in levels.
+    int indent;
+    // 1 if out of memory.
+    int failed;
+    // First part of the definition that cannot be translated, if any.
+    scheme_element *unsupported;
+    // Number of arguments of the procedure, which are C variables
+    // v0, v1...
+    int argumentCount;
+    // Identifiers bound to C variables in scope, innermost last, and the
+    // number of each variable.
+    scheme_symbol **variables;
+    int *variableNumbers;
+    int variableCount;
+    int variableSize;
+    // Number of C variables and temporaries declared so far.
+    int nameCount;
+    // 1 once a call in tail position jumps back to the beginning of the
+    // body.
+    int loops;
+    // Global identifiers the body looks up.
+    scheme_symbol **symbols;
+    int symbolCount;
+    int symbolSize;
+    // Constants the body refers to.
+    scheme_element **constants;
+    int constantCount;
+    int constantSize;
+};
+
+/**** Private function declarations ****/
+
+/**
+ * Make room for one more item in a growable array.
+ *
+ * @param  array     Address of array.
+ * @param  size      Address of array's capacity.
+ * @param  count     Number of items in array.
+ * @param  itemSize  Size of an item.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _reserve(void **array, int *size, int count, size_t itemSize);
+
+/**
+ * Append an indented line to a buffer.
+ *
+ * @param  translator  Translator.
+ * @param  buffer      A buffer of the translator.
+ * @param  indent      Indentation, in levels.
+ * @param  format      printf() format of the line.
+ * @param  arguments   Arguments of the format.
+ */
+static void _append(struct _translator *translator, struct _buffer *buffer, int indent, const char *format, va_list arguments);
+
+/**
+ * Append a statement to the body of the procedure.
+ *
+ * @param  translator  Translator.
+ * @param  format      printf() format of the statement.
+ */
+static void _emit(struct _translator *translator, const char *format, ...);
+
+/**
+ * Append a statement to the creation of the constants.
+ *
+ * @param  translator  Translator.
+ * @param  format      printf() format of the statement.
+ */
+static void _emit_constant(struct _translator *translator, const char *format, ...);
+
+/**
+ * Append an opening brace, and indent the following statements.
+ *
+ * @param  translator  Translator.
+ */
+static void _open(struct _translator *translator);
+
+/**
+ * Stop indenting statements, and append a closing brace.
+ *
+ * @param  translator  Translator.
+ */
+static void _close(struct _translator *translator);
+
+/**
+ * Remember the first part of the definition that cannot be translated.
+ *
+ * @param  translator  Translator.
+ * @param  element     A Scheme element.
+ */
+static void _unsupported(struct _translator *translator, scheme_element *element);
+
+/**
+ * Find the C variable an identifier is bound to.
+ *
+ * @param  translator  Translator.
+ * @param  symbol      A Scheme symbol.
+ *
+ * @return Number of the innermost variable bound to the identifier, or -1
+ *         if it is a global identifier.
+ */
+static int _find_variable(struct _translator *translator, scheme_symbol *symbol);
+
+/**
+ * Bind an identifier to a new C variable.
+ *
+ * @param  translator  Translator.
+ * @param  symbol      A Scheme symbol.
+ *
+ * @return Number of the variable.
+ */
+static int _push_variable(struct _translator *translator, scheme_symbol *symbol);
+
+/**
+ * Get the index of a global identifier in the module's array of symbols,
+ * adding it if needed.
+ *
+ * @param  translator  Translator.
+ * @param  symbol      A Scheme symbol.
+ *
+ * @return Index.
+ */
+static int _add_symbol(struct _translator *translator, scheme_symbol *symbol);
+
+/**
+ * Add an element to the module's array of constants. The elements of a
+ * pair are added before it.
+ *
+ * @param  translator  Translator.
+ * @param  element     A Scheme element.
+ *
+ * @return Index.
+ */
+static int _add_constant(struct _translator *translator, scheme_element *element);
+
+/**
+ * Check if a list is a special form: if its first element is an identifier
+ * with the given name that is not bound to a C variable.
+ *
+ * @param  translator  Translator.
+ * @param  first       First element of a list.
+ * @param  name        Name of a special form.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static int _is_form(struct _translator *translator, scheme_element *first, const char *name);
+
+/**
+ * Translate an expression into statements storing its value in a C
+ * variable, or leaving the variable NULL if it cannot be evaluated.
+ *
+ * @param  translator  Translator.
+ * @param  element     A Scheme expression.
+ * @param  target      Name of a C variable holding NULL.
+ * @param  tail        1 if the value is returned by the procedure right
+ *                     away.
+ */
+static void _translate(struct _translator *translator, scheme_element *element, const char *target, int tail);
+
+/**
+ * Translate a list of expressions, keeping the value of the last one.
+ *
+ * @param  translator   Translator.
+ * @param  expressions  Array of expressions.
+ * @param  count        Number of expressions, at least 1.
+ * @param  target       Same as in _translate().
+ * @param  tail         Same as in _translate().
+ */
+static void _translate_sequence(struct _translator *translator,
+                                scheme_element **expressions,
+                                int count,
+                                const char *target,
+                                int tail);
+
+/**
+ * Translate "if".
+ *
+ * @param  translator  Translator.
+ * @param  arguments   Condition, then and else expressions.
+ * @param  target      Same as in _translate().
+ * @param  tail        Same as in _translate().
+ */
+static void _translate_if(struct _translator *translator, scheme_element **arguments, const char *target, int tail);
+
+/**
+ * Translate the clauses of "cond" from a given one on.
+ *
+ * @param  translator  Translator.
+ * @param  clauses     Array of well-formed clauses.
+ * @param  count       Number of clauses.
+ * @param  index       Index of the first clause to translate.
+ * @param  target      Same as in _translate().
+ * @param  tail        Same as in _translate().
+ */
+static void _translate_cond(struct _translator *translator,
+                            scheme_element **clauses,
+                            int count,
+                            int index,
+                            const char *target,
+                            int tail);
+
+/**
+ * Translate "let". Like the built-in procedure, the bindings are not
+ * evaluated.
+ *
+ * @param  translator  Translator.
+ * @param  arguments   Bindings, then expressions.
+ * @param  count       Number of arguments.
+ * @param  target      Same as in _translate().
+ * @param  tail        Same as in _translate().
+ */
+static void _translate_let(struct _translator *translator,
+                           scheme_element **arguments,
+                           int count,
+                           const char *target,
+                           int tail);
+
+/**
+ * Translate a procedure call.
+ *
+ * @param  translator  Translator.
+ * @param  elements    Procedure, then arguments.
+ * @param  count       Number of elements.
+ * @param  target      Same as in _translate().
+ * @param  tail        Same as in _translate().
+ */
+static void _translate_call(struct _translator *translator,
+                            scheme_element **elements,
+                            int count,
+                            const char *target,
+                            int tail);
+
+/**
+ * Create a C string literal.
+ * Returned pointer must be freed with free().
+ *
+ * @param  value  A string.
+ *
+ * @return The string, quoted and escaped, or NULL if out of memory.
+ */
+static char *_string_literal(const char *value);
+
+/**
+ * Write the source code of the module around the translated body.
+ *
+ * @param  translator  Translator.
+ * @param  name        Identifier the procedure is defined as, as a C string
+ *                     literal.
+ * @param  symbols     Global identifiers, as C string literals.
+ * @param  file        A file.
+ */
+static void _write_module(struct _translator *translator, const char *name, char **symbols, FILE *file);
+
+/**** Private function implementations ****/
+
+static int _reserve(void **array, int *size, int count, size_t itemSize)
+{
+    if (count < *size) return 1;
+
+    int newSize = *size > 0 ? *size * 2 : SCHEME_TRANSLATOR_INITIAL_SIZE;
+    void *newArray = realloc(*array, itemSize * newSize);
+    if (newArray == NULL) return 0;
+
+    *array = newArray;
+    *size = newSize;
+    return 1;
+}
+
+static void _append(struct _translator *translator, struct _buffer *buffer, int indent, const char *format, va_list arguments)
+{
+    if (translator->failed) return;
+
+    va_list copy;
+    va_copy(copy, arguments);
+    int length = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    // Indentation, line, newline and terminator.
+    size_t needed = buffer->length + indent * 4 + length + 2;
+    if (needed > buffer->size)
+    {
+        size_t newSize = buffer->size > 0 ? buffer->size : SCHEME_TRANSLATOR_INITIAL_SIZE;
+        while (newSize < needed)
+            newSize *= 2;
+
+        char *newText = realloc(buffer->text, newSize);
+        if (newText == NULL)
+        {
+            translator->failed = 1;
+            return;
+        }
+
+        buffer->text = newText;
+        buffer->size = newSize;
+    }
+
+    char *end = buffer->text + buffer->length;
+    memset(end, ' ', indent * 4);
+    end += indent * 4;
+
+    vsnprintf(end, length + 1, format, arguments);
+    end[length] = '\n';
+    end[length + 1] = '\0';
+    buffer->length = needed - 1;
+}
+
+static void _emit(struct _translator *translator, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    _append(translator, &translator->code, translator->indent, format, arguments);
+    va_end(arguments);
+}
+
+static void _emit_constant(struct _translator *translator, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    _append(translator, &translator->constantCode, 2, format, arguments);
+    va_end(arguments);
+}
+
+static void _open(struct _translator *translator)
+{
+    _emit(translator, "{");
+    ++translator->indent;
+}
+
+static void _close(struct _translator *translator)
+{
+    --translator->indent;
+    _emit(translator, "}");
+}
+
+static void _unsupported(struct _translator *translator, scheme_element *element)
+{
+    if (translator->unsupported == NULL)
+        translator->unsupported = element;
+}
+
+static int _find_variable(struct _translator *translator, scheme_symbol *symbol)
+{
+    for (int i = translator->variableCount - 1; i >= 0; --i)
+    {
+        if (translator->variables[i] == symbol)
+            return translator->variableNumbers[i];
+    }
+
+    return -1;
+}
+
+static int _push_variable(struct _translator *translator, scheme_symbol *symbol)
+{
+    int number = translator->nameCount++;
+
+    int size = translator->variableSize;
+    if (!_reserve((void **)&translator->variables, &size, translator->variableCount, sizeof(scheme_symbol *))
+        || !_reserve((void **)&translator->variableNumbers, &translator->variableSize, translator->variableCount, sizeof(int)))
+    {
+        translator->failed = 1;
+        return number;
+    }
+
+    translator->variables[translator->variableCount] = symbol;
+    translator->variableNumbers[translator->variableCount] = number;
+    ++translator->variableCount;
+
+    return number;
+}
+
+static int _add_symbol(struct _translator *translator, scheme_symbol *symbol)
+{
+    for (int i = 0; i < translator->symbolCount; ++i)
+    {
+        if (translator->symbols[i] == symbol)
+            return i;
+    }
+
+    if (!_reserve((void **)&translator->symbols, &translator->symbolSize, translator->symbolCount, sizeof(scheme_symbol *)))
+    {
+        translator->failed = 1;
+        return 0;
+    }
+
+    translator->symbols[translator->symbolCount] = symbol;
+    return translator->symbolCount++;
+}
+
+static int _add_constant(struct _translator *translator, scheme_element *element)
+{
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+    if (tag == SCHEME_ELEMENT_TAG_PAIR && !scheme_pair_is_empty((scheme_pair *)element))
+    {
+        int first = _add_constant(translator, scheme_pair_get_first((scheme_pair *)element));
+        int second = _add_constant(translator, scheme_pair_get_second((scheme_pair *)element));
+        _emit_constant(translator,
+                       "_constants[%d] = (scheme_element *)scheme_pair_new(_constants[%d], _constants[%d]);",
+                       translator->constantCount, first, second);
+    }
+    else if (tag == SCHEME_ELEMENT_TAG_PAIR)
+    {
+        _emit_constant(translator, "_constants[%d] = scheme_element_copy((scheme_element *)scheme_pair_get_empty());", translator->constantCount);
+    }
+    else if (tag == SCHEME_ELEMENT_TAG_NUMBER)
+    {
+        _emit_constant(translator, "_constants[%d] = (scheme_element *)scheme_number_new(%ldL);",
+                       translator->constantCount, scheme_number_get_value((scheme_number *)element));
+    }
+    else if (tag == SCHEME_ELEMENT_TAG_BOOLEAN)
+    {
+        _emit_constant(translator, "_constants[%d] = (scheme_element *)scheme_boolean_get_%s();",
+                       translator->constantCount, element == (scheme_element *)scheme_boolean_get_true() ? "true" : "false");
+    }
+    else if (tag == SCHEME_ELEMENT_TAG_SYMBOL)
+    {
+        char *value = _string_literal(scheme_symbol_get_value_ref((scheme_symbol *)element));
+        if (value == NULL)
+            translator->failed = 1;
+        else
+            _emit_constant(translator, "_constants[%d] = (scheme_element *)scheme_symbol_new(%s);", translator->constantCount, value);
+        free(value);
+    }
+    else
+    {
+        _unsupported(translator, element);
+    }
+
+    if (!_reserve((void **)&translator->constants, &translator->constantSize, translator->constantCount, sizeof(scheme_element *)))
+    {
+        translator->failed = 1;
+        return 0;
+    }
+
+    translator->constants[translator->constantCount] = element;
+    return translator->constantCount++;
+}
+
+static int _is_form(struct _translator *translator, scheme_element *first, const char *name)
+{
+    return scheme_element_is_symbol(first)
+           && scheme_symbol_value_equals((scheme_symbol *)first, name)
+           && _find_variable(translator, (scheme_symbol *)first) < 0;
+}
+
+static void _translate(struct _translator *translator, scheme_element *element, const char *target, int tail)
+{
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+
+    // Identifiers are bound to C variables, or looked up in the base
+    // namespace.
+    if (tag == SCHEME_ELEMENT_TAG_SYMBOL)
+    {
+        int number = _find_variable(translator, (scheme_symbol *)element);
+        if (number >= 0)
+        {
+            _emit(translator, "%s = scheme_element_copy(v%d);", target, number);
+        }
+        else
+        {
+            int index = _add_symbol(translator, (scheme_symbol *)element);
+            _emit(translator,
+                  "%s = scheme_element_copy(scheme_namespace_lookup_cached_ref(globals, _symbols[%d], &_caches[%d]));",
+                  target, index, index);
+        }
+
+        return;
+    }
+
+    // Other elements but pairs evaluate to themselves.
+    if (tag != SCHEME_ELEMENT_TAG_PAIR)
+    {
+        _emit(translator, "%s = scheme_element_copy(_constants[%d]);", target, _add_constant(translator, element));
+        return;
+    }
+
+    int count;
+    scheme_element **elements = scheme_list_to_array((scheme_pair *)element, &count);
+    if (count <= 0)
+    {
+        _unsupported(translator, element);
+        return;
+    }
+
+    if (elements == NULL)
+    {
+        translator->failed = 1;
+        return;
+    }
+
+    if (_is_form(translator, elements[0], "quote"))
+    {
+        // (quote <element>)
+        if (count == 2)
+            _emit(translator, "%s = scheme_element_copy(_constants[%d]);", target, _add_constant(translator, elements[1]));
+        else
+            _unsupported(translator, element);
+    }
+    else if (_is_form(translator, elements[0], "if"))
+    {
+        // (if <condition> <then> <else>)
+        if (count == 4)
+            _translate_if(translator, elements + 1, target, tail);
+        else
+            _unsupported(translator, element);
+    }
+    else if (_is_form(translator, elements[0], "cond"))
+    {
+        // (cond (<condition> <expression> ...) ... [(else <expression> ...)])
+        for (int i = 1; i < count; ++i)
+        {
+            int clauseCount;
+            scheme_element **clause = scheme_list_to_array((scheme_pair *)elements[i], &clauseCount);
+            int isElse = clauseCount > 0 && _is_form(translator, clause[0], "else");
+            free(clause);
+
+            if (clauseCount <= 0 || (isElse && (i < count - 1 || clauseCount == 1)))
+                _unsupported(translator, element);
+        }
+
+        if (count > 1)
+            _translate_cond(translator, elements + 1, count - 1, 0, target, tail);
+        else
+            _unsupported(translator, element);
+    }
+    else if (_is_form(translator, elements[0], "let"))
+    {
+        // (let (<binding> ...) <expression> ...)
+        if (count >= 3)
+            _translate_let(translator, elements + 1, count - 1, target, tail);
+        else
+            _unsupported(translator, element);
+    }
+    else if (_is_form(translator, elements[0], "lambda") || _is_form(translator, elements[0], "define"))
+    {
+        // Procedures and definitions need namespaces.
+        _unsupported(translator, element);
+    }
+    else
+    {
+        _translate_call(translator, elements, count, target, tail);
+    }
+
+    free(elements);
+}
+
+static void _translate_sequence(struct _translator *translator,
+                                scheme_element **expressions,
+                                int count,
+                                const char *target,
+                                int tail)
+{
+    if (count == 1)
+    {
+        _translate(translator, expressions[0], target, tail);
+        return;
+    }
+
+    char name[SCHEME_TRANSLATOR_NAME_SIZE];
+    sprintf(name, "t%d", translator->nameCount++);
+
+    _open(translator);
+    _emit(translator, "scheme_element *%s = NULL;", name);
+    _translate(translator, expressions[0], name, 0);
+    _emit(translator, "if (%s != NULL)", name);
+    _open(translator);
+    _emit(translator, "scheme_element_free(%s);", name);
+    _translate_sequence(translator, expressions + 1, count - 1, target, tail);
+    _close(translator);
+    _close(translator);
+}
+
+static void _translate_if(struct _translator *translator, scheme_element **arguments, const char *target, int tail)
+{
+    char name[SCHEME_TRANSLATOR_NAME_SIZE];
+    sprintf(name, "t%d", translator->nameCount++);
+
+    // Only #f is false.
+    _open(translator);
+    _emit(translator, "scheme_element *%s = NULL;", name);
+    _translate(translator, arguments[0], name, 0);
+    _emit(translator, "if (%s != NULL)", name);
+    _open(translator);
+    _emit(translator, "int isFalse = scheme_element_compare(%s, (scheme_element *)scheme_boolean_get_false());", name);
+    _emit(translator, "scheme_element_free(%s);", name);
+    _emit(translator, "if (!isFalse)");
+    _open(translator);
+    _translate(translator, arguments[1], target, tail);
+    _close(translator);
+    _emit(translator, "else");
+    _open(translator);
+    _translate(translator, arguments[2], target, tail);
+    _close(translator);
+    _close(translator);
+    _close(translator);
+}
+
+static void _translate_cond(struct _translator *translator,
+                            scheme_element **clauses,
+                            int count,
+                            int index,
+                            const char *target,
+                            int tail)
+{
+    // No clause was chosen.
+    if (index == count)
+    {
+        _emit(translator, "%s = scheme_element_copy(scheme_void_get());", target);
+        return;
+    }
+
+    int clauseCount;
+    scheme_element **clause = scheme_list_to_array((scheme_pair *)clauses[index], &clauseCount);
+    if (clause == NULL)
+    {
+        translator->failed = 1;
+        return;
+    }
+
+    if (_is_form(translator, clause[0], "else"))
+    {
+        _translate_sequence(translator, clause + 1, clauseCount - 1, target, tail);
+        free(clause);
+        return;
+    }
+
+    char name[SCHEME_TRANSLATOR_NAME_SIZE];
+    sprintf(name, "t%d", translator->nameCount++);
+
+    _open(translator);
+    _emit(translator, "scheme_element *%s = NULL;", name);
+    _translate(translator, clause[0], name, 0);
+
+    if (clauseCount == 1)
+    {
+        // A clause without expressions returns the value of its condition.
+        // Unlike "if", only #f itself is false.
+        _emit(translator, "if (%s != NULL && %s != (scheme_element *)scheme_boolean_get_false())", name, name);
+        _open(translator);
+        _emit(translator, "%s = %s;", target, name);
+        _close(translator);
+        _emit(translator, "else if (%s != NULL)", name);
+        _open(translator);
+        _emit(translator, "scheme_element_free(%s);", name);
+        _translate_cond(translator, clauses, count, index + 1, target, tail);
+        _close(translator);
+    }
+    else
+    {
+        _emit(translator, "if (%s != NULL)", name);
+        _open(translator);
+        _emit(translator, "int isFalse = %s == (scheme_element *)scheme_boolean_get_false();", name);
+        _emit(translator, "scheme_element_free(%s);", name);
+        _emit(translator, "if (!isFalse)");
+        _open(translator);
+        _translate_sequence(translator, clause + 1, clauseCount - 1, target, tail);
+        _close(translator);
+        _emit(translator, "else");
+        _open(translator);
+        _translate_cond(translator, clauses, count, index + 1, target, tail);
+        _close(translator);
+        _close(translator);
+    }
+
+    _close(translator);
+    free(clause);
+}
+
+static void _translate_let(struct _translator *translator,
+                           scheme_element **arguments,
+                           int count,
+                           const char *target,
+                           int tail)
+{
+    // Named "let" binds a procedure.
+    int bindingCount;
+    scheme_element **bindings = scheme_list_to_array((scheme_pair *)arguments[0], &bindingCount);
+    if (bindingCount < 0)
+    {
+        _unsupported(translator, arguments[0]);
+        return;
+    }
+
+    // Every binding must be: (<identifier> <element>)
+    for (int i = 0; i < bindingCount; ++i)
+    {
+        int itemCount;
+        scheme_element **items = scheme_list_to_array((scheme_pair *)bindings[i], &itemCount);
+        if (itemCount != 2 || !scheme_element_is_symbol(items[0]))
+            _unsupported(translator, bindings[i]);
+
+        free(items);
+    }
+
+    if (translator->unsupported != NULL)
+    {
+        free(bindings);
+        return;
+    }
+
+    _open(translator);
+
+    int variableCount = translator->variableCount;
+    for (int i = 0; i < bindingCount; ++i)
+    {
+        scheme_pair *binding = (scheme_pair *)bindings[i];
+        scheme_symbol *symbol = (scheme_symbol *)scheme_pair_get_first(binding);
+        scheme_element *value = scheme_pair_get_first((scheme_pair *)scheme_pair_get_second(binding));
+
+        int constant = _add_constant(translator, value);
+        _emit(translator, "scheme_element *v%d = scheme_element_copy(_constants[%d]);", _push_variable(translator, symbol), constant);
+    }
+
+    _translate_sequence(translator, arguments + 1, count - 1, target, tail);
+
+    for (int i = translator->variableCount - 1; i >= variableCount; --i)
+        _emit(translator, "scheme_element_free(v%d);", translator->variableNumbers[i]);
+
+    translator->variableCount = variableCount;
+    _close(translator);
+
+    free(bindings);
+}
+
+static void _translate_call(struct _translator *translator,
+                            scheme_element **elements,
+                            int count,
+                            const char *target,
+                            int tail)
+{
+    int number = translator->nameCount++;
+
+    // Procedure and arguments are evaluated from left to right, until one
+    // cannot be evaluated.
+    _open(translator);
+    _emit(translator, "scheme_element *t%d[%d] = {NULL};", number, count);
+    _emit(translator, "do");
+    _open(translator);
+
+    for (int i = 0; i < count; ++i)
+    {
+        char name[SCHEME_TRANSLATOR_NAME_SIZE];
+        sprintf(name, "t%d[%d]", number, i);
+
+        _translate(translator, elements[i], name, 0);
+        _emit(translator, "if (%s == NULL) break;", name);
+    }
+
+    // The procedure calls itself directly, without going through the
+    // evaluator, and in tail position by jumping back to the beginning.
+    int argumentCount = count - 1;
+    if (argumentCount == translator->argumentCount && tail)
+    {
+        _emit(translator, "if (t%d[0] == (scheme_element *)&_procedure)", number);
+        _open(translator);
+
+        for (int i = translator->variableCount - 1; i >= translator->argumentCount; --i)
+            _emit(translator, "scheme_element_free(v%d);", translator->variableNumbers[i]);
+
+        for (int i = 0; i < argumentCount; ++i)
+        {
+            _emit(translator, "scheme_element_free(v%d);", i);
+            _emit(translator, "v%d = t%d[%d];", i, number, i + 1);
+        }
+
+        _emit(translator, "goto start;");
+        _close(translator);
+        _emit(translator, "%s = _apply(globals, t%d[0], t%d + 1, %d);", target, number, number, argumentCount);
+
+        translator->loops = 1;
+    }
+    else if (argumentCount == translator->argumentCount)
+    {
+        _emit(translator,
+              "%s = t%d[0] == (scheme_element *)&_procedure ? _body(globals, t%d + 1) : _apply(globals, t%d[0], t%d + 1, %d);",
+              target, number, number, number, number, argumentCount);
+    }
+    else
+    {
+        _emit(translator, "%s = _apply(globals, t%d[0], t%d + 1, %d);", target, number, number, argumentCount);
+    }
+
+    --translator->indent;
+    _emit(translator, "} while (0);");
+    _emit(translator, "for (int i = 0; i < %d; ++i)", count);
+    _emit(translator, "    scheme_element_free(t%d[i]);", number);
+    _close(translator);
+}
+
+static char *_string_literal(const char *value)
+{
+    // Quotes, and at most 4 characters for each character.
+    char *literal = malloc(strlen(value) * 4 + 3);
+    if (literal == NULL) return NULL;
+
+    char *end = literal;
+    *end++ = '"';
+    for (const char *c = value; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            *end++ = '\\';
+            *end++ = *c;
+        }
+        else if (*c < ' ' || *c > '~')
+        {
+            end += sprintf(end, "\\%03o", (unsigned char)*c);
+        }
+        else
+        {
+            *end++ = *c;
+        }
+    }
+    *end++ = '"';
+    *end = '\0';
+
+    return literal;
+}
+
+static void _write_module(struct _translator *translator, const char *name, char **symbols, FILE *file)
+{
+    int argumentCount = translator->argumentCount;
+
+    fprintf(file, "/**\n");
+    fprintf(file, " * Scheme procedure translated into C by scheme-compile.\n");
+    fprintf(file, " */\n\n");
+
+    fprintf(file, "#include <stdlib.h>\n\n");
+    fprintf(file, "#include \"scheme-data-types.h\"\n");
+    fprintf(file, "#include \"scheme-procedure-init.h\"\n");
+    fprintf(file, "#include \"scheme-gc.h\"\n");
+    fprintf(file, "#include \"eval.h\"\n");
+    fprintf(file, "#include \"utils.h\"\n\n");
+
+    fprintf(file, "#define PROCEDURE_NAME %s\n\n", name);
+
+    fprintf(file, "// Number of arguments of the procedure.\n");
+    fprintf(file, "#define ARGUMENT_COUNT %d\n\n", argumentCount);
+
+    fprintf(file, "/**** Private variables ****/\n\n");
+    fprintf(file, "static scheme_procedure _procedure;\n");
+    fprintf(file, "static struct scheme_element_vtable _procedure_vtable;\n");
+    fprintf(file, "static int _proc_initd = 0;\n\n");
+    fprintf(file, "// Global identifiers looked up by the procedure, and their inline caches.\n");
+    fprintf(file, "static scheme_symbol *_symbols[%d];\n", translator->symbolCount + 1);
+    fprintf(file, "static scheme_namespace_cache _caches[%d];\n\n", translator->symbolCount + 1);
+    fprintf(file, "// Constants, which are garbage collection roots.\n");
+    fprintf(file, "static scheme_element *_constants[%d];\n\n", translator->constantCount + 1);
+
+    fprintf(file, "/**** Private function implementations ****/\n\n");
+
+    fprintf(file, "static void _procedure_free(scheme_element *element) {}\n\n");
+
+    fprintf(file, "static scheme_element *_apply(scheme_namespace *globals, scheme_element *procedure, scheme_element **arguments, int count)\n");
+    fprintf(file, "{\n");
+    fprintf(file, "    if (!scheme_element_is_procedure(procedure)) return NULL;\n\n");
+    fprintf(file, "    return scheme_procedure_apply_values((scheme_procedure *)procedure, arguments, count, globals);\n");
+    fprintf(file, "}\n\n");
+
+    fprintf(file, "static scheme_element *_body(scheme_namespace *globals, scheme_element **arguments)\n");
+    fprintf(file, "{\n");
+    fprintf(file, "    scheme_element *result = NULL;\n");
+    for (int i = 0; i < argumentCount; ++i)
+        fprintf(file, "    scheme_element *v%d = scheme_element_copy(arguments[%d]);\n", i, i);
+    if (translator->loops)
+        fprintf(file, "\nstart:\n");
+    else
+        fprintf(file, "\n");
+    fputs(translator->code.text, file);
+    fprintf(file, "\n");
+    for (int i = 0; i < argumentCount; ++i)
+        fprintf(file, "    scheme_element_free(v%d);\n", i);
+    fprintf(file, "    return result;\n");
+    fprintf(file, "}\n\n");
+
+    fprintf(file, "static scheme_element *_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)\n");
+    fprintf(file, "{\n");
+    fprintf(file, "    int count;\n");
+    fprintf(file, "    scheme_element **expressions = scheme_list_to_array((scheme_pair *)element, &count);\n");
+    fprintf(file, "    if (count != ARGUMENT_COUNT)\n");
+    fprintf(file, "    {\n");
+    fprintf(file, "        free(expressions);\n");
+    fprintf(file, "        return NULL;\n");
+    fprintf(file, "    }\n\n");
+    fprintf(file, "    scheme_element *arguments[ARGUMENT_COUNT + 1];\n");
+    fprintf(file, "    int evaluated = 0;\n");
+    fprintf(file, "    while (evaluated < count && (arguments[evaluated] = scheme_evaluate(expressions[evaluated], namespace)) != NULL)\n");
+    fprintf(file, "        ++evaluated;\n");
+    fprintf(file, "    free(expressions);\n\n");
+    fprintf(file, "    scheme_element *result = NULL;\n");
+    fprintf(file, "    if (evaluated == count)\n");
+    fprintf(file, "        result = _body(scheme_namespace_get_root(namespace), arguments);\n\n");
+    fprintf(file, "    for (int i = 0; i < evaluated; ++i)\n");
+    fprintf(file, "        scheme_element_free(arguments[i]);\n\n");
+    fprintf(file, "    return result;\n");
+    fprintf(file, "}\n\n");
+
+    fprintf(file, "/**** Public function implementations ****/\n\n");
+
+    fprintf(file, "scheme_procedure *scheme_procedure_get()\n");
+    fprintf(file, "{\n");
+    fprintf(file, "    if (!_proc_initd)\n");
+    fprintf(file, "    {\n");
+    fprintf(file, "        scheme_procedure_init(&_procedure, PROCEDURE_NAME, _function);\n\n");
+    fprintf(file, "        scheme_element_vtable_clone(&_procedure_vtable, _procedure.super.vtable);\n");
+    fprintf(file, "        _procedure_vtable.free = _procedure_free;\n");
+    fprintf(file, "        _procedure.super.vtable = &_procedure_vtable;\n\n");
+
+    for (int i = 0; i < translator->symbolCount; ++i)
+        fprintf(file, "        _symbols[%d] = scheme_symbol_new(%s);\n", i, symbols[i]);
+
+    if (translator->constantCode.text != NULL)
+        fputs(translator->constantCode.text, file);
+
+    fprintf(file, "        for (int i = 0; i < %d; ++i)\n", translator->constantCount);
+    fprintf(file, "            scheme_gc_add_root(&_constants[i]);\n\n");
+    fprintf(file, "        _proc_initd = 1;\n");
+    fprintf(file, "    }\n\n");
+    fprintf(file, "    return &_procedure;\n");
+    fprintf(file, "}\n");
+}
+
+/**** Public function implementations ****/
+
+scheme_symbol *scheme_translator_get_name(scheme_element *definition)
+{
+    int count;
+    scheme_element **elements = scheme_list_to_array((scheme_pair *)definition, &count);
+
+    scheme_symbol *name = NULL;
+    if (count >= 3
+        && scheme_element_is_symbol(elements[0])
+        && scheme_symbol_value_equals((scheme_symbol *)elements[0], "define")
+        && scheme_element_is_pair(elements[1])
+        && !scheme_pair_is_empty((scheme_pair *)elements[1]))
+    {
+        scheme_element *first = scheme_pair_get_first((scheme_pair *)elements[1]);
+        if (scheme_element_is_symbol(first))
+            name = (scheme_symbol *)first;
+    }
+
+    free(elements);
+    return name;
+}
+
+int scheme_translate(scheme_element *definition, FILE *file, scheme_element **failure)
+{
+    if (failure != NULL) *failure = definition;
+
+    scheme_symbol *name = scheme_translator_get_name(definition);
+    if (name == NULL) return 0;
+
+    scheme_element *rest = scheme_pair_get_second((scheme_pair *)definition);
+    scheme_element *signature = scheme_pair_get_first((scheme_pair *)rest);
+    scheme_element *body = scheme_pair_get_second((scheme_pair *)rest);
+
+    struct _translator translator;
+    memset(&translator, 0, sizeof(struct _translator));
+
+    // Arguments are distinct identifiers, bound to v0, v1...
+    int argumentCount;
+    scheme_element **arguments = scheme_list_to_array((scheme_pair *)scheme_pair_get_second((scheme_pair *)signature), &argumentCount);
+    if (argumentCount < 0)
+    {
+        if (failure != NULL) *failure = signature;
+        return 0;
+    }
+
+    for (int i = 0; i < argumentCount; ++i)
+    {
+        if (!scheme_element_is_symbol(arguments[i])
+            || _find_variable(&translator, (scheme_symbol *)arguments[i]) >= 0)
+            _unsupported(&translator, signature);
+
+        _push_variable(&translator, (scheme_symbol *)arguments[i]);
+    }
+
+    translator.argumentCount = argumentCount;
+    free(arguments);
+
+    int count;
+    scheme_element **expressions = scheme_list_to_array((scheme_pair *)body, &count);
+    if (count <= 0)
+        _unsupported(&translator, definition);
+    else if (translator.unsupported == NULL)
+    {
+        translator.indent = 1;
+        _translate_sequence(&translator, expressions, count, "result", 1);
+    }
+    free(expressions);
+
+    // Identifiers are written as C string literals.
+    char *literal = _string_literal(scheme_symbol_get_value_ref(name));
+    char **symbols = calloc(translator.symbolCount + 1, sizeof(char *));
+    if (literal == NULL || symbols == NULL)
+        translator.failed = 1;
+
+    for (int i = 0; i < translator.symbolCount && !translator.failed; ++i)
+    {
+        symbols[i] = _string_literal(scheme_symbol_get_value_ref(translator.symbols[i]));
+        if (symbols[i] == NULL)
+            translator.failed = 1;
+    }
+
+    int success = !translator.failed && translator.unsupported == NULL;
+    if (success)
+        _write_module(&translator, literal, symbols, file);
+    else if (failure != NULL && translator.unsupported != NULL)
+        *failure = translator.unsupported;
+
+    for (int i = 0; symbols != NULL && i < translator.symbolCount; ++i)
+        free(symbols[i]);
+    free(symbols);
+    free(literal);
+
+    free(translator.code.text);
+    free(translator.constantCode.text);
+    free(translator.variables);
+    free(translator.variableNumbers);
+    free(translator.symbols);
+    free(translator.constants);
+
+    return success;
+}
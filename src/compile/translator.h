@@ -0,0 +1,54 @@
+/**
+ * Scheme to C translator.
+ *
+ * Translates a procedure definition into the C source code of a procedure
+ * module, which the loader can load like a built-in procedure. The module
+ * evaluates its arguments, binds them to C variables and runs the
+ * translated body natively:
+ *
+ *   - Arguments and the bindings of "let" are C variables.
+ *   - "quote", "if", "cond" and "let" are translated into C statements.
+ *   - Calls look their procedure up in the base namespace through an
+ *     inline cache, and pass it an array of evaluated arguments.
+ *   - Calls to the procedure itself run its body directly, and those in
+ *     tail position jump back to its beginning.
+ *
+ * Special forms are recognized by name. "lambda", "define" and named
+ * "let" cannot be translated, since they would need namespaces.
+ */
+
+#ifndef __SCHEME_TRANSLATOR_H__
+#define __SCHEME_TRANSLATOR_H__
+
+#include <stdio.h>
+
+#include "scheme-data-types.h"
+
+/**
+ * Get the identifier a procedure definition defines.
+ *
+ * @param  definition  A Scheme expression.
+ *
+ * @return Identifier, or NULL if the expression is not in the format:
+ *         (define (<identifier> <argument> ...) <expression> ...)
+ */
+scheme_symbol *scheme_translator_get_name(scheme_element *definition);
+
+/**
+ * Translate a procedure definition into the C source code of a procedure
+ * module.
+ *
+ * Arguments must be distinct identifiers, without default values or rest
+ * argument.
+ *
+ * @param  definition  (define (<identifier> <argument> ...) <expression> ...)
+ * @param  file        File to write the source code to.
+ * @param  failure     If not NULL and the definition cannot be translated,
+ *                     set to the part of it that cannot be translated.
+ *
+ * @return 1 on success, 0 if the definition cannot be translated or out of
+ *         memory, in which case nothing is written.
+ */
+int scheme_translate(scheme_element *definition, FILE *file, scheme_element **failure);
+
+#endif
@@ -1,11 +1,19 @@
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "config-info.h"
 
 #include "scheme-data-types.h"
+#include "scheme-gc.h"
 #include "parser.h"
+#include "resolver.h"
+#include "optimizer.h"
 #include "eval.h"
+#include "analyzer.h"
+#include "vm.h"
 #include "loader.h"
 #include "main.h"
 
@@ -14,6 +22,35 @@
 int g_SchemeProgramTerminationFlag = 0;
 int g_SchemeProgramTerminationCode = 0;
 
+/**
+ * Parse the value of an option that must be a positive decimal number.
+ *
+ * @param  text  Value of the option.
+ * @param  max   Largest value accepted.
+ *
+ * @return The number, or 0 if the value is not a number between 1 and max.
+ */
+static long _parse_positive(const char *text, long max)
+{
+    char *end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value <= 0 || value > max)
+        return 0;
+
+    return value;
+}
+
+/**
+ * Print how to run the program.
+ *
+ * @param  program  Name the program was run with.
+ */
+static void _print_usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-O] [--gc-stats] [--nursery-size=KB] [--arena] [--procedures=FOLDER] [--engine=tree|node|vm] [--max-stack=FRAMES] [--stack-stats] [--cache-stats] [--opt-report]\n", program);
+}
+
 /**
  * Start an interactive Scheme prompt.
  *
@@ -22,12 +59,96 @@ int g_SchemeProgramTerminationCode = 0;
  */
 int main(int argc, char *argv[])
 {
+    // Parse options.
+    int printGCStats = 0;
+    int printStackStats = 0;
+    int printCacheStats = 0;
+    int printOptReport = 0;
+    int optimize = 0;
+    int arena = 0;
+    const char *proceduresPath = SCHEME_INSTALL_PREFIX SCHEME_PROCEDURES_FOLDER;
+    enum { ENGINE_TREE, ENGINE_NODE, ENGINE_VM } engine = ENGINE_TREE;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-O") == 0)
+        {
+            optimize = 1;
+        }
+        else if (strcmp(argv[i], "--gc-stats") == 0)
+        {
+            printGCStats = 1;
+        }
+        else if (strcmp(argv[i], "--arena") == 0)
+        {
+            arena = 1;
+            scheme_gc_set_arena(1);
+        }
+        else if (strcmp(argv[i], "--stack-stats") == 0)
+        {
+            printStackStats = 1;
+        }
+        else if (strcmp(argv[i], "--cache-stats") == 0)
+        {
+            printCacheStats = 1;
+        }
+        else if (strcmp(argv[i], "--opt-report") == 0)
+        {
+            printOptReport = 1;
+        }
+        else if (strncmp(argv[i], "--max-stack=", 12) == 0)
+        {
+            // Limit is given in frames.
+            long count = _parse_positive(argv[i] + 12, INT_MAX);
+            if (count == 0)
+            {
+                _print_usage(argv[0]);
+                return 1;
+            }
+
+            scheme_vm_set_max_frame_count((int)count);
+        }
+        else if (strncmp(argv[i], "--procedures=", 13) == 0)
+        {
+            // Load built-in procedures from another folder, such as the
+            // build tree.
+            proceduresPath = argv[i] + 13;
+        }
+        else if (strncmp(argv[i], "--nursery-size=", 15) == 0)
+        {
+            // Size is given in kilobytes.
+            long size = _parse_positive(argv[i] + 15, LONG_MAX / 1024);
+            if (size == 0)
+            {
+                _print_usage(argv[0]);
+                return 1;
+            }
+
+            scheme_gc_set_nursery_size((size_t)size * 1024);
+        }
+        else if (strcmp(argv[i], "--engine=vm") == 0)
+        {
+            engine = ENGINE_VM;
+        }
+        else if (strcmp(argv[i], "--engine=node") == 0)
+        {
+            engine = ENGINE_NODE;
+        }
+        else if (strcmp(argv[i], "--engine=tree") == 0)
+        {
+            engine = ENGINE_TREE;
+        }
+        else
+        {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
     // Parse expressions from stdin until terminated.
     scheme_file *f = scheme_open_file(stdin);
 
     // Set up procedure loader.
     scheme_loader *loader = scheme_loader_new();
-    const char *proceduresPath = SCHEME_INSTALL_PREFIX SCHEME_PROCEDURES_FOLDER;
     int procedureCount = scheme_loader_load_folder(loader, proceduresPath);
 
     if (procedureCount == 0)
@@ -35,9 +156,13 @@ int main(int argc, char *argv[])
         fprintf(stderr, "WARNING: No built-in procedure found in path '%s'.\n", proceduresPath);
     }
 
-    // Set up base namespace.
+    // Set up base namespace. Everything reachable from it survives garbage
+    // collection.
     scheme_namespace *baseNamespace = scheme_namespace_new(NULL);
     scheme_loader_put_onto_namespace(loader, baseNamespace);
+    scheme_gc_add_root((scheme_element **)&baseNamespace);
+
+    scheme_evaluator_init(baseNamespace);
 
     printf("Experimental Scheme parser.\n");
     printf("To exit, type \"(exit)\" or the EOF character.\n\n");
@@ -65,8 +190,29 @@ int main(int argc, char *argv[])
             continue;
         }
 
+        // Resolve variable references. Keep expression as is if out of
+        // memory.
+        scheme_element *resolved = scheme_resolve(expression);
+        if (resolved != NULL)
+        {
+            if (!arena)
+                scheme_element_free(expression);
+            expression = resolved;
+        }
+
+        // Fold constant subexpressions. Errors are still reported with the
+        // expression as entered. Keep expression as is if out of memory.
+        scheme_element *optimized = optimize ? scheme_optimize(expression, baseNamespace) : NULL;
+        scheme_element *code = optimized != NULL ? optimized : expression;
+
         // Evaluate expression.
-        scheme_element *result = scheme_evaluate(expression, baseNamespace);
+        scheme_element *result;
+        if (engine == ENGINE_VM)
+            result = scheme_vm_evaluate(code, baseNamespace);
+        else if (engine == ENGINE_NODE)
+            result = scheme_analyzer_evaluate(code, baseNamespace);
+        else
+            result = scheme_evaluate(code, baseNamespace);
         if (result == NULL)
         {
             printf("Could not evaluate: ");
@@ -78,14 +224,28 @@ int main(int argc, char *argv[])
             // Print evaluated result.
             scheme_element_print(result);
 
-            if (!scheme_element_is_type(result, scheme_void_get_type()))
+            if (!scheme_element_is_void(result))
             {
                 putchar('\n');
             }
         }
 
-        scheme_element_free(expression);
-        scheme_element_free(result);
+        // Nothing but the base namespace is in use between expressions, so
+        // this is a safe point to move young elements and reclaim leaked
+        // elements. In arena mode, everything created for the expression is
+        // reclaimed at once here instead of being released one by one.
+        if (arena)
+        {
+            scheme_gc_end_form();
+        }
+        else
+        {
+            scheme_element_free(optimized);
+            scheme_element_free(expression);
+            scheme_element_free(result);
+
+            scheme_gc_collect_if_needed();
+        }
 
         // Check termination flag.
         if (g_SchemeProgramTerminationFlag)
@@ -95,7 +255,22 @@ int main(int argc, char *argv[])
     }
 
     // Terminate.
+    scheme_gc_remove_root((scheme_element **)&baseNamespace);
     scheme_element_free((scheme_element *)baseNamespace);
+    scheme_gc_collect();
+
+    if (printGCStats)
+        scheme_gc_print_stats();
+
+    if (printStackStats)
+        scheme_vm_print_stats();
+
+    if (printCacheStats)
+        scheme_namespace_print_cache_stats();
+
+    if (printOptReport)
+        scheme_optimizer_print_report();
+
     scheme_loader_free(loader);
     scheme_close(f);
     return g_SchemeProgramTerminationCode;
@@ -0,0 +1,1114 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "analyzer.h"
+#include "eval.h"
+#include "utils.h"
+#include "scheme-element-private.h"
+
+// Number of arguments a call evaluates without allocating an array.
+#define SCHEME_NODE_ARGUMENT_COUNT 8
+
+/**
+ * Typedef for function pointer that evaluates a node.
+ *
+ * @param Node that stores function pointer.
+ * @param Active namespace.
+ */
+typedef scheme_element *(*_node_function_t)(scheme_node *, scheme_namespace *);
+
+// Analyzed Scheme expression.
+struct scheme_node {
+    struct scheme_element super;
+    // Function evaluating this node.
+    _node_function_t function;
+    // Constant, identifier, variable reference, template procedure or
+    // original expression, depending on function. May be NULL.
+    scheme_element *value;
+    // Nodes of subexpressions.
+    scheme_node **children;
+    int childCount;
+    // Procedure of a call, if looked up by identifier.
+    scheme_namespace_cache cache;
+};
+
+/**** Private function declarations ****/
+
+/**
+ * Free a node.
+ *
+ * @param  element  Should be a node.
+ */
+static void _vtable_free(scheme_element *element);
+
+/**
+ * Print a node to stdout.
+ *
+ * @param  element  Should be a node.
+ */
+static void _vtable_print(scheme_element *element);
+
+/**
+ * Compare a node to another element. A node is only equal to itself.
+ *
+ * @param  element  Should be a node.
+ * @param  other    Other element.
+ *
+ * @return 1 if equal, 0 otherwise.
+ */
+static int _vtable_compare(scheme_element *element, scheme_element *other);
+
+/**
+ * Pass elements and nodes held by a node to a visitor.
+ *
+ * @param  element  Should be a node.
+ * @param  visit    A visitor.
+ */
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit);
+
+/**
+ * Create a node whose children have yet to be analyzed.
+ *
+ * @param  function    Function evaluating the node.
+ * @param  value       Element held by the node, may be NULL.
+ * @param  childCount  Number of children.
+ *
+ * @return Node, or NULL if out of memory.
+ */
+static scheme_node *_node_new(_node_function_t function, scheme_element *value, int childCount);
+
+/**
+ * Analyze expressions into a node's children.
+ *
+ * @param  node         A node.
+ * @param  offset       Index of the first child to analyze.
+ * @param  expressions  Array of expressions.
+ * @param  count        Number of expressions.
+ * @param  namespace    Namespace the expressions will be evaluated in.
+ * @param  tail         1 if the result of the last expression is returned
+ *                      by the procedure being analyzed.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _analyze_children(scheme_node *node,
+                             int offset,
+                             scheme_element **expressions,
+                             int count,
+                             scheme_namespace *namespace,
+                             int tail);
+
+/**
+ * Analyze an expression.
+ *
+ * @param  element    A resolved Scheme expression.
+ * @param  namespace  Namespace the expression will be evaluated in.
+ * @param  tail       1 if the expression's result is returned by the
+ *                    procedure being analyzed.
+ *
+ * @return Node, or NULL if out of memory.
+ */
+static scheme_node *_analyze(scheme_element *element, scheme_namespace *namespace, int tail);
+
+/**
+ * Analyze a procedure call.
+ *
+ * @param  pair       A non-empty pair whose second element is a list.
+ * @param  namespace  Namespace the expression will be evaluated in.
+ * @param  tail       1 if the call's result is returned by the procedure
+ *                    being analyzed.
+ *
+ * @return Node, or NULL if out of memory.
+ */
+static scheme_node *_analyze_call(scheme_pair *pair, scheme_namespace *namespace, int tail);
+
+/**
+ * Analyze a special form, if it is well-formed.
+ *
+ * @param  node       Location of the resulting node.
+ * @param  form       Which special form the pair is.
+ * @param  list       List of elements following the identifier.
+ * @param  arguments  Array of elements following the identifier.
+ * @param  count      Number of elements following the identifier.
+ * @param  namespace  Namespace the expression will be evaluated in.
+ * @param  tail       1 if the expression's result is returned by the
+ *                    procedure being analyzed.
+ *
+ * @return 1 on success, 0 if out of memory, -1 if the special form must be
+ *         left to its built-in procedure.
+ */
+static int _analyze_special_form(scheme_node **node,
+                                 int form,
+                                 scheme_element *list,
+                                 scheme_element **arguments,
+                                 int count,
+                                 scheme_namespace *namespace,
+                                 int tail);
+
+/**
+ * Analyze the blocks of a "cond" expression, if they are well-formed.
+ *
+ * @param  node       Location of the resulting node.
+ * @param  blocks     Array of condition-expression blocks.
+ * @param  count      Number of blocks.
+ * @param  namespace  Namespace the expression will be evaluated in.
+ * @param  tail       1 if the expression's result is returned by the
+ *                    procedure being analyzed.
+ *
+ * @return 1 on success, 0 if out of memory, -1 if the expression must be
+ *         left to the built-in procedure.
+ */
+static int _analyze_cond(scheme_node **node, scheme_element **blocks, int count, scheme_namespace *namespace, int tail);
+
+/**
+ * Analyze "and" or "or".
+ *
+ * @param  node       Location of the resulting node.
+ * @param  form       SCHEME_FORM_AND or SCHEME_FORM_OR.
+ * @param  arguments  Array of arguments.
+ * @param  count      Number of arguments.
+ * @param  namespace  Namespace the expression will be evaluated in.
+ * @param  tail       1 if the result is returned by the procedure being
+ *                    analyzed.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _analyze_logic(scheme_node **node,
+                          int form,
+                          scheme_element **arguments,
+                          int count,
+                          scheme_namespace *namespace,
+                          int tail);
+
+/**
+ * Analyze an expression creating a lambda procedure.
+ *
+ * @param  node         Location of the resulting node.
+ * @param  name         Procedure's name, may be NULL.
+ * @param  arguments    Argument identifiers.
+ * @param  expressions  List of expressions.
+ * @param  namespace    Namespace the procedure will be created in.
+ *
+ * @return 1 on success, 0 if out of memory, -1 if the procedure is
+ *         malformed.
+ */
+static int _analyze_closure(scheme_node **node,
+                            const char *name,
+                            scheme_element *arguments,
+                            scheme_element *expressions,
+                            scheme_namespace *namespace);
+
+/**
+ * Get a lambda procedure's node, analyzing it if needed.
+ *
+ * @param  lambda     A lambda procedure.
+ * @param  namespace  Active namespace.
+ *
+ * @return Node held by the procedure, or NULL if out of memory.
+ */
+static scheme_node *_procedure_node(scheme_lambda *lambda, scheme_namespace *namespace);
+
+/**
+ * Evaluate a constant: return it as is.
+ */
+static scheme_element *_constant_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate an identifier by looking it up in the active namespace.
+ */
+static scheme_element *_global_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate the identifier of a called procedure by looking it up in the
+ * active namespace, through the node's inline cache.
+ */
+static scheme_element *_callee_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate a variable reference by looking it up by slot.
+ */
+static scheme_element *_local_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate an expression that could not be analyzed with the evaluator.
+ */
+static scheme_element *_evaluate_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate "if": evaluate the condition, then one of the two branches.
+ */
+static scheme_element *_if_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate "cond": evaluate the condition of each block until one of them
+ * does not evaluate to #f, then the expressions of that block.
+ */
+static scheme_element *_cond_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate "and": evaluate every argument, and return #f if one of them is
+ * #f or the last one otherwise.
+ */
+static scheme_element *_and_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate "or": evaluate every argument, and return the first one that is
+ * not #f or the last one otherwise.
+ */
+static scheme_element *_or_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate "define": bind the result of the expression to the identifier.
+ */
+static scheme_element *_define_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate "lambda": create a procedure in the active namespace.
+ */
+static scheme_element *_closure_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate a procedure body: evaluate every expression in order and return
+ * the result of the last one.
+ */
+static scheme_element *_sequence_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate a procedure call.
+ */
+static scheme_element *_call_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate a procedure call whose arguments are all constants or
+ * variables. Procedures other than lambda procedures are given the
+ * original argument list, saving the construction of a list of values.
+ */
+static scheme_element *_simple_call_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate a procedure call in tail position. A lambda procedure is not
+ * applied, but deferred to the caller of the procedure being executed.
+ */
+static scheme_element *_tail_call_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate a procedure call in tail position whose arguments are all
+ * constants or variables.
+ */
+static scheme_element *_simple_tail_call_node(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Evaluate a procedure call.
+ *
+ * @param  node       A call node.
+ * @param  namespace  Active namespace.
+ * @param  simple     1 if the arguments are all constants or variables.
+ * @param  tail       1 if the call is in tail position.
+ *
+ * @return Result, tail call marker, or NULL if an error occurs.
+ */
+static scheme_element *_call(scheme_node *node, scheme_namespace *namespace, int simple, int tail);
+
+/**
+ * Apply a procedure to the arguments of a call node.
+ *
+ * @param  node       A call node.
+ * @param  procedure  Procedure being called.
+ * @param  namespace  Active namespace.
+ * @param  tail       1 to defer applying a lambda procedure to the caller.
+ *
+ * @return Result, tail call marker, or NULL if an error occurs.
+ */
+static scheme_element *_apply(scheme_node *node, scheme_element *procedure, scheme_namespace *namespace, int tail);
+
+/**
+ * Execute the body of a lambda procedure, then the bodies of the lambda
+ * procedures it defers, until one of them returns a result.
+ *
+ * @param  body            Body of the procedure being applied.
+ * @param  localNamespace  Procedure's local namespace, whose reference is
+ *                         taken over.
+ *
+ * @return Result, or NULL if an error occurs.
+ */
+static scheme_element *_execute(scheme_node *body, scheme_namespace *localNamespace);
+
+/**** Private variables ****/
+
+// Global virtual function table.
+static struct scheme_element_vtable _scheme_node_vtable = {
+    .get_type = scheme_node_get_type,
+    .free = _vtable_free,
+    .print = _vtable_print,
+    .compare = _vtable_compare,
+    .traverse = _vtable_traverse
+};
+
+// Global node type.
+static struct scheme_element_type _scheme_node_type = {
+    .super = NULL,
+    .name = "scheme_node"
+};
+static int _scheme_node_type_initd = 0;
+
+// Interned symbol "else", compared by pointer.
+static scheme_element *_elseSymbol = NULL;
+
+// Marker returned by a call in tail position that deferred a lambda
+// procedure. Never leaves the analyzer.
+static struct scheme_element _tailCall;
+
+// Lambda procedure deferred by a call in tail position.
+static struct {
+    scheme_lambda *procedure;
+    scheme_node *body;
+    scheme_namespace *namespace;
+} _deferred = {NULL, NULL, NULL};
+
+/**** Private function implementations ****/
+
+static void _vtable_free(scheme_element *element)
+{
+    scheme_node *node = (scheme_node *)element;
+
+    for (int i = 0; i < node->childCount; ++i)
+    {
+        scheme_element_free((scheme_element *)node->children[i]);
+    }
+
+    free(node->children);
+    scheme_element_free(node->value);
+}
+
+static void _vtable_print(scheme_element *element)
+{
+    printf("#<node>");
+}
+
+static int _vtable_compare(scheme_element *element, scheme_element *other)
+{
+    return element == other;
+}
+
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit)
+{
+    scheme_node *node = (scheme_node *)element;
+
+    if (node->value != NULL)
+        visit(&node->value);
+
+    for (int i = 0; i < node->childCount; ++i)
+    {
+        if (node->children[i] != NULL)
+            visit((scheme_element **)&node->children[i]);
+    }
+}
+
+static scheme_node *_node_new(_node_function_t function, scheme_element *value, int childCount)
+{
+    // Allocate node.
+    scheme_node *node;
+    if ((node = (scheme_node *)scheme_element_new(sizeof(scheme_node), &_scheme_node_vtable, SCHEME_ELEMENT_TAG_OTHER)) == NULL)
+        return NULL;
+
+    node->function = function;
+    node->value = scheme_element_copy(value);
+    node->children = NULL;
+    node->childCount = 0;
+    node->cache.element = NULL;
+    node->cache.version = 0;
+
+    if (childCount > 0)
+    {
+        if ((node->children = calloc(childCount, sizeof(scheme_node *))) == NULL)
+        {
+            scheme_element_free((scheme_element *)node);
+            return NULL;
+        }
+
+        node->childCount = childCount;
+    }
+
+    return node;
+}
+
+static int _analyze_children(scheme_node *node,
+                             int offset,
+                             scheme_element **expressions,
+                             int count,
+                             scheme_namespace *namespace,
+                             int tail)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if ((node->children[offset + i] = _analyze(expressions[i], namespace, tail && i == count - 1)) == NULL)
+            return 0;
+    }
+
+    return 1;
+}
+
+static scheme_node *_analyze(scheme_element *element, scheme_namespace *namespace, int tail)
+{
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+
+    if (tag == SCHEME_ELEMENT_TAG_SYMBOL)
+        return _node_new(_global_node, element, 0);
+
+    if (tag == SCHEME_ELEMENT_TAG_REFERENCE)
+        return _node_new(_local_node, element, 0);
+
+    // Anything other than a pair evaluates to itself.
+    if (tag != SCHEME_ELEMENT_TAG_PAIR)
+        return _node_new(_constant_node, element, 0);
+
+    // Leave the empty pair and improper argument lists to the evaluator to
+    // reject.
+    scheme_pair *pair = (scheme_pair *)element;
+    if (scheme_pair_is_empty(pair) || !scheme_pair_is_list(pair))
+        return _node_new(_evaluate_node, element, 0);
+
+    // Heads that a procedure's body binds or may define were replaced with
+    // references by the resolver, and are analyzed into calls.
+    int form = scheme_evaluator_get_special_form(pair);
+    if (form >= 0)
+    {
+        scheme_element *list = scheme_pair_get_second(pair);
+        int count;
+        scheme_element **arguments = scheme_list_to_array((scheme_pair *)list, &count);
+        if (count < 0) return NULL;
+
+        scheme_node *node = NULL;
+        int result = _analyze_special_form(&node, form, list, arguments, count, namespace, tail);
+        free(arguments);
+
+        if (result > 0) return node;
+        if (result == 0)
+        {
+            scheme_element_free((scheme_element *)node);
+            return NULL;
+        }
+    }
+
+    return _analyze_call(pair, namespace, tail);
+}
+
+static scheme_node *_analyze_call(scheme_pair *pair, scheme_namespace *namespace, int tail)
+{
+    // Procedures that evaluate their own arguments are given the original
+    // argument list.
+    scheme_element *list = scheme_pair_get_second(pair);
+    int count;
+    scheme_element **arguments = scheme_list_to_array((scheme_pair *)list, &count);
+    if (count < 0) return NULL;
+
+    // First child is the procedure, followed by the arguments.
+    scheme_node *node = _node_new(_call_node, list, count + 1);
+    if (node == NULL
+        || (node->children[0] = _analyze(scheme_pair_get_first(pair), namespace, 0)) == NULL
+        || !_analyze_children(node, 1, arguments, count, namespace, 0))
+    {
+        scheme_element_free((scheme_element *)node);
+        free(arguments);
+        return NULL;
+    }
+
+    free(arguments);
+
+    // The same procedure is usually called every time.
+    if (node->children[0]->function == _global_node)
+        node->children[0]->function = _callee_node;
+
+    // Constants and variables evaluate the same way and without side
+    // effects whether the procedure evaluates them itself or not.
+    int simple = 1;
+    for (int i = 1; i < node->childCount; ++i)
+    {
+        _node_function_t function = node->children[i]->function;
+        if (function != _constant_node && function != _global_node && function != _local_node)
+        {
+            simple = 0;
+            break;
+        }
+    }
+
+    if (tail)
+        node->function = simple ? _simple_tail_call_node : _tail_call_node;
+    else
+        node->function = simple ? _simple_call_node : _call_node;
+
+    return node;
+}
+
+static int _analyze_special_form(scheme_node **node,
+                                 int form,
+                                 scheme_element *list,
+                                 scheme_element **arguments,
+                                 int count,
+                                 scheme_namespace *namespace,
+                                 int tail)
+{
+    switch (form)
+    {
+        case SCHEME_FORM_QUOTE:
+        {
+            // (quote <element>)
+            if (count != 1) return -1;
+
+            return (*node = _node_new(_constant_node, arguments[0], 0)) != NULL;
+        }
+
+        case SCHEME_FORM_IF:
+        {
+            // (if <condition> <then> <else>)
+            if (count != 3) return -1;
+
+            // Both branches are in tail position if the expression is.
+            if ((*node = _node_new(_if_node, NULL, 3)) == NULL) return 0;
+            return _analyze_children(*node, 0, arguments, 2, namespace, tail)
+                   && _analyze_children(*node, 2, arguments + 2, 1, namespace, tail);
+        }
+
+        case SCHEME_FORM_COND:
+        {
+            // (cond (<condition> [<expression>] ...) ...)
+            return _analyze_cond(node, arguments, count, namespace, tail);
+        }
+
+        case SCHEME_FORM_AND:
+        case SCHEME_FORM_OR:
+        {
+            // (and <expression> ...), (or <expression> ...)
+            return _analyze_logic(node, form, arguments, count, namespace, tail);
+        }
+
+        case SCHEME_FORM_DEFINE:
+        {
+            if (count < 2) return -1;
+
+            scheme_element *target = arguments[0];
+            if (scheme_element_is_symbol(target))
+            {
+                // (define <identifier> <expression>)
+                if (count != 2) return -1;
+
+                if ((*node = _node_new(_define_node, target, 1)) == NULL) return 0;
+                return _analyze_children(*node, 0, arguments + 1, 1, namespace, 0);
+            }
+
+            // (define (<identifier> <arguments> ...) <expression> ...)
+            if (!scheme_element_is_pair(target) || scheme_pair_is_empty((scheme_pair *)target))
+                return -1;
+
+            scheme_element *name = scheme_pair_get_first((scheme_pair *)target);
+            if (!scheme_element_is_symbol(name))
+                return -1;
+
+            // Expressions are every element after the target.
+            scheme_node *closure = NULL;
+            int result = _analyze_closure(&closure,
+                                          scheme_symbol_get_value_ref((scheme_symbol *)name),
+                                          scheme_pair_get_second((scheme_pair *)target),
+                                          scheme_pair_get_second((scheme_pair *)list),
+                                          namespace);
+            if (result <= 0) return result;
+
+            if ((*node = _node_new(_define_node, name, 1)) == NULL)
+            {
+                scheme_element_free((scheme_element *)closure);
+                return 0;
+            }
+
+            (*node)->children[0] = closure;
+            return 1;
+        }
+
+        case SCHEME_FORM_LAMBDA:
+        {
+            // (lambda <arguments> <expression> ...)
+            if (count < 2) return -1;
+
+            return _analyze_closure(node, NULL, arguments[0], scheme_pair_get_second((scheme_pair *)list), namespace);
+        }
+
+        default:
+            // Other special forms are left to their procedures.
+            return -1;
+    }
+}
+
+static int _analyze_cond(scheme_node **node, scheme_element **blocks, int count, scheme_namespace *namespace, int tail)
+{
+    if (_elseSymbol == NULL && (_elseSymbol = (scheme_element *)scheme_symbol_new("else")) == NULL)
+        return 0;
+
+    if (count == 0) return -1;
+
+    // Every block must be a non-empty list, and only the last two blocks
+    // may have "else" for condition, as the built-in procedure requires.
+    for (int i = 0; i < count; ++i)
+    {
+        scheme_pair *block = (scheme_pair *)blocks[i];
+        if (!scheme_element_is_pair(blocks[i])
+            || scheme_pair_is_empty(block)
+            || !scheme_pair_is_list(block))
+            return -1;
+
+        if (i < count - 2 && scheme_pair_get_first(block) == _elseSymbol)
+            return -1;
+    }
+
+    // Each block is analyzed into two children: its condition, and the
+    // expressions following it.
+    if ((*node = _node_new(_cond_node, NULL, count * 2)) == NULL) return 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        int expressionCount;
+        scheme_element **expressions = scheme_list_to_array((scheme_pair *)blocks[i], &expressionCount);
+        if (expressionCount < 0) return 0;
+
+        scheme_node *body = _node_new(_sequence_node, NULL, expressionCount - 1);
+        (*node)->children[i * 2 + 1] = body;
+
+        int result = _analyze_children(*node, i * 2, expressions, 1, namespace, 0)
+                     && body != NULL
+                     && _analyze_children(body, 0, expressions + 1, expressionCount - 1, namespace, tail);
+        free(expressions);
+
+        if (!result) return 0;
+    }
+
+    return 1;
+}
+
+static int _analyze_logic(scheme_node **node,
+                          int form,
+                          scheme_element **arguments,
+                          int count,
+                          scheme_namespace *namespace,
+                          int tail)
+{
+    int isAnd = form == SCHEME_FORM_AND;
+
+    // (and) is #t, (or) is #f.
+    if (count == 0)
+    {
+        scheme_element *result = isAnd ? (scheme_element *)scheme_boolean_get_true() : (scheme_element *)scheme_boolean_get_false();
+        return (*node = _node_new(_constant_node, result, 0)) != NULL;
+    }
+
+    // The result of "and" is #f if its last argument is equal to #f, so that
+    // argument is never in tail position.
+    if (isAnd)
+    {
+        if ((*node = _node_new(_and_node, NULL, count)) == NULL) return 0;
+        return _analyze_children(*node, 0, arguments, count, namespace, 0);
+    }
+
+    // Every argument is evaluated, so the last one is analyzed twice: once
+    // as is, for when the result is already known, and once more as the
+    // result, which is in tail position if the expression is.
+    if ((*node = _node_new(_or_node, NULL, count + 1)) == NULL) return 0;
+    return _analyze_children(*node, 0, arguments, count, namespace, 0)
+           && _analyze_children(*node, count, arguments + count - 1, 1, namespace, tail);
+}
+
+static int _analyze_closure(scheme_node **node,
+                            const char *name,
+                            scheme_element *arguments,
+                            scheme_element *expressions,
+                            scheme_namespace *namespace)
+{
+    // The procedure created at analysis time serves as a template for the
+    // ones created each time the node is evaluated.
+    scheme_lambda *template = scheme_lambda_new_from_elements(name, arguments, expressions, NULL);
+    if (template == NULL) return -1;
+
+    scheme_node *body = scheme_analyze_procedure(template, namespace);
+    if (body == NULL)
+    {
+        scheme_element_free((scheme_element *)template);
+        return 0;
+    }
+
+    scheme_lambda_set_code(template, (scheme_element *)body);
+    scheme_element_free((scheme_element *)body);
+
+    *node = _node_new(_closure_node, (scheme_element *)template, 0);
+    scheme_element_free((scheme_element *)template);
+
+    return *node != NULL;
+}
+
+static scheme_node *_procedure_node(scheme_lambda *lambda, scheme_namespace *namespace)
+{
+    scheme_element *code = scheme_lambda_get_code(lambda);
+    if (code != NULL && scheme_element_get_type(code) == scheme_node_get_type())
+        return (scheme_node *)code;
+
+    // Lambda procedures created outside of analyzed expressions are
+    // analyzed the first time they are applied.
+    scheme_node *node = scheme_analyze_procedure(lambda, namespace);
+    if (node == NULL) return NULL;
+
+    scheme_lambda_set_code(lambda, (scheme_element *)node);
+    scheme_element_free((scheme_element *)node);
+
+    return node;
+}
+
+static scheme_element *_constant_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return scheme_element_copy(node->value);
+}
+
+static scheme_element *_global_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return scheme_element_copy(scheme_namespace_lookup_ref(namespace, (scheme_symbol *)node->value));
+}
+
+static scheme_element *_callee_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return scheme_element_copy(scheme_namespace_lookup_cached_ref(namespace, (scheme_symbol *)node->value, &node->cache));
+}
+
+static scheme_element *_local_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return scheme_element_copy(scheme_reference_lookup_ref((scheme_reference *)node->value, namespace));
+}
+
+static scheme_element *_evaluate_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return scheme_evaluate(node->value, namespace);
+}
+
+static scheme_element *_if_node(scheme_node *node, scheme_namespace *namespace)
+{
+    scheme_node **children = node->children;
+
+    scheme_element *condition = children[0]->function(children[0], namespace);
+    if (condition == NULL) return NULL;
+
+    int conditionIsFalse = scheme_element_compare(condition, (scheme_element *)scheme_boolean_get_false());
+    scheme_element_free(condition);
+
+    scheme_node *branch = conditionIsFalse ? children[2] : children[1];
+    return branch->function(branch, namespace);
+}
+
+static scheme_element *_cond_node(scheme_node *node, scheme_namespace *namespace)
+{
+    for (int i = 0; i < node->childCount; i += 2)
+    {
+        scheme_node *condition = node->children[i];
+        scheme_node *body = node->children[i + 1];
+        int conditionIsElse = condition->function == _global_node && condition->value == _elseSymbol;
+
+        scheme_element *result = condition->function(condition, namespace);
+        if (result == NULL && !conditionIsElse) return NULL;
+
+        if (body->childCount == 0)
+        {
+            // Condition cannot be "else" symbol by itself.
+            if (conditionIsElse)
+            {
+                scheme_element_free(result);
+                return NULL;
+            }
+
+            // Continue if condition was #f.
+            if (result == (scheme_element *)scheme_boolean_get_false()) continue;
+
+            return result;
+        }
+
+        int isFalse = result == (scheme_element *)scheme_boolean_get_false();
+        scheme_element_free(result);
+        if (isFalse) continue;
+
+        // Evaluate each expression and return the result of the last one.
+        for (int e = 0; e < body->childCount - 1; ++e)
+        {
+            result = body->children[e]->function(body->children[e], namespace);
+            if (result == NULL) return NULL;
+
+            scheme_element_free(result);
+        }
+
+        scheme_node *last = body->children[body->childCount - 1];
+        return last->function(last, namespace);
+    }
+
+    return scheme_void_get();
+}
+
+static scheme_element *_and_node(scheme_node *node, scheme_namespace *namespace)
+{
+    int count = node->childCount;
+
+    int foundFalse = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        scheme_element *argument = node->children[i]->function(node->children[i], namespace);
+        if (argument == NULL) return NULL;
+
+        if (scheme_element_compare(argument, (scheme_element *)scheme_boolean_get_false()))
+            foundFalse = 1;
+
+        if (i == count - 1 && !foundFalse)
+            return argument;
+
+        scheme_element_free(argument);
+    }
+
+    return (scheme_element *)scheme_boolean_get_false();
+}
+
+static scheme_element *_or_node(scheme_node *node, scheme_namespace *namespace)
+{
+    int count = node->childCount - 1;
+
+    scheme_element *result = NULL;
+    for (int i = 0; i < count - 1; ++i)
+    {
+        scheme_element *argument = node->children[i]->function(node->children[i], namespace);
+        if (argument == NULL)
+        {
+            scheme_element_free(result);
+            return NULL;
+        }
+
+        if (result == NULL && !scheme_element_compare(argument, (scheme_element *)scheme_boolean_get_false()))
+            result = argument;
+        else
+            scheme_element_free(argument);
+    }
+
+    if (result == NULL)
+    {
+        scheme_node *last = node->children[count];
+        return last->function(last, namespace);
+    }
+
+    // Every argument is still evaluated.
+    scheme_element *last = node->children[count - 1]->function(node->children[count - 1], namespace);
+    if (last == NULL)
+    {
+        scheme_element_free(result);
+        return NULL;
+    }
+
+    scheme_element_free(last);
+    return result;
+}
+
+static scheme_element *_define_node(scheme_node *node, scheme_namespace *namespace)
+{
+    scheme_node *expression = node->children[0];
+
+    scheme_element *element = expression->function(expression, namespace);
+    if (element == NULL) return NULL;
+
+    scheme_namespace_set_symbol(namespace, (scheme_symbol *)node->value, element);
+    return element;
+}
+
+static scheme_element *_closure_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return (scheme_element *)scheme_lambda_new_closure((scheme_lambda *)node->value, namespace);
+}
+
+static scheme_element *_sequence_node(scheme_node *node, scheme_namespace *namespace)
+{
+    scheme_element *result = NULL;
+    for (int i = 0; i < node->childCount; ++i)
+    {
+        scheme_element_free(result);
+        result = node->children[i]->function(node->children[i], namespace);
+    }
+
+    return result;
+}
+
+static scheme_element *_call_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return _call(node, namespace, 0, 0);
+}
+
+static scheme_element *_simple_call_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return _call(node, namespace, 1, 0);
+}
+
+static scheme_element *_tail_call_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return _call(node, namespace, 0, 1);
+}
+
+static scheme_element *_simple_tail_call_node(scheme_node *node, scheme_namespace *namespace)
+{
+    return _call(node, namespace, 1, 1);
+}
+
+static scheme_element *_call(scheme_node *node, scheme_namespace *namespace, int simple, int tail)
+{
+    // Acquire a reference to the procedure, since evaluating the arguments
+    // or the procedure's body could redefine its identifier.
+    scheme_node *head = node->children[0];
+    scheme_element *procedure = head->function(head, namespace);
+
+    scheme_element *result;
+    if (scheme_element_is_lambda(procedure))
+        result = _apply(node, procedure, namespace, tail);
+    else if (!scheme_element_is_procedure(procedure))
+        result = NULL;
+    else if ((simple && !scheme_procedure_is_strict((scheme_procedure *)procedure)) || scheme_evaluator_is_syntax(procedure))
+        // Procedures that evaluate their own arguments are given them as
+        // is. Strict procedures are always given an array of values.
+        result = scheme_procedure_apply((scheme_procedure *)procedure, node->value, namespace);
+    else
+        result = _apply(node, procedure, namespace, 0);
+
+    scheme_element_free(procedure);
+    return result;
+}
+
+static scheme_element *_apply(scheme_node *node, scheme_element *procedure, scheme_namespace *namespace, int tail)
+{
+    // Evaluate arguments from left to right, into an array on the stack
+    // unless there are many of them.
+    int count = node->childCount - 1;
+    scheme_element *buffer[SCHEME_NODE_ARGUMENT_COUNT];
+    scheme_element **arguments = buffer;
+    if (count > SCHEME_NODE_ARGUMENT_COUNT && (arguments = malloc(sizeof(scheme_element *) * count)) == NULL)
+        return NULL;
+
+    int evaluatedCount = 0;
+    while (evaluatedCount < count)
+    {
+        scheme_node *argument = node->children[evaluatedCount + 1];
+        if ((arguments[evaluatedCount] = argument->function(argument, namespace)) == NULL)
+            break;
+
+        ++evaluatedCount;
+    }
+
+    scheme_element *result = NULL;
+    if (evaluatedCount == count)
+    {
+        if (scheme_element_is_lambda(procedure))
+        {
+            scheme_lambda *lambda = (scheme_lambda *)procedure;
+
+            scheme_node *body = _procedure_node(lambda, namespace);
+            scheme_namespace *localNamespace = body != NULL ? scheme_lambda_bind(lambda, arguments, count, namespace) : NULL;
+            if (localNamespace != NULL && tail)
+            {
+                // The procedure keeps its body alive until it is executed.
+                _deferred.procedure = (scheme_lambda *)scheme_element_copy(procedure);
+                _deferred.body = body;
+                _deferred.namespace = localNamespace;
+                result = &_tailCall;
+            }
+            else if (localNamespace != NULL)
+            {
+                result = _execute(body, localNamespace);
+            }
+        }
+        else
+        {
+            result = scheme_procedure_apply_values((scheme_procedure *)procedure, arguments, count, namespace);
+        }
+    }
+
+    for (int i = 0; i < evaluatedCount; ++i)
+    {
+        scheme_element_free(arguments[i]);
+    }
+
+    if (arguments != buffer)
+        free(arguments);
+
+    return result;
+}
+
+static scheme_element *_execute(scheme_node *body, scheme_namespace *localNamespace)
+{
+    scheme_lambda *procedure = NULL;
+    scheme_element *result = body->function(body, localNamespace);
+
+    // The namespace of a procedure that deferred a call is released before
+    // the deferred procedure is executed.
+    while (result == &_tailCall)
+    {
+        scheme_element_free((scheme_element *)localNamespace);
+        scheme_element_free((scheme_element *)procedure);
+
+        procedure = _deferred.procedure;
+        body = _deferred.body;
+        localNamespace = _deferred.namespace;
+        _deferred.procedure = NULL;
+        _deferred.body = NULL;
+        _deferred.namespace = NULL;
+
+        result = body->function(body, localNamespace);
+    }
+
+    scheme_element_free((scheme_element *)localNamespace);
+    scheme_element_free((scheme_element *)procedure);
+
+    return result;
+}
+
+/**** Public function implementations ****/
+
+scheme_node *scheme_analyze(scheme_element *expression, scheme_namespace *namespace)
+{
+    return _analyze(expression, namespace, 0);
+}
+
+scheme_node *scheme_analyze_procedure(scheme_lambda *lambda, scheme_namespace *namespace)
+{
+    int count;
+    scheme_element **expressions = scheme_lambda_get_expressions(lambda, &count);
+
+    scheme_node *node = _node_new(_sequence_node, NULL, count);
+    if (node == NULL) return NULL;
+
+    // The last expression's result is returned by the procedure.
+    if (!_analyze_children(node, 0, expressions, count, namespace, 1))
+    {
+        scheme_element_free((scheme_element *)node);
+        return NULL;
+    }
+
+    return node;
+}
+
+scheme_element *scheme_node_evaluate(scheme_node *node, scheme_namespace *namespace)
+{
+    return node->function(node, namespace);
+}
+
+scheme_element *scheme_analyzer_evaluate(scheme_element *expression, scheme_namespace *namespace)
+{
+    scheme_node *node = scheme_analyze(expression, namespace);
+    if (node == NULL) return NULL;
+
+    scheme_element *result = scheme_node_evaluate(node, namespace);
+    scheme_element_free((scheme_element *)node);
+
+    return result;
+}
+
+scheme_element_type *scheme_node_get_type()
+{
+    if (!_scheme_node_type_initd)
+    {
+        _scheme_node_type.super = scheme_element_get_base_type();
+
+        _scheme_node_type_initd = 1;
+    }
+
+    return &_scheme_node_type;
+}
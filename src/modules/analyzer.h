@@ -0,0 +1,75 @@
+/**
+ * Scheme expression analyzer.
+ *
+ * Converts resolved Scheme expressions into trees of nodes, once, before
+ * they are evaluated. Each node holds a pointer to the C function that
+ * evaluates it, along with the nodes of its subexpressions, so evaluating
+ * a tree never inspects the shape of the original expression again. The
+ * special forms "quote", "if", "cond", "define", "lambda", "and" and "or"
+ * are analyzed into nodes of their own, as long as their identifier refers
+ * to the built-in procedure of the same name when an expression is
+ * analyzed. Everything else is analyzed into procedure calls.
+ */
+
+#ifndef __SCHEME_ANALYZER_H__
+#define __SCHEME_ANALYZER_H__
+
+#include "scheme-data-types.h"
+
+// Analyzed Scheme expression.
+typedef struct scheme_node scheme_node;
+
+/**
+ * Analyze a Scheme expression.
+ *
+ * Returned pointer must be freed with scheme_element_free().
+ *
+ * @param  expression  A resolved Scheme expression.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ *
+ * @return Node, or NULL if out of memory.
+ */
+scheme_node *scheme_analyze(scheme_element *expression, scheme_namespace *namespace);
+
+/**
+ * Analyze the expressions of a lambda procedure.
+ *
+ * Returned pointer must be freed with scheme_element_free().
+ *
+ * @param  lambda     A lambda procedure.
+ * @param  namespace  Namespace the procedure was created in.
+ *
+ * @return Node, or NULL if out of memory.
+ */
+scheme_node *scheme_analyze_procedure(scheme_lambda *lambda, scheme_namespace *namespace);
+
+/**
+ * Evaluate an analyzed expression.
+ * Returned element must be freed with scheme_element_free().
+ *
+ * @param  node       A node.
+ * @param  namespace  Active namespace.
+ *
+ * @return Result, or NULL if expression could not be evaluated.
+ */
+scheme_element *scheme_node_evaluate(scheme_node *node, scheme_namespace *namespace);
+
+/**
+ * Analyze and evaluate a top-level Scheme expression.
+ * Returned element must be freed with scheme_element_free().
+ *
+ * @param  expression  A resolved Scheme expression.
+ * @param  namespace   Active namespace.
+ *
+ * @return Result, or NULL if expression could not be evaluated.
+ */
+scheme_element *scheme_analyzer_evaluate(scheme_element *expression, scheme_namespace *namespace);
+
+/**
+ * Get node's type.
+ *
+ * @return Node's type.
+ */
+scheme_element_type *scheme_node_get_type();
+
+#endif
@@ -0,0 +1,626 @@
+#include <stdlib.h>
+
+#include "compiler.h"
+#include "eval.h"
+#include "utils.h"
+
+/**** Private function declarations ****/
+
+/**
+ * Append an instruction with a constant as its operand.
+ *
+ * @param  bytecode  Bytecode being compiled.
+ * @param  opcode    An opcode.
+ * @param  element   A Scheme element.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _emit_constant(scheme_bytecode *bytecode, int opcode, scheme_element *element);
+
+/**
+ * Compile an expression.
+ *
+ * @param  bytecode    Bytecode being compiled.
+ * @param  element     A resolved Scheme expression.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ * @param  tail        1 if the expression's result is returned right away.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _compile(scheme_bytecode *bytecode, scheme_element *element, scheme_namespace *namespace, int tail);
+
+/**
+ * Compile a procedure call.
+ *
+ * @param  bytecode    Bytecode being compiled.
+ * @param  pair        A non-empty pair whose second element is a list.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ * @param  tail        1 if the call's result is returned right away.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _compile_call(scheme_bytecode *bytecode, scheme_pair *pair, scheme_namespace *namespace, int tail);
+
+/**
+ * Compile a special form, if it is well-formed.
+ *
+ * @param  bytecode    Bytecode being compiled.
+ * @param  form        Which special form the pair is.
+ * @param  list        List of elements following the identifier.
+ * @param  arguments   Array of elements following the identifier.
+ * @param  count       Number of elements following the identifier.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ * @param  tail        1 if the expression's result is returned right away.
+ *
+ * @return 1 on success, 0 if out of memory, -1 if the special form must be
+ *         left to its built-in procedure.
+ */
+static int _compile_special_form(scheme_bytecode *bytecode,
+                                 int form,
+                                 scheme_element *list,
+                                 scheme_element **arguments,
+                                 int count,
+                                 scheme_namespace *namespace,
+                                 int tail);
+
+/**
+ * Compile a list of expressions, keeping the result of the last one.
+ *
+ * @param  bytecode     Bytecode being compiled.
+ * @param  expressions  Array of expressions.
+ * @param  count        Number of expressions, at least 1.
+ * @param  namespace    Namespace the expressions will be evaluated in.
+ * @param  tail         1 if the last expression's result is returned right
+ *                      away.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _compile_sequence(scheme_bytecode *bytecode,
+                             scheme_element **expressions,
+                             int count,
+                             scheme_namespace *namespace,
+                             int tail);
+
+/**
+ * Compile "cond", if it is well-formed.
+ *
+ * @param  bytecode    Bytecode being compiled.
+ * @param  blocks      Array of condition-expression blocks.
+ * @param  count       Number of blocks.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ * @param  tail        1 if the expression's result is returned right away.
+ *
+ * @return 1 on success, 0 if out of memory, -1 if the expression must be
+ *         left to the built-in procedure.
+ */
+static int _compile_cond(scheme_bytecode *bytecode,
+                         scheme_element **blocks,
+                         int count,
+                         scheme_namespace *namespace,
+                         int tail);
+
+/**
+ * Compile "and" or "or". Every argument is evaluated, as the built-in
+ * procedures do: once the result is known, the remaining arguments are
+ * evaluated and discarded.
+ *
+ * @param  bytecode    Bytecode being compiled.
+ * @param  form        SCHEME_FORM_AND or SCHEME_FORM_OR.
+ * @param  arguments   Array of arguments.
+ * @param  count       Number of arguments.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ * @param  tail        1 if the expression's result is returned right away.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _compile_logic(scheme_bytecode *bytecode,
+                          int form,
+                          scheme_element **arguments,
+                          int count,
+                          scheme_namespace *namespace,
+                          int tail);
+
+/**
+ * Append an instruction creating a lambda procedure.
+ *
+ * @param  bytecode     Bytecode being compiled.
+ * @param  name         Procedure's name, may be NULL.
+ * @param  binding      Symbol the procedure is bound to in a namespace of
+ *                      its own, as with a named "let", or NULL.
+ * @param  arguments    Argument identifiers.
+ * @param  expressions  List of expressions.
+ * @param  namespace    Namespace the procedure will be created in.
+ *
+ * @return 1 on success, 0 if out of memory, -1 if the procedure is
+ *         malformed.
+ */
+static int _compile_closure(scheme_bytecode *bytecode,
+                            const char *name,
+                            scheme_symbol *binding,
+                            scheme_element *arguments,
+                            scheme_element *expressions,
+                            scheme_namespace *namespace);
+
+/**** Private variables ****/
+
+static scheme_symbol *_elseSymbol = NULL;
+
+/**** Private function implementations ****/
+
+static int _emit_constant(scheme_bytecode *bytecode, int opcode, scheme_element *element)
+{
+    int index = scheme_bytecode_add_constant(bytecode, element);
+    if (index < 0) return 0;
+
+    if (scheme_bytecode_emit(bytecode, opcode) < 0) return 0;
+    if (scheme_bytecode_emit(bytecode, index) < 0) return 0;
+
+    return 1;
+}
+
+static int _compile(scheme_bytecode *bytecode, scheme_element *element, scheme_namespace *namespace, int tail)
+{
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+
+    if (tag == SCHEME_ELEMENT_TAG_SYMBOL)
+        return _emit_constant(bytecode, SCHEME_OP_GLOBAL, element);
+
+    if (tag == SCHEME_ELEMENT_TAG_REFERENCE)
+        return _emit_constant(bytecode, SCHEME_OP_LOCAL, element);
+
+    // Anything other than a pair evaluates to itself.
+    if (tag != SCHEME_ELEMENT_TAG_PAIR)
+        return _emit_constant(bytecode, SCHEME_OP_CONSTANT, element);
+
+    // Leave the empty pair and improper argument lists to the evaluator to
+    // reject.
+    scheme_pair *pair = (scheme_pair *)element;
+    if (scheme_pair_is_empty(pair) || !scheme_pair_is_list(pair))
+        return _emit_constant(bytecode, SCHEME_OP_EVALUATE, element);
+
+    // The resolver replaced identifiers a procedure's body binds or may
+    // define, such as an internal definition of "if", with references, so
+    // those are compiled into calls.
+    int form = scheme_evaluator_get_special_form(pair);
+    if (form >= 0)
+    {
+        scheme_element *list = scheme_pair_get_second(pair);
+        int count;
+        scheme_element **arguments = scheme_list_to_array((scheme_pair *)list, &count);
+        if (count < 0) return 0;
+
+        int result = _compile_special_form(bytecode, form, list, arguments, count, namespace, tail);
+        free(arguments);
+
+        if (result >= 0) return result;
+    }
+
+    return _compile_call(bytecode, pair, namespace, tail);
+}
+
+static int _compile_call(scheme_bytecode *bytecode, scheme_pair *pair, scheme_namespace *namespace, int tail)
+{
+    scheme_element *arguments = scheme_pair_get_second(pair);
+
+    // Procedure. The same procedure is usually called every time.
+    scheme_element *procedure = scheme_pair_get_first(pair);
+    if (scheme_element_get_tag(procedure) == SCHEME_ELEMENT_TAG_SYMBOL)
+    {
+        int cache = scheme_bytecode_add_cache(bytecode);
+        if (cache < 0) return 0;
+
+        if (!_emit_constant(bytecode, SCHEME_OP_CALLEE, procedure)) return 0;
+        if (scheme_bytecode_emit(bytecode, cache) < 0) return 0;
+    }
+    else if (!_compile(bytecode, procedure, namespace, 0))
+    {
+        return 0;
+    }
+
+    // Procedures that evaluate their own arguments are given them as is.
+    if (!_emit_constant(bytecode, SCHEME_OP_SYNTAX, arguments)) return 0;
+    int target = scheme_bytecode_emit(bytecode, 0);
+    if (target < 0) return 0;
+
+    // Arguments, from left to right.
+    int count = 0;
+    while (!scheme_pair_is_empty((scheme_pair *)arguments))
+    {
+        if (!_compile(bytecode, scheme_pair_get_first((scheme_pair *)arguments), namespace, 0)) return 0;
+
+        arguments = scheme_pair_get_second((scheme_pair *)arguments);
+        ++count;
+    }
+
+    if (scheme_bytecode_emit(bytecode, tail ? SCHEME_OP_TAIL_CALL : SCHEME_OP_CALL) < 0) return 0;
+    if (scheme_bytecode_emit(bytecode, count) < 0) return 0;
+
+    scheme_bytecode_patch(bytecode, target, scheme_bytecode_get_length(bytecode));
+    return 1;
+}
+
+static int _compile_special_form(scheme_bytecode *bytecode,
+                                 int form,
+                                 scheme_element *list,
+                                 scheme_element **arguments,
+                                 int count,
+                                 scheme_namespace *namespace,
+                                 int tail)
+{
+    switch (form)
+    {
+        case SCHEME_FORM_QUOTE:
+        {
+            // (quote <element>)
+            if (count != 1) return -1;
+
+            return _emit_constant(bytecode, SCHEME_OP_CONSTANT, arguments[0]);
+        }
+
+        case SCHEME_FORM_IF:
+        {
+            // (if <condition> <then> <else>)
+            if (count != 3) return -1;
+
+            if (!_compile(bytecode, arguments[0], namespace, 0)) return 0;
+            if (scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP_IF_FALSE) < 0) return 0;
+            int elseTarget = scheme_bytecode_emit(bytecode, 0);
+            if (elseTarget < 0) return 0;
+
+            if (!_compile(bytecode, arguments[1], namespace, tail)) return 0;
+            if (scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP) < 0) return 0;
+            int endTarget = scheme_bytecode_emit(bytecode, 0);
+            if (endTarget < 0) return 0;
+
+            scheme_bytecode_patch(bytecode, elseTarget, scheme_bytecode_get_length(bytecode));
+            if (!_compile(bytecode, arguments[2], namespace, tail)) return 0;
+
+            scheme_bytecode_patch(bytecode, endTarget, scheme_bytecode_get_length(bytecode));
+            return 1;
+        }
+
+        case SCHEME_FORM_DEFINE:
+        {
+            if (count < 2) return -1;
+
+            scheme_element *target = arguments[0];
+            if (scheme_element_is_symbol(target))
+            {
+                // (define <identifier> <expression>)
+                if (count != 2) return -1;
+
+                if (!_compile(bytecode, arguments[1], namespace, 0)) return 0;
+                return _emit_constant(bytecode, SCHEME_OP_DEFINE, target);
+            }
+
+            // (define (<identifier> <arguments> ...) <expression> ...)
+            if (!scheme_element_is_pair(target) || scheme_pair_is_empty((scheme_pair *)target))
+                return -1;
+
+            scheme_element *name = scheme_pair_get_first((scheme_pair *)target);
+            if (!scheme_element_is_symbol(name))
+                return -1;
+
+            // Expressions are every element after the target.
+            int result = _compile_closure(bytecode,
+                                          scheme_symbol_get_value_ref((scheme_symbol *)name),
+                                          NULL,
+                                          scheme_pair_get_second((scheme_pair *)target),
+                                          scheme_pair_get_second((scheme_pair *)list),
+                                          namespace);
+            if (result <= 0) return result;
+
+            return _emit_constant(bytecode, SCHEME_OP_DEFINE, name);
+        }
+
+        case SCHEME_FORM_LAMBDA:
+        {
+            // (lambda <arguments> <expression> ...)
+            if (count < 2) return -1;
+
+            return _compile_closure(bytecode, NULL, NULL, arguments[0], scheme_pair_get_second((scheme_pair *)list), namespace);
+        }
+
+        case SCHEME_FORM_LET:
+        {
+            // The procedure is created and applied to no arguments, so that
+            // every argument takes its default value, the way the built-in
+            // procedure does.
+            int result;
+            if (count >= 2 && scheme_element_is_pair(arguments[0]))
+            {
+                // (let (<binding> ...) <expression> ...)
+                result = _compile_closure(bytecode, NULL, NULL, arguments[0], scheme_pair_get_second((scheme_pair *)list), namespace);
+            }
+            else if (count >= 3 && scheme_element_is_symbol(arguments[0]))
+            {
+                // (let <identifier> (<binding> ...) <expression> ...)
+                scheme_symbol *name = (scheme_symbol *)arguments[0];
+                scheme_element *rest = scheme_pair_get_second((scheme_pair *)list);
+                result = _compile_closure(bytecode,
+                                          scheme_symbol_get_value_ref(name),
+                                          name,
+                                          arguments[1],
+                                          scheme_pair_get_second((scheme_pair *)rest),
+                                          namespace);
+            }
+            else
+            {
+                return -1;
+            }
+
+            if (result <= 0) return result;
+
+            if (scheme_bytecode_emit(bytecode, tail ? SCHEME_OP_TAIL_CALL : SCHEME_OP_CALL) < 0) return 0;
+            if (scheme_bytecode_emit(bytecode, 0) < 0) return 0;
+            return 1;
+        }
+
+        case SCHEME_FORM_COND:
+        {
+            // (cond (<condition> [<expression>] ...) ...)
+            return _compile_cond(bytecode, arguments, count, namespace, tail);
+        }
+
+        case SCHEME_FORM_AND:
+        case SCHEME_FORM_OR:
+        {
+            // (and <expression> ...), (or <expression> ...)
+            return _compile_logic(bytecode, form, arguments, count, namespace, tail);
+        }
+
+        default:
+            // Other special forms are left to their procedures.
+            return -1;
+    }
+}
+
+static int _compile_sequence(scheme_bytecode *bytecode,
+                             scheme_element **expressions,
+                             int count,
+                             scheme_namespace *namespace,
+                             int tail)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        int last = i == count - 1;
+        if (!_compile(bytecode, expressions[i], namespace, last && tail)) return 0;
+        if (!last && scheme_bytecode_emit(bytecode, SCHEME_OP_POP) < 0) return 0;
+    }
+
+    return 1;
+}
+
+static int _compile_cond(scheme_bytecode *bytecode,
+                         scheme_element **blocks,
+                         int count,
+                         scheme_namespace *namespace,
+                         int tail)
+{
+    if (_elseSymbol == NULL && (_elseSymbol = scheme_symbol_new("else")) == NULL)
+        return 0;
+
+    if (count == 0) return -1;
+
+    // Every block must be a non-empty list, and only the last two blocks
+    // may have "else" for condition, as the built-in procedure requires.
+    // A block made of "else" alone is an error left to the procedure.
+    for (int i = 0; i < count; ++i)
+    {
+        scheme_pair *block = (scheme_pair *)blocks[i];
+        if (!scheme_element_is_pair(blocks[i])
+            || scheme_pair_is_empty(block)
+            || !scheme_pair_is_list(block))
+            return -1;
+
+        if (scheme_pair_get_first(block) == (scheme_element *)_elseSymbol
+            && (i < count - 2 || scheme_pair_is_empty((scheme_pair *)scheme_pair_get_second(block))))
+            return -1;
+    }
+
+    // Every chosen block jumps to the end, which is patched into the list
+    // of jumps as they are emitted.
+    int *endTargets = malloc(sizeof(int) * count);
+    if (endTargets == NULL) return 0;
+
+    int endCount = 0;
+    int isExhaustive = 0;
+    for (int i = 0; i < count && !isExhaustive; ++i)
+    {
+        int expressionCount;
+        scheme_element **expressions = scheme_list_to_array((scheme_pair *)blocks[i], &expressionCount);
+        if (expressionCount < 0)
+        {
+            free(endTargets);
+            return 0;
+        }
+
+        int result = 1;
+        int nextTarget = -1;
+        if (expressions[0] == (scheme_element *)_elseSymbol)
+        {
+            // "else" is always chosen.
+            isExhaustive = 1;
+            result = _compile_sequence(bytecode, expressions + 1, expressionCount - 1, namespace, tail);
+        }
+        else if (expressionCount == 1)
+        {
+            // A condition by itself is the result unless it is #f. Unlike
+            // "if", only #f itself is false.
+            result = _compile(bytecode, expressions[0], namespace, 0)
+                     && scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP_IF_IS_NOT_FALSE_OR_POP) >= 0;
+        }
+        else
+        {
+            result = _compile(bytecode, expressions[0], namespace, 0)
+                     && scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP_IF_IS_FALSE) >= 0
+                     && (nextTarget = scheme_bytecode_emit(bytecode, 0)) >= 0
+                     && _compile_sequence(bytecode, expressions + 1, expressionCount - 1, namespace, tail)
+                     && scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP) >= 0;
+        }
+        free(expressions);
+
+        if (result && !isExhaustive)
+            result = (endTargets[endCount++] = scheme_bytecode_emit(bytecode, 0)) >= 0;
+
+        if (!result)
+        {
+            free(endTargets);
+            return 0;
+        }
+
+        if (nextTarget >= 0)
+            scheme_bytecode_patch(bytecode, nextTarget, scheme_bytecode_get_length(bytecode));
+    }
+
+    // No block was chosen.
+    int result = isExhaustive || _emit_constant(bytecode, SCHEME_OP_CONSTANT, scheme_void_get());
+
+    for (int i = 0; i < endCount; ++i)
+    {
+        scheme_bytecode_patch(bytecode, endTargets[i], scheme_bytecode_get_length(bytecode));
+    }
+
+    free(endTargets);
+    return result;
+}
+
+static int _compile_logic(scheme_bytecode *bytecode,
+                          int form,
+                          scheme_element **arguments,
+                          int count,
+                          scheme_namespace *namespace,
+                          int tail)
+{
+    int isAnd = form == SCHEME_FORM_AND;
+
+    // (and) is #t, (or) is #f.
+    if (count == 0)
+        return _emit_constant(bytecode,
+                              SCHEME_OP_CONSTANT,
+                              isAnd ? (scheme_element *)scheme_boolean_get_true() : (scheme_element *)scheme_boolean_get_false());
+
+    // Each argument but the last decides the result if it is #f, for "and",
+    // or if it is not, for "or". The result of "or" stays on the stack.
+    int *targets = malloc(sizeof(int) * count);
+    if (targets == NULL) return 0;
+
+    int result = 1;
+    for (int i = 0; i < count - 1 && result; ++i)
+    {
+        result = _compile(bytecode, arguments[i], namespace, 0)
+                 && scheme_bytecode_emit(bytecode, isAnd ? SCHEME_OP_JUMP_IF_FALSE : SCHEME_OP_JUMP_IF_TRUE_OR_POP) >= 0
+                 && (targets[i] = scheme_bytecode_emit(bytecode, 0)) >= 0;
+    }
+
+    // Otherwise, the result is the last argument, unless it is #f for "and",
+    // which then gives #f itself. That argument is only in tail position for
+    // "or".
+    int endTarget = -1;
+    int falseTarget = -1;
+    if (isAnd)
+        result = result
+                 && _compile(bytecode, arguments[count - 1], namespace, 0)
+                 && scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP_IF_TRUE_OR_POP) >= 0
+                 && (endTarget = scheme_bytecode_emit(bytecode, 0)) >= 0
+                 && scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP) >= 0
+                 && (falseTarget = scheme_bytecode_emit(bytecode, 0)) >= 0;
+    else
+        result = result
+                 && _compile(bytecode, arguments[count - 1], namespace, tail)
+                 && scheme_bytecode_emit(bytecode, SCHEME_OP_JUMP) >= 0
+                 && (endTarget = scheme_bytecode_emit(bytecode, 0)) >= 0;
+
+    // The arguments following the one that decided the result.
+    for (int i = 1; i < count && result; ++i)
+    {
+        scheme_bytecode_patch(bytecode, targets[i - 1], scheme_bytecode_get_length(bytecode));
+        result = _compile(bytecode, arguments[i], namespace, 0)
+                 && scheme_bytecode_emit(bytecode, SCHEME_OP_POP) >= 0;
+    }
+
+    if (result && isAnd)
+    {
+        scheme_bytecode_patch(bytecode, falseTarget, scheme_bytecode_get_length(bytecode));
+        result = _emit_constant(bytecode, SCHEME_OP_CONSTANT, (scheme_element *)scheme_boolean_get_false());
+    }
+
+    if (result)
+        scheme_bytecode_patch(bytecode, endTarget, scheme_bytecode_get_length(bytecode));
+
+    free(targets);
+    return result;
+}
+
+static int _compile_closure(scheme_bytecode *bytecode,
+                            const char *name,
+                            scheme_symbol *binding,
+                            scheme_element *arguments,
+                            scheme_element *expressions,
+                            scheme_namespace *namespace)
+{
+    // The procedure created at compile time serves as a template for the
+    // ones created each time the instruction is executed.
+    scheme_lambda *template = scheme_lambda_new_from_elements(name, arguments, expressions, NULL);
+    if (template == NULL) return -1;
+
+    scheme_bytecode *code = scheme_compile_procedure(template, namespace);
+    if (code == NULL)
+    {
+        scheme_element_free((scheme_element *)template);
+        return 0;
+    }
+
+    scheme_lambda_set_code(template, (scheme_element *)code);
+    scheme_element_free((scheme_element *)code);
+
+    int result = _emit_constant(bytecode, binding != NULL ? SCHEME_OP_NAMED_CLOSURE : SCHEME_OP_CLOSURE, (scheme_element *)template);
+    scheme_element_free((scheme_element *)template);
+
+    if (result && binding != NULL)
+    {
+        int index = scheme_bytecode_add_constant(bytecode, (scheme_element *)binding);
+        result = index >= 0 && scheme_bytecode_emit(bytecode, index) >= 0;
+    }
+
+    return result;
+}
+
+/**** Public function implementations ****/
+
+scheme_bytecode *scheme_compile(scheme_element *expression, scheme_namespace *namespace)
+{
+    scheme_bytecode *bytecode = scheme_bytecode_new();
+    if (bytecode == NULL) return NULL;
+
+    if (!_compile(bytecode, expression, namespace, 1) || scheme_bytecode_emit(bytecode, SCHEME_OP_RETURN) < 0)
+    {
+        scheme_element_free((scheme_element *)bytecode);
+        return NULL;
+    }
+
+    return bytecode;
+}
+
+scheme_bytecode *scheme_compile_procedure(scheme_lambda *lambda, scheme_namespace *namespace)
+{
+    scheme_bytecode *bytecode = scheme_bytecode_new();
+    if (bytecode == NULL) return NULL;
+
+    // Evaluate every expression, keeping the result of the last one.
+    int count;
+    scheme_element **expressions = scheme_lambda_get_expressions(lambda, &count);
+    if (!_compile_sequence(bytecode, expressions, count, namespace, 1))
+    {
+        scheme_element_free((scheme_element *)bytecode);
+        return NULL;
+    }
+
+    if (scheme_bytecode_emit(bytecode, SCHEME_OP_RETURN) < 0)
+    {
+        scheme_element_free((scheme_element *)bytecode);
+        return NULL;
+    }
+
+    return bytecode;
+}
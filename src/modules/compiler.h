@@ -0,0 +1,41 @@
+/**
+ * Scheme bytecode compiler.
+ *
+ * Compiles resolved Scheme expressions into bytecode for the virtual
+ * machine. The special forms "quote", "if", "cond", "define", "lambda",
+ * "let", "and" and "or" are compiled into instructions, as long as their
+ * identifier refers to the built-in procedure of the same name when an
+ * expression is compiled. Everything else is compiled into procedure calls.
+ */
+
+#ifndef __SCHEME_COMPILER_H__
+#define __SCHEME_COMPILER_H__
+
+#include "scheme-data-types.h"
+#include "scheme-bytecode.h"
+
+/**
+ * Compile a top-level Scheme expression.
+ *
+ * Returned pointer must be freed with scheme_element_free().
+ *
+ * @param  expression  A resolved Scheme expression.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ *
+ * @return Bytecode, or NULL if out of memory.
+ */
+scheme_bytecode *scheme_compile(scheme_element *expression, scheme_namespace *namespace);
+
+/**
+ * Compile the expressions of a lambda procedure.
+ *
+ * Returned pointer must be freed with scheme_element_free().
+ *
+ * @param  lambda     A lambda procedure.
+ * @param  namespace  Namespace the procedure was created in.
+ *
+ * @return Bytecode, or NULL if out of memory.
+ */
+scheme_bytecode *scheme_compile_procedure(scheme_lambda *lambda, scheme_namespace *namespace);
+
+#endif
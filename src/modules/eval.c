@@ -3,43 +3,217 @@
 
 #include "eval.h"
 
-/**** Public function implementations ****/
+/**** Private function declarations ****/
 
-scheme_element *scheme_evaluate(scheme_element *element, scheme_namespace *namespace)
+/**
+ * Evaluate a Scheme element.
+ *
+ * @param  element    Element to be evaluated.
+ * @param  namespace  Active namespace.
+ * @param  tail       1 to defer a procedure call with
+ *                    scheme_procedure_apply_tail() instead of applying it.
+ *
+ * @return Result, tail call marker, or NULL if expression could not be
+ *         evaluated.
+ */
+static scheme_element *_evaluate(scheme_element *element, scheme_namespace *namespace, int tail);
+
+/**
+ * Get the elements of a list of a given length, without allocating memory.
+ *
+ * @param  list      A Scheme element.
+ * @param  elements  Array receiving the elements.
+ * @param  count     Expected number of elements.
+ *
+ * @return 1 if the element is a list of exactly that many elements, 0
+ *         otherwise.
+ */
+static int _get_elements(scheme_element *list, scheme_element **elements, int count);
+
+/**
+ * Evaluate "if": evaluate the condition, then one of the two branches.
+ *
+ * @param  arguments  List of elements following the identifier.
+ * @param  namespace  Active namespace.
+ * @param  tail       1 to defer a procedure call in the chosen branch.
+ *
+ * @return Result, tail call marker, or NULL if expression could not be
+ *         evaluated.
+ */
+static scheme_element *_evaluate_if(scheme_element *arguments, scheme_namespace *namespace, int tail);
+
+/**** Private variables ****/
+
+static const char *_formNames[SCHEME_FORM_COUNT] = {"quote", "if", "define", "lambda", "let", "cond", "and", "or"};
+static scheme_symbol *_formSymbols[SCHEME_FORM_COUNT];
+static scheme_element *_formProcedures[SCHEME_FORM_COUNT];
+
+/**** Private function implementations ****/
+
+static scheme_element *_evaluate(scheme_element *element, scheme_namespace *namespace, int tail)
 {
     if (element == NULL) return NULL;
 
+    // Symbols, references and pairs have no subtypes, so their tags can be
+    // compared directly.
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+
     // If element is a symbol, resolve it.
-    if (scheme_element_is_type(element, scheme_symbol_get_type()))
+    if (tag == SCHEME_ELEMENT_TAG_SYMBOL)
     {
-        char *symbolValue = scheme_symbol_get_value((scheme_symbol *)element);
-        scheme_element *resolvedElement = scheme_namespace_get(namespace, symbolValue);
-        free(symbolValue);
+        return scheme_namespace_get_symbol(namespace, (scheme_symbol *)element);
+    }
 
-        return resolvedElement;
+    // If element is a variable reference, look it up by slot.
+    if (tag == SCHEME_ELEMENT_TAG_REFERENCE)
+    {
+        return scheme_element_copy(scheme_reference_lookup_ref((scheme_reference *)element, namespace));
     }
 
     // If element is not a pair, simply return it.
-    if (!scheme_element_is_type(element, scheme_pair_get_type()))
+    if (tag != SCHEME_ELEMENT_TAG_PAIR)
         return scheme_element_copy(element);
 
     // Element is a pair.
-    // Evaluate first element.
+    // Evaluate first element. If it is a symbol or variable reference,
+    // borrow the procedure from the namespace instead of acquiring a
+    // reference to it; a lambda procedure keeps itself alive while it is
+    // being applied.
     scheme_pair *pair = (scheme_pair *)element;
     scheme_element *first = scheme_pair_get_first(pair);
-    first = scheme_evaluate(first, namespace);
+    enum scheme_element_tag firstTag = scheme_element_get_tag(first);
+    scheme_element *second = scheme_pair_get_second(pair);
+    int borrowed = 1;
+    if (firstTag == SCHEME_ELEMENT_TAG_SYMBOL)
+    {
+        // Special forms need no lookup.
+        scheme_element *builtin = scheme_symbol_get_builtin((scheme_symbol *)first);
+        if (builtin == NULL)
+            first = scheme_namespace_lookup_ref(namespace, (scheme_symbol *)first);
+        else if (builtin == _formProcedures[SCHEME_FORM_QUOTE])
+        {
+            scheme_element *quoted;
+            return _get_elements(second, &quoted, 1) ? scheme_element_copy(quoted) : NULL;
+        }
+        else if (builtin == _formProcedures[SCHEME_FORM_IF])
+            return _evaluate_if(second, namespace, tail);
+        else
+            first = builtin;
+    }
+    else if (firstTag == SCHEME_ELEMENT_TAG_REFERENCE)
+        first = scheme_reference_lookup_ref((scheme_reference *)first, namespace);
+    else
+    {
+        first = _evaluate(first, namespace, 0);
+        borrowed = 0;
+    }
 
     // Evaluated first element must be a procedure.
-    if (!scheme_element_is_type(first, scheme_procedure_get_type()))
+    if (!scheme_element_is_procedure(first))
     {
-        scheme_element_free(first);
+        if (!borrowed)
+            scheme_element_free(first);
 
         return NULL;
     }
 
     // Use procedure to evaluate second element of pair and return result.
-    scheme_element *second = scheme_pair_get_second(pair);
-    scheme_element *result = scheme_procedure_apply((scheme_procedure *)first, second, namespace);
-    scheme_element_free(first);
+    scheme_element *result;
+    if (tail)
+        result = scheme_procedure_apply_tail((scheme_procedure *)first, second, namespace);
+    else
+        result = scheme_procedure_apply((scheme_procedure *)first, second, namespace);
+
+    if (!borrowed)
+        scheme_element_free(first);
     return result;
 }
+
+static int _get_elements(scheme_element *list, scheme_element **elements, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (!scheme_element_is_pair(list) || scheme_pair_is_empty((scheme_pair *)list))
+            return 0;
+
+        elements[i] = scheme_pair_get_first((scheme_pair *)list);
+        list = scheme_pair_get_second((scheme_pair *)list);
+    }
+
+    return scheme_element_is_pair(list) && scheme_pair_is_empty((scheme_pair *)list);
+}
+
+static scheme_element *_evaluate_if(scheme_element *arguments, scheme_namespace *namespace, int tail)
+{
+    // (if <condition> <then> <else>)
+    scheme_element *elements[3];
+    if (!_get_elements(arguments, elements, 3)) return NULL;
+
+    scheme_element *condition = _evaluate(elements[0], namespace, 0);
+    if (condition == NULL) return NULL;
+
+    int conditionIsFalse = scheme_element_compare(condition, (scheme_element *)scheme_boolean_get_false());
+    scheme_element_free(condition);
+
+    return _evaluate(conditionIsFalse ? elements[2] : elements[1], namespace, tail);
+}
+
+/**** Public function implementations ****/
+
+void scheme_evaluator_init(scheme_namespace *namespace)
+{
+    for (int i = 0; i < SCHEME_FORM_COUNT; ++i)
+    {
+        _formSymbols[i] = scheme_symbol_new(_formNames[i]);
+        _formProcedures[i] = NULL;
+        if (_formSymbols[i] == NULL) continue;
+
+        // Only built-in procedures are recognized, not lambda procedures
+        // that happen to share their name.
+        scheme_element *procedure = scheme_namespace_lookup_ref(namespace, _formSymbols[i]);
+        if (scheme_element_is_procedure(procedure)
+            && !scheme_element_is_lambda(procedure))
+        {
+            _formProcedures[i] = procedure;
+            scheme_symbol_set_builtin(_formSymbols[i], procedure);
+        }
+    }
+}
+
+int scheme_evaluator_get_special_form(scheme_pair *pair)
+{
+    scheme_element *first = scheme_pair_get_first(pair);
+    if (!scheme_element_is_symbol(first)) return -1;
+
+    scheme_element *builtin = scheme_symbol_get_builtin((scheme_symbol *)first);
+    if (builtin == NULL) return -1;
+
+    for (int i = 0; i < SCHEME_FORM_COUNT; ++i)
+    {
+        if (builtin == _formProcedures[i])
+            return i;
+    }
+
+    return -1;
+}
+
+int scheme_evaluator_is_syntax(scheme_element *element)
+{
+    for (int i = 0; i < SCHEME_FORM_COUNT; ++i)
+    {
+        if (element == _formProcedures[i] && element != NULL)
+            return 1;
+    }
+
+    return 0;
+}
+
+scheme_element *scheme_evaluate(scheme_element *element, scheme_namespace *namespace)
+{
+    return _evaluate(element, namespace, 0);
+}
+
+scheme_element *scheme_evaluate_tail(scheme_element *element, scheme_namespace *namespace)
+{
+    return _evaluate(element, namespace, 1);
+}
@@ -1,5 +1,11 @@
 /**
  * Scheme expression evaluator.
+ *
+ * The special forms below are recognized by the interned symbol naming
+ * them, as long as the symbol has never been bound to anything other than
+ * the built-in procedure of the same name. "quote" and "if" are then
+ * evaluated in place, and the others are applied without looking their
+ * symbol up.
  */
 
 #ifndef __SCHEME_EVALUATOR_H__
@@ -7,6 +13,51 @@
 
 #include "scheme-data-types.h"
 
+// Built-in procedures that receive their arguments unevaluated.
+enum scheme_special_form {
+    SCHEME_FORM_QUOTE,
+    SCHEME_FORM_IF,
+    SCHEME_FORM_DEFINE,
+    SCHEME_FORM_LAMBDA,
+    SCHEME_FORM_LET,
+    SCHEME_FORM_COND,
+    SCHEME_FORM_AND,
+    SCHEME_FORM_OR,
+    SCHEME_FORM_COUNT
+};
+
+/**
+ * Find the built-in procedures of the special forms, such as "if" and
+ * "define", in a namespace. Must be called once the built-in procedures have
+ * been loaded and before evaluating anything.
+ *
+ * @param  namespace  Base namespace holding the built-in procedures.
+ */
+void scheme_evaluator_init(scheme_namespace *namespace);
+
+/**
+ * Find which special form an expression is.
+ *
+ * The expression must have been resolved: an identifier that a local
+ * namespace binds, or that a procedure's body may define, is then a
+ * reference instead of a symbol, and never names a special form.
+ *
+ * @param  pair  A non-empty pair.
+ *
+ * @return Special form, or -1 if the pair is not a special form whose
+ *         identifier still refers to its built-in procedure.
+ */
+int scheme_evaluator_get_special_form(scheme_pair *pair);
+
+/**
+ * Check if an element is the built-in procedure of a special form.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+int scheme_evaluator_is_syntax(scheme_element *element);
+
 /**
  * Evaluate a Scheme element.
  * Returned element must be freed with scheme_element_free().
@@ -19,4 +70,21 @@
  */
 scheme_element *scheme_evaluate(scheme_element *element, scheme_namespace *namespace);
 
+/**
+ * Evaluate a Scheme element in tail position.
+ *
+ * Same as scheme_evaluate(), except that a procedure call is deferred with
+ * scheme_procedure_apply_tail() instead of being applied. May only be
+ * called by a function stored in a procedure, whose result it must return
+ * as is.
+ *
+ * @param  element    Element to be evaluated.
+ * @param  namespace  A Scheme namespace. Symbols found during evaluation will
+ *                    be resolved using this namespace.
+ *
+ * @return Result, tail call marker, or NULL if expression could not be
+ *         evaluated.
+ */
+scheme_element *scheme_evaluate_tail(scheme_element *element, scheme_namespace *namespace);
+
 #endif
@@ -21,6 +21,11 @@ typedef int (scheme_procedure_alias_count_getter_func)(void);
 // Typedef for this function.
 typedef const char *(scheme_procedure_alias_getter_func)(int);
 
+// Name of function to get whether the procedure stored in a handle is pure.
+#define SCHEME_PROCEDURE_PURITY_GETTER_FUNC_NAME "scheme_procedure_get_purity"
+// Typedef for this function.
+typedef int (scheme_procedure_purity_getter_func)(void);
+
 // Linked list for loader.
 struct scheme_loader_item {
     // Handle from dlopen.
@@ -79,7 +84,7 @@ int scheme_loader_load_file(scheme_loader *loader, const char *path)
     // Verify handle contains a Scheme procedure getter function.
     scheme_procedure_getter_func *getter = dlsym(handle, SCHEME_PROCEDURE_GETTER_FUNC_NAME);
     scheme_procedure *proc = (*getter)();
-    if (!scheme_element_is_type((scheme_element *)proc, scheme_procedure_get_type()))
+    if (!scheme_element_is_procedure((scheme_element *)proc))
     {
         dlclose(handle);
         return 0;
@@ -147,6 +152,7 @@ void scheme_loader_put_onto_namespace(scheme_loader *loader, scheme_namespace *n
         scheme_procedure *proc = (*getter)();
         char *procName = scheme_procedure_get_name(proc);
         scheme_namespace_set(namespace, procName, (scheme_element *)proc);
+        free(procName);
 
         // Optionally get aliases for procedure and store procedure in namespace under these aliases.
         scheme_procedure_alias_count_getter_func *aliasCountGetter = dlsym(item->handle, SCHEME_PROCEDURE_ALIASES_COUNT_FUNC_NAME);
@@ -161,6 +167,14 @@ void scheme_loader_put_onto_namespace(scheme_loader *loader, scheme_namespace *n
             }
         }
 
+        // Optionally mark procedure as pure, so that calls to it with
+        // constant arguments may be folded.
+        scheme_procedure_purity_getter_func *purityGetter = dlsym(item->handle, SCHEME_PROCEDURE_PURITY_GETTER_FUNC_NAME);
+        if (purityGetter != NULL)
+        {
+            scheme_procedure_set_pure(proc, (*purityGetter)());
+        }
+
         // Advance to next item.
         item = item->next;
     }
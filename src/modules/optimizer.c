@@ -0,0 +1,922 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "optimizer.h"
+#include "eval.h"
+#include "utils.h"
+#include "scheme-procedure-init.h"
+
+// Initial capacity of the arrays of identifiers.
+#define SCHEME_OPTIMIZER_INITIAL_SIZE 8
+
+// Largest number of elements in the body of a procedure that is inlined.
+#define SCHEME_OPTIMIZER_INLINE_SIZE 16
+
+// State of the optimization of a top-level expression.
+struct _optimizer {
+    // Namespace the expression will be evaluated in.
+    scheme_namespace *namespace;
+    // Identifiers the expression may define, which are never assumed to
+    // refer to the procedure they refer to now.
+    scheme_symbol **defined;
+    int definedCount;
+    int definedSize;
+    // Identifiers bound by the lambda procedures and "let" enclosing the
+    // element being optimized.
+    scheme_symbol **bound;
+    int boundCount;
+    int boundSize;
+    // 1 while optimizing the body of a procedure being inlined, in which
+    // nothing else is inlined.
+    int inlining;
+};
+
+// Optimizations made across every expression.
+struct _report {
+    long foldedCount;
+    long branchCount;
+    long inlinedCount;
+};
+
+/**** Private function declarations ****/
+
+/**
+ * Append a symbol to a growable array of symbols, unless it is already in
+ * the array.
+ *
+ * @param  array   Address of array.
+ * @param  count   Address of number of symbols in array.
+ * @param  size    Address of array's capacity.
+ * @param  symbol  A Scheme symbol.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _add_symbol(scheme_symbol ***array, int *count, int *size, scheme_symbol *symbol);
+
+/**
+ * Find a symbol in an array of symbols.
+ *
+ * @param  array   An array of symbols.
+ * @param  count   Number of symbols in array.
+ * @param  symbol  A Scheme symbol.
+ *
+ * @return 1 if found, 0 otherwise.
+ */
+static int _has_symbol(scheme_symbol **array, int count, scheme_symbol *symbol);
+
+/**
+ * Add argument identifiers to the identifiers bound around the element
+ * being optimized.
+ *
+ * @param  optimizer  Optimizer.
+ * @param  arguments  Argument identifiers, in any form accepted by
+ *                    scheme_lambda_new_from_elements(), or bindings of
+ *                    "let".
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _bind_arguments(struct _optimizer *optimizer, scheme_element *arguments);
+
+/**
+ * Collect identifiers that may be defined when evaluating an element.
+ *
+ * @param  optimizer  Optimizer to add identifiers to.
+ * @param  element    A Scheme element.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _collect_definitions(struct _optimizer *optimizer, scheme_element *element);
+
+/**
+ * Check if an identifier may refer to something else than what it refers
+ * to in the namespace, because the expression being optimized may define
+ * it or because it is bound around the element being optimized.
+ *
+ * @param  optimizer  Optimizer.
+ * @param  symbol     A Scheme symbol.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static int _is_shadowed(struct _optimizer *optimizer, scheme_symbol *symbol);
+
+/**
+ * Get the value of an expression that always evaluates to the same
+ * element without side effects: a quoted element, or an element that
+ * evaluates to itself.
+ *
+ * @param  element  An optimized expression.
+ *
+ * @return The value, which must not be freed, or NULL if the expression is
+ *         not a constant.
+ */
+static scheme_element *_constant_value(scheme_element *element);
+
+/**
+ * Create an expression that evaluates to a given element.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return The element itself, or the element quoted if it would not
+ *         evaluate to itself. NULL if "quote" no longer refers to the
+ *         built-in procedure or out of memory.
+ */
+static scheme_element *_literal(scheme_element *element);
+
+/**
+ * Optimize an expression.
+ *
+ * @param  optimizer  Optimizer.
+ * @param  element    A resolved Scheme element.
+ *
+ * @return Optimized element, or NULL if out of memory.
+ */
+static scheme_element *_optimize(struct _optimizer *optimizer, scheme_element *element);
+
+/**
+ * Optimize every element of a list. An improper tail is optimized as well.
+ *
+ * @param  optimizer  Optimizer.
+ * @param  list       A Scheme element.
+ *
+ * @return Optimized list, or NULL if out of memory.
+ */
+static scheme_element *_optimize_list(struct _optimizer *optimizer, scheme_element *list);
+
+/**
+ * Optimize the elements of a list after the given number of elements,
+ * which are left as is.
+ *
+ * @param  optimizer  Optimizer.
+ * @param  list       A Scheme list.
+ * @param  skip       Number of elements to leave as is.
+ *
+ * @return Optimized list, or NULL if out of memory.
+ */
+static scheme_element *_optimize_after(struct _optimizer *optimizer, scheme_element *list, int skip);
+
+/**
+ * Optimize the body of a lambda procedure, "define" or "let": the elements
+ * of a list after the given number of elements, with the given identifiers
+ * bound.
+ *
+ * @param  optimizer  Optimizer.
+ * @param  list       A Scheme list.
+ * @param  skip       Number of elements to leave as is.
+ * @param  name       Name of a procedure bound around the body, or NULL.
+ * @param  arguments  Argument identifiers or bindings, or NULL.
+ *
+ * @return Optimized list, or NULL if out of memory.
+ */
+static scheme_element *_optimize_body(struct _optimizer *optimizer,
+                                      scheme_element *list,
+                                      int skip,
+                                      scheme_element *name,
+                                      scheme_element *arguments);
+
+/**
+ * Replace an optimized "if" with one of its branches if its condition is a
+ * constant.
+ *
+ * @param  expression  An optimized "if" expression.
+ *
+ * @return Optimized expression.
+ */
+static scheme_element *_fold_if(scheme_element *expression);
+
+/**
+ * Replace an optimized call to a pure procedure with its result if every
+ * argument is a constant.
+ *
+ * @param  optimizer   Optimizer.
+ * @param  expression  An optimized call.
+ *
+ * @return Optimized expression.
+ */
+static scheme_element *_fold_call(struct _optimizer *optimizer, scheme_element *expression);
+
+/**
+ * Count the elements of an expression, up to a limit.
+ *
+ * @param  element  A Scheme element.
+ * @param  limit    Number of elements to stop counting at.
+ *
+ * @return Number of elements, or limit if there are more.
+ */
+static int _count_elements(scheme_element *element, int limit);
+
+/**
+ * Check if the body of a lambda procedure can be inlined, and count how
+ * often it uses each argument.
+ *
+ * @param  optimizer  Optimizer.
+ * @param  element    Part of the body.
+ * @param  name       Identifier the procedure is called by.
+ * @param  arity      Number of arguments of the procedure.
+ * @param  uses       Incremented by 1 for each use of an argument, by slot,
+ *                    or by 2 if the use might not be evaluated or might
+ *                    be evaluated after a side effect.
+ * @param  weight     1, or 2 if element might not be evaluated.
+ * @param  effects    Set to 1 once a procedure that is not pure may have
+ *                    been called.
+ * @param  size       Incremented by the number of elements.
+ *
+ * @return 1 if the body only refers to the procedure's own arguments and
+ *         to identifiers that are not shadowed where it would be inlined,
+ *         creates no namespace, does not call the procedure again and is
+ *         small enough, 0 otherwise.
+ */
+static int _is_inlinable(struct _optimizer *optimizer,
+                         scheme_element *element,
+                         scheme_symbol *name,
+                         int arity,
+                         int *uses,
+                         int weight,
+                         int *effects,
+                         int *size);
+
+/**
+ * Replace the variable references of the body of a lambda procedure with
+ * the expressions of its arguments.
+ *
+ * @param  element    Part of the body.
+ * @param  arguments  Argument expressions, by slot.
+ *
+ * @return Body with arguments substituted, or NULL if out of memory.
+ */
+static scheme_element *_substitute(scheme_element *element, scheme_element **arguments);
+
+/**
+ * Replace an optimized call to a small lambda procedure with its body, if
+ * every argument but at most one can be evaluated more than once or not at
+ * all, and that one is small and evaluated exactly once by the body. The body
+ * is only evaluated while the identifier still refers to the same
+ * procedure; otherwise, the call is evaluated as is.
+ *
+ * @param  optimizer   Optimizer.
+ * @param  expression  An optimized call.
+ *
+ * @return Optimized expression.
+ */
+static scheme_element *_inline_call(struct _optimizer *optimizer, scheme_element *expression);
+
+/**
+ * Implementation of the procedure guarding inlined bodies: return #t if
+ * both arguments are the same element, #f otherwise.
+ *
+ * @param  procedure  Procedure that refers to this function.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
+ *
+ * @return As described, or NULL if not given 2 arguments.
+ */
+static scheme_element *_guard_function(scheme_procedure *procedure, scheme_element **arguments, int count);
+
+/**
+ * Prevent freeing the statically allocated guard procedure.
+ * This function does nothing.
+ */
+static void _guard_free(scheme_element *element) {}
+
+/**
+ * Create a list.
+ *
+ * @param  elements  Elements of the list, which are copied.
+ * @param  count     Number of elements.
+ *
+ * @return Newly created list, or NULL if out of memory.
+ */
+static scheme_element *_list(scheme_element **elements, int count);
+
+/**
+ * Create a pair unless it would be equal to an existing one.
+ *
+ * @param  original  Existing pair.
+ * @param  first     Optimized first element, whose reference is taken over.
+ * @param  second    Optimized second element, whose reference is taken over.
+ *
+ * @return A pair, or NULL if out of memory.
+ */
+static scheme_element *_rebuild(scheme_pair *original, scheme_element *first, scheme_element *second);
+
+/**** Private variables ****/
+
+static scheme_symbol *_symbol_define = NULL;
+static scheme_symbol *_symbol_quote = NULL;
+static scheme_symbol *_symbol_if = NULL;
+
+static struct _report _report;
+
+// Procedure guarding inlined bodies.
+static scheme_procedure _guard_procedure;
+static struct scheme_element_vtable _guard_vtable;
+
+/**** Private function implementations ****/
+
+static int _add_symbol(scheme_symbol ***array, int *count, int *size, scheme_symbol *symbol)
+{
+    if (_has_symbol(*array, *count, symbol)) return 1;
+
+    if (*count >= *size)
+    {
+        int newSize = *size > 0 ? *size * 2 : SCHEME_OPTIMIZER_INITIAL_SIZE;
+        scheme_symbol **newArray = realloc(*array, sizeof(scheme_symbol *) * newSize);
+        if (newArray == NULL) return 0;
+
+        *array = newArray;
+        *size = newSize;
+    }
+
+    (*array)[(*count)++] = symbol;
+    return 1;
+}
+
+static int _has_symbol(scheme_symbol **array, int count, scheme_symbol *symbol)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (array[i] == symbol)
+            return 1;
+    }
+
+    return 0;
+}
+
+static int _bind_arguments(struct _optimizer *optimizer, scheme_element *arguments)
+{
+    // Arguments, possibly with default values, then the rest ID.
+    while (scheme_element_is_pair(arguments) && !scheme_pair_is_empty((scheme_pair *)arguments))
+    {
+        scheme_element *id = scheme_pair_get_first((scheme_pair *)arguments);
+        if (scheme_element_is_pair(id) && !scheme_pair_is_empty((scheme_pair *)id))
+            id = scheme_pair_get_first((scheme_pair *)id);
+
+        if (scheme_element_is_symbol(id)
+            && !_add_symbol(&optimizer->bound, &optimizer->boundCount, &optimizer->boundSize, (scheme_symbol *)id))
+            return 0;
+
+        arguments = scheme_pair_get_second((scheme_pair *)arguments);
+    }
+
+    if (scheme_element_is_symbol(arguments))
+        return _add_symbol(&optimizer->bound, &optimizer->boundCount, &optimizer->boundSize, (scheme_symbol *)arguments);
+
+    return 1;
+}
+
+static int _collect_definitions(struct _optimizer *optimizer, scheme_element *element)
+{
+    if (!scheme_element_is_pair(element) || scheme_pair_is_empty((scheme_pair *)element))
+        return 1;
+
+    scheme_element *first = scheme_pair_get_first((scheme_pair *)element);
+    scheme_element *second = scheme_pair_get_second((scheme_pair *)element);
+
+    if (first == (scheme_element *)_symbol_quote)
+        return 1;
+
+    if (first == (scheme_element *)_symbol_define
+        && scheme_element_is_pair(second)
+        && !scheme_pair_is_empty((scheme_pair *)second))
+    {
+        // Either (define <identifier> ...) or (define (<identifier> ...) ...).
+        scheme_element *target = scheme_pair_get_first((scheme_pair *)second);
+        if (scheme_element_is_pair(target) && !scheme_pair_is_empty((scheme_pair *)target))
+            target = scheme_pair_get_first((scheme_pair *)target);
+
+        if (scheme_element_is_symbol(target)
+            && !_add_symbol(&optimizer->defined, &optimizer->definedCount, &optimizer->definedSize, (scheme_symbol *)target))
+            return 0;
+    }
+
+    // Look for definitions in every element of the list.
+    while (scheme_element_is_pair(element) && !scheme_pair_is_empty((scheme_pair *)element))
+    {
+        if (!_collect_definitions(optimizer, scheme_pair_get_first((scheme_pair *)element)))
+            return 0;
+
+        element = scheme_pair_get_second((scheme_pair *)element);
+    }
+
+    return 1;
+}
+
+static int _is_shadowed(struct _optimizer *optimizer, scheme_symbol *symbol)
+{
+    return _has_symbol(optimizer->defined, optimizer->definedCount, symbol)
+           || _has_symbol(optimizer->bound, optimizer->boundCount, symbol);
+}
+
+static scheme_element *_constant_value(scheme_element *element)
+{
+    // Symbols, references and pairs have no subtypes, so their types can be
+    // compared directly.
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+    if (tag == SCHEME_ELEMENT_TAG_SYMBOL || tag == SCHEME_ELEMENT_TAG_REFERENCE)
+        return NULL;
+
+    if (tag != SCHEME_ELEMENT_TAG_PAIR)
+        return element;
+
+    // (quote <element>)
+    scheme_pair *pair = (scheme_pair *)element;
+    if (scheme_evaluator_get_special_form(pair) != SCHEME_FORM_QUOTE)
+        return NULL;
+
+    scheme_element *rest = scheme_pair_get_second(pair);
+    if (!scheme_element_is_pair(rest) || scheme_pair_is_empty((scheme_pair *)rest))
+        return NULL;
+    if (!scheme_pair_is_empty((scheme_pair *)scheme_pair_get_second((scheme_pair *)rest)))
+        return NULL;
+
+    return scheme_pair_get_first((scheme_pair *)rest);
+}
+
+static scheme_element *_literal(scheme_element *element)
+{
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+    if (tag != SCHEME_ELEMENT_TAG_SYMBOL && tag != SCHEME_ELEMENT_TAG_REFERENCE && tag != SCHEME_ELEMENT_TAG_PAIR)
+        return scheme_element_copy(element);
+
+    if (scheme_symbol_get_builtin(_symbol_quote) == NULL)
+        return NULL;
+
+    return (scheme_element *)scheme_element_quote(element);
+}
+
+static scheme_element *_optimize(struct _optimizer *optimizer, scheme_element *element)
+{
+    if (!scheme_element_is_pair(element) || scheme_pair_is_empty((scheme_pair *)element))
+        return scheme_element_copy(element);
+
+    // Leave improper lists to the evaluator to reject.
+    scheme_pair *pair = (scheme_pair *)element;
+    if (!scheme_pair_is_list(pair))
+        return scheme_element_copy(element);
+
+    switch (scheme_evaluator_get_special_form(pair))
+    {
+        case SCHEME_FORM_QUOTE:
+            return scheme_element_copy(element);
+
+        case SCHEME_FORM_LAMBDA:
+        case SCHEME_FORM_DEFINE:
+        case SCHEME_FORM_LET:
+        {
+            scheme_element *rest = scheme_pair_get_second(pair);
+            if (scheme_pair_is_empty((scheme_pair *)rest))
+                return scheme_element_copy(element);
+
+            scheme_element *second = scheme_pair_get_first((scheme_pair *)rest);
+            scheme_element *body = scheme_pair_get_second((scheme_pair *)rest);
+
+            // (lambda <arguments> <expression> ...)
+            if (scheme_evaluator_get_special_form(pair) == SCHEME_FORM_LAMBDA)
+                return _optimize_body(optimizer, element, 2, NULL, second);
+
+            // (define (<identifier> <arguments> ...) <expression> ...) or
+            // (define <identifier> <expression>)
+            if (scheme_evaluator_get_special_form(pair) == SCHEME_FORM_DEFINE)
+            {
+                int procedure = scheme_element_is_pair(second) && !scheme_pair_is_empty((scheme_pair *)second);
+                return _optimize_body(optimizer, element, 2, NULL, procedure ? scheme_pair_get_second((scheme_pair *)second) : NULL);
+            }
+
+            // The bindings of "let" are stored unevaluated, so they are left
+            // as is: (let [<identifier>] (<binding> ...) <expression> ...)
+            if (scheme_element_is_symbol(second) && !scheme_pair_is_empty((scheme_pair *)body))
+                return _optimize_body(optimizer, element, 3, second, scheme_pair_get_first((scheme_pair *)body));
+
+            return _optimize_body(optimizer, element, 2, NULL, second);
+        }
+
+        case SCHEME_FORM_IF:
+        {
+            // (if <condition> <then> <else>)
+            scheme_element *optimized = _optimize_list(optimizer, element);
+            if (optimized == NULL) return NULL;
+
+            return _fold_if(optimized);
+        }
+
+        case SCHEME_FORM_COND:
+        case SCHEME_FORM_AND:
+        case SCHEME_FORM_OR:
+            // Conditions and expressions are optimized like arguments;
+            // "else" is left as is since it is a symbol.
+            return _optimize_list(optimizer, element);
+    }
+
+    // Procedure call.
+    scheme_element *optimized = _optimize_list(optimizer, element);
+    if (optimized == NULL) return NULL;
+
+    optimized = _fold_call(optimizer, optimized);
+    if (!scheme_element_is_pair(optimized) || _constant_value(optimized) != NULL)
+        return optimized;
+
+    return _inline_call(optimizer, optimized);
+}
+
+static scheme_element *_optimize_list(struct _optimizer *optimizer, scheme_element *list)
+{
+    if (!scheme_element_is_pair(list))
+        return _optimize(optimizer, list);
+
+    if (scheme_pair_is_empty((scheme_pair *)list))
+        return scheme_element_copy(list);
+
+    scheme_element *first = _optimize(optimizer, scheme_pair_get_first((scheme_pair *)list));
+    if (first == NULL) return NULL;
+
+    scheme_element *second = _optimize_list(optimizer, scheme_pair_get_second((scheme_pair *)list));
+    if (second == NULL)
+    {
+        scheme_element_free(first);
+        return NULL;
+    }
+
+    return _rebuild((scheme_pair *)list, first, second);
+}
+
+static scheme_element *_optimize_after(struct _optimizer *optimizer, scheme_element *list, int skip)
+{
+    if (skip == 0)
+        return _optimize_list(optimizer, list);
+
+    if (!scheme_element_is_pair(list) || scheme_pair_is_empty((scheme_pair *)list))
+        return scheme_element_copy(list);
+
+    scheme_element *second = _optimize_after(optimizer, scheme_pair_get_second((scheme_pair *)list), skip - 1);
+    if (second == NULL) return NULL;
+
+    return _rebuild((scheme_pair *)list, scheme_element_copy(scheme_pair_get_first((scheme_pair *)list)), second);
+}
+
+static scheme_element *_optimize_body(struct _optimizer *optimizer,
+                                      scheme_element *list,
+                                      int skip,
+                                      scheme_element *name,
+                                      scheme_element *arguments)
+{
+    int boundCount = optimizer->boundCount;
+
+    scheme_element *result = NULL;
+    if ((name == NULL || _bind_arguments(optimizer, name)) && _bind_arguments(optimizer, arguments))
+        result = _optimize_after(optimizer, list, skip);
+
+    optimizer->boundCount = boundCount;
+    return result;
+}
+
+static scheme_element *_fold_if(scheme_element *expression)
+{
+    int count;
+    scheme_element **arguments = scheme_list_to_array((scheme_pair *)scheme_pair_get_second((scheme_pair *)expression), &count);
+    if (count < 0) return expression;
+
+    scheme_element *condition = count == 3 ? _constant_value(arguments[0]) : NULL;
+    if (condition == NULL)
+    {
+        free(arguments);
+        return expression;
+    }
+
+    // Only #f is false.
+    int conditionIsFalse = scheme_element_compare(condition, (scheme_element *)scheme_boolean_get_false());
+    scheme_element *branch = scheme_element_copy(arguments[conditionIsFalse ? 2 : 1]);
+
+    free(arguments);
+    scheme_element_free(expression);
+
+    _report.branchCount += 1;
+    return branch;
+}
+
+static scheme_element *_fold_call(struct _optimizer *optimizer, scheme_element *expression)
+{
+    // Procedure must be a pure built-in procedure named by an identifier
+    // the expression does not define.
+    scheme_element *first = scheme_pair_get_first((scheme_pair *)expression);
+    if (scheme_element_get_tag(first) != SCHEME_ELEMENT_TAG_SYMBOL || _is_shadowed(optimizer, (scheme_symbol *)first))
+        return expression;
+
+    scheme_element *procedure = scheme_namespace_lookup_ref(optimizer->namespace, (scheme_symbol *)first);
+    if (procedure == NULL
+        || scheme_element_get_tag(procedure) != SCHEME_ELEMENT_TAG_PROCEDURE
+        || !scheme_procedure_is_pure((scheme_procedure *)procedure))
+        return expression;
+
+    // Every argument must be a constant.
+    int count;
+    scheme_element **arguments = scheme_list_to_array((scheme_pair *)scheme_pair_get_second((scheme_pair *)expression), &count);
+    if (count < 0) return expression;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if ((arguments[i] = _constant_value(arguments[i])) == NULL)
+        {
+            free(arguments);
+            return expression;
+        }
+    }
+
+    // Calls that fail are left to fail when they are evaluated.
+    scheme_element *result = scheme_procedure_apply_values((scheme_procedure *)procedure, arguments, count, optimizer->namespace);
+    free(arguments);
+    if (result == NULL) return expression;
+
+    scheme_element *literal = _literal(result);
+    scheme_element_free(result);
+    if (literal == NULL) return expression;
+
+    scheme_element_free(expression);
+
+    _report.foldedCount += 1;
+    return literal;
+}
+
+static int _count_elements(scheme_element *element, int limit)
+{
+    if (!scheme_element_is_pair(element) || scheme_pair_is_empty((scheme_pair *)element))
+        return 1;
+
+    int count = _count_elements(scheme_pair_get_first((scheme_pair *)element), limit);
+    if (count < limit)
+        count += _count_elements(scheme_pair_get_second((scheme_pair *)element), limit - count);
+
+    return count < limit ? count : limit;
+}
+
+static int _is_inlinable(struct _optimizer *optimizer,
+                         scheme_element *element,
+                         scheme_symbol *name,
+                         int arity,
+                         int *uses,
+                         int weight,
+                         int *effects,
+                         int *size)
+{
+    if (++*size > SCHEME_OPTIMIZER_INLINE_SIZE) return 0;
+
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+
+    // Identifiers are looked up from where the body is inlined, so they
+    // must not be captured there.
+    if (tag == SCHEME_ELEMENT_TAG_SYMBOL)
+        return element != (scheme_element *)name && !_is_shadowed(optimizer, (scheme_symbol *)element);
+
+    // Variables of enclosing procedures are out of reach.
+    if (tag == SCHEME_ELEMENT_TAG_REFERENCE)
+    {
+        int slot = scheme_reference_get_slot((scheme_reference *)element);
+        if (scheme_reference_get_depth((scheme_reference *)element) != 0 || slot >= arity)
+            return 0;
+
+        uses[slot] += *effects ? 2 : weight;
+        return 1;
+    }
+
+    if (tag != SCHEME_ELEMENT_TAG_PAIR || scheme_pair_is_empty((scheme_pair *)element))
+        return 1;
+
+    if (!scheme_pair_is_list((scheme_pair *)element))
+        return 0;
+
+    switch (scheme_evaluator_get_special_form((scheme_pair *)element))
+    {
+        case SCHEME_FORM_QUOTE:
+            return 1;
+
+        case SCHEME_FORM_LAMBDA:
+        case SCHEME_FORM_DEFINE:
+        case SCHEME_FORM_LET:
+            return 0;
+
+        case SCHEME_FORM_IF:
+        case SCHEME_FORM_COND:
+            weight = 2;
+            break;
+    }
+
+    scheme_element *first = scheme_pair_get_first((scheme_pair *)element);
+    for (scheme_element *rest = element; !scheme_pair_is_empty((scheme_pair *)rest); rest = scheme_pair_get_second((scheme_pair *)rest))
+    {
+        if (!_is_inlinable(optimizer, scheme_pair_get_first((scheme_pair *)rest), name, arity, uses, weight, effects, size))
+            return 0;
+    }
+
+    // The procedure is called once its arguments are evaluated.
+    scheme_element *procedure = NULL;
+    if (scheme_element_get_tag(first) == SCHEME_ELEMENT_TAG_SYMBOL)
+        procedure = scheme_namespace_lookup_ref(optimizer->namespace, (scheme_symbol *)first);
+
+    if (procedure == NULL
+        || scheme_element_get_tag(procedure) != SCHEME_ELEMENT_TAG_PROCEDURE
+        || !scheme_procedure_is_pure((scheme_procedure *)procedure))
+        *effects = 1;
+
+    return 1;
+}
+
+static scheme_element *_substitute(scheme_element *element, scheme_element **arguments)
+{
+    if (scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_REFERENCE)
+        return scheme_element_copy(arguments[scheme_reference_get_slot((scheme_reference *)element)]);
+
+    if (!scheme_element_is_pair(element)
+        || scheme_pair_is_empty((scheme_pair *)element)
+        || scheme_evaluator_get_special_form((scheme_pair *)element) == SCHEME_FORM_QUOTE)
+        return scheme_element_copy(element);
+
+    scheme_element *first = _substitute(scheme_pair_get_first((scheme_pair *)element), arguments);
+    if (first == NULL) return NULL;
+
+    return _rebuild((scheme_pair *)element, first, _substitute(scheme_pair_get_second((scheme_pair *)element), arguments));
+}
+
+static scheme_element *_inline_call(struct _optimizer *optimizer, scheme_element *expression)
+{
+    if (optimizer->inlining || scheme_symbol_get_builtin(_symbol_if) == NULL)
+        return expression;
+
+    // Procedure must be a lambda procedure created in the namespace, named
+    // by an identifier that is not shadowed, whose body is one expression.
+    scheme_element *first = scheme_pair_get_first((scheme_pair *)expression);
+    if (scheme_element_get_tag(first) != SCHEME_ELEMENT_TAG_SYMBOL || _is_shadowed(optimizer, (scheme_symbol *)first))
+        return expression;
+
+    scheme_element *procedure = scheme_namespace_lookup_ref(optimizer->namespace, (scheme_symbol *)first);
+    if (procedure == NULL
+        || scheme_element_get_tag(procedure) != SCHEME_ELEMENT_TAG_LAMBDA
+        || scheme_lambda_get_environment((scheme_lambda *)procedure) != optimizer->namespace)
+        return expression;
+
+    int expressionCount;
+    scheme_element **expressions = scheme_lambda_get_expressions((scheme_lambda *)procedure, &expressionCount);
+    int arity = scheme_lambda_get_fixed_argument_count((scheme_lambda *)procedure);
+    if (expressionCount != 1 || arity < 0)
+        return expression;
+
+    int count;
+    scheme_element **arguments = scheme_list_to_array((scheme_pair *)scheme_pair_get_second((scheme_pair *)expression), &count);
+    int *uses = calloc(arity + 1, sizeof(int));
+    int effects = 0;
+    int size = 0;
+    if (arguments == NULL || uses == NULL || count != arity
+        || !_is_inlinable(optimizer, expressions[0], (scheme_symbol *)first, arity, uses, 1, &effects, &size))
+    {
+        free(arguments);
+        free(uses);
+        return expression;
+    }
+
+    // Arguments are substituted where the body uses them, so they must
+    // evaluate to the same element every time without side effects:
+    // constants, variable references and defined identifiers. One other
+    // argument may be substituted where the body evaluates it exactly once
+    // before any side effect, which keeps the order of side effects.
+    int evaluatedOnce = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        enum scheme_element_tag tag = scheme_element_get_tag(arguments[i]);
+        if (tag == SCHEME_ELEMENT_TAG_REFERENCE || _constant_value(arguments[i]) != NULL)
+            continue;
+
+        if (tag == SCHEME_ELEMENT_TAG_SYMBOL
+            && !_is_shadowed(optimizer, (scheme_symbol *)arguments[i])
+            && scheme_namespace_lookup_ref(optimizer->namespace, (scheme_symbol *)arguments[i]) != NULL)
+            continue;
+
+        if (uses[i] == 1 && !evaluatedOnce
+            && _count_elements(arguments[i], SCHEME_OPTIMIZER_INLINE_SIZE + 1) <= SCHEME_OPTIMIZER_INLINE_SIZE)
+        {
+            evaluatedOnce = 1;
+            continue;
+        }
+
+        free(arguments);
+        free(uses);
+        return expression;
+    }
+
+    free(uses);
+
+    scheme_element *body = _substitute(expressions[0], arguments);
+    free(arguments);
+    if (body == NULL) return expression;
+
+    // Fold what the arguments made constant, without inlining any further.
+    optimizer->inlining = 1;
+    scheme_element *inlined = _optimize(optimizer, body);
+    optimizer->inlining = 0;
+    scheme_element_free(body);
+    if (inlined == NULL) return expression;
+
+    // (if (<guard> <identifier> <procedure>) <body> <call>)
+    scheme_element *guard[] = {(scheme_element *)&_guard_procedure, first, procedure};
+    scheme_element *condition = _list(guard, 3);
+    if (condition == NULL)
+    {
+        scheme_element_free(inlined);
+        return expression;
+    }
+
+    scheme_element *items[] = {(scheme_element *)_symbol_if, condition, inlined, expression};
+    scheme_element *result = _list(items, 4);
+    scheme_element_free(condition);
+    scheme_element_free(inlined);
+    if (result == NULL) return expression;
+
+    scheme_element_free(expression);
+
+    _report.inlinedCount += 1;
+    return result;
+}
+
+static scheme_element *_guard_function(scheme_procedure *procedure, scheme_element **arguments, int count)
+{
+    if (count != 2) return NULL;
+
+    if (arguments[0] == arguments[1])
+        return scheme_element_copy((scheme_element *)scheme_boolean_get_true());
+
+    return scheme_element_copy((scheme_element *)scheme_boolean_get_false());
+}
+
+static scheme_element *_list(scheme_element **elements, int count)
+{
+    scheme_element *list = scheme_element_copy((scheme_element *)scheme_pair_get_empty());
+    for (int i = count - 1; i >= 0 && list != NULL; --i)
+    {
+        scheme_element *pair = (scheme_element *)scheme_pair_new(elements[i], list);
+        scheme_element_free(list);
+        list = pair;
+    }
+
+    return list;
+}
+
+static scheme_element *_rebuild(scheme_pair *original, scheme_element *first, scheme_element *second)
+{
+    if (first == NULL || second == NULL)
+    {
+        scheme_element_free(first);
+        scheme_element_free(second);
+        return NULL;
+    }
+
+    scheme_element *result;
+    if (first == scheme_pair_get_first(original) && second == scheme_pair_get_second(original))
+        result = scheme_element_copy((scheme_element *)original);
+    else
+        result = (scheme_element *)scheme_pair_new(first, second);
+
+    scheme_element_free(first);
+    scheme_element_free(second);
+
+    return result;
+}
+
+/**** Public function implementations ****/
+
+scheme_element *scheme_optimize(scheme_element *expression, scheme_namespace *namespace)
+{
+    if (_symbol_define == NULL)
+    {
+        _symbol_define = scheme_symbol_new("define");
+        _symbol_quote = scheme_symbol_new("quote");
+        _symbol_if = scheme_symbol_new("if");
+
+        scheme_procedure_init_strict(&_guard_procedure, "inlined?", _guard_function);
+
+        scheme_element_vtable_clone(&_guard_vtable, _guard_procedure.super.vtable);
+        _guard_vtable.free = _guard_free;
+        _guard_procedure.super.vtable = &_guard_vtable;
+    }
+
+    struct _optimizer optimizer = {
+        .namespace = namespace,
+        .defined = NULL,
+        .definedCount = 0,
+        .definedSize = 0,
+        .bound = NULL,
+        .boundCount = 0,
+        .boundSize = 0,
+        .inlining = 0
+    };
+
+    scheme_element *result = NULL;
+    if (_collect_definitions(&optimizer, expression))
+        result = _optimize(&optimizer, expression);
+
+    free(optimizer.defined);
+    free(optimizer.bound);
+    return result;
+}
+
+void scheme_optimizer_print_report()
+{
+    fprintf(stderr, "Calls folded: %ld\n", _report.foldedCount);
+    fprintf(stderr, "Branches eliminated: %ld\n", _report.branchCount);
+    fprintf(stderr, "Call sites inlined: %ld\n", _report.inlinedCount);
+}
@@ -0,0 +1,42 @@
+/**
+ * Scheme expression optimizer.
+ *
+ * Rewrites a resolved expression before it is evaluated. Calls to pure
+ * built-in procedures whose arguments are all constants are replaced with
+ * their result, and "if" expressions whose condition is a constant are
+ * replaced with the branch that would be chosen. Calls to small lambda
+ * procedures defined in the namespace are replaced with their body, with
+ * the arguments substituted for the variables, behind a check that the
+ * identifier still refers to the same procedure.
+ *
+ * An identifier is assumed to keep referring to the procedure it refers to
+ * when the expression is optimized, unless the expression itself defines
+ * it. Procedures created by the expression are optimized too, so calls in
+ * their body are folded even if the identifier is redefined later.
+ */
+
+#ifndef __SCHEME_OPTIMIZER_H__
+#define __SCHEME_OPTIMIZER_H__
+
+#include "scheme-data-types.h"
+
+/**
+ * Optimize a top-level Scheme expression.
+ *
+ * Returned element must be freed with scheme_element_free(). Parts of the
+ * expression that are left as is are shared with it.
+ *
+ * @param  expression  A resolved Scheme expression.
+ * @param  namespace   Namespace the expression will be evaluated in.
+ *
+ * @return Optimized expression, or NULL if out of memory.
+ */
+scheme_element *scheme_optimize(scheme_element *expression, scheme_namespace *namespace);
+
+/**
+ * Print the number of calls folded, branches eliminated and call sites
+ * inlined so far to stderr.
+ */
+void scheme_optimizer_print_report();
+
+#endif
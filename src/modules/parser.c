@@ -63,7 +63,10 @@ static scheme_element *_scheme_expression(scheme_file *file, char *token, scheme
         scheme_element *element = _scheme_expression(file, nextToken, nextType, err);
         free(nextToken);
 
-        return (scheme_element *)scheme_element_quote(element);
+        scheme_element *quotedElement = (scheme_element *)scheme_element_quote(element);
+        scheme_element_free(element);
+
+        return quotedElement;
     }
 
     if (type == SCHEME_TOKEN_TYPE_EMPTY_LIST)
@@ -0,0 +1,562 @@
+#include <stdlib.h>
+
+#include "resolver.h"
+
+// Initial capacity of a scope's arrays.
+#define SCHEME_RESOLVER_INITIAL_SIZE 8
+
+/*
+ * Scoping is lexical: the namespace of a lambda procedure being applied has
+ * the namespace the procedure was created in as its superset. Each scope
+ * below therefore sits exactly one namespace above the scope of the body
+ * it appears in:
+ *
+ *   - The body of a lambda procedure, or of a procedure created by "define",
+ *     is enclosed by the scope the procedure was created in.
+ *   - The body of a "let" is applied right away in the active namespace.
+ *   - The body of a named "let" is enclosed by a namespace holding only the
+ *     procedure's name, which is itself enclosed by the active scope.
+ *
+ * Variables outside every scope, such as those in the base namespace, are
+ * left as symbols and looked up by name.
+ *
+ * A variable can also be shadowed by "define", which adds items to the
+ * active namespace in an order only known at run time. Identifiers defined
+ * anywhere in a body are never resolved past its scope. They are replaced
+ * with dynamic references instead, looked up by name, so that they are not
+ * mistaken for special forms or global variables whose lookup may be cached.
+ * Only identifiers that no enclosing namespace can bind are left as symbols.
+ */
+
+// Variables bound by a lambda procedure or "let".
+struct _scope {
+    // Argument identifiers, in the order they are stored in the namespace.
+    scheme_symbol **slots;
+    int slotCount;
+    int slotSize;
+    // Identifiers the body may define.
+    scheme_symbol **defined;
+    int definedCount;
+    int definedSize;
+    // Enclosing scope, NULL if none.
+    struct _scope *parent;
+};
+
+/**** Private function declarations ****/
+
+/**
+ * Append a symbol to a growable array of symbols, unless it is already in
+ * the array.
+ *
+ * @param  array   Address of array.
+ * @param  count   Address of number of symbols in array.
+ * @param  size    Address of array's capacity.
+ * @param  symbol  A Scheme symbol.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _add_symbol(scheme_symbol ***array, int *count, int *size, scheme_symbol *symbol);
+
+/**
+ * Find a symbol in an array of symbols.
+ *
+ * @param  array   An array of symbols.
+ * @param  count   Number of symbols in array.
+ * @param  symbol  A Scheme symbol.
+ *
+ * @return Index of symbol, or -1 if not found.
+ */
+static int _find_symbol(scheme_symbol **array, int count, scheme_symbol *symbol);
+
+/**
+ * Set up a scope for a lambda procedure or "let".
+ *
+ * @param  scope      Scope to set up.
+ * @param  arguments  Argument identifiers, in any form accepted by
+ *                    scheme_lambda_new_from_elements().
+ * @param  body       List of expressions.
+ * @param  parent     Enclosing scope, or NULL.
+ *
+ * @return 1 on success, 0 if arguments are malformed or out of memory.
+ */
+static int _scope_init(struct _scope *scope, scheme_element *arguments, scheme_element *body, struct _scope *parent);
+
+/**
+ * Release arrays held by a scope.
+ *
+ * @param  scope  A scope.
+ */
+static void _scope_free_content(struct _scope *scope);
+
+/**
+ * Collect identifiers that may be defined when evaluating an element.
+ *
+ * @param  scope    Scope to add identifiers to.
+ * @param  element  A Scheme element.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _collect_definitions(struct _scope *scope, scheme_element *element);
+
+/**
+ * Find the variable a symbol refers to in a chain of scopes.
+ *
+ * @param  scope   Innermost scope, or NULL.
+ * @param  symbol  A Scheme symbol.
+ * @param  depth   Set to the variable's depth if found, or to
+ *                 SCHEME_REFERENCE_DYNAMIC if a body may define it.
+ * @param  slot    Set to the variable's slot if found.
+ *
+ * @return 1 if found or a body may define it, 0 otherwise.
+ */
+static int _lookup(struct _scope *scope, scheme_symbol *symbol, int *depth, int *slot);
+
+/**
+ * Resolve variable references in an expression.
+ *
+ * @param  element  A Scheme element.
+ * @param  scope    Innermost scope, or NULL.
+ *
+ * @return Resolved element, or NULL if out of memory.
+ */
+static scheme_element *_resolve(scheme_element *element, struct _scope *scope);
+
+/**
+ * Resolve variable references in every element of a list. An improper
+ * tail is resolved as well.
+ *
+ * @param  list   A Scheme element.
+ * @param  scope  Innermost scope, or NULL.
+ *
+ * @return Resolved list, or NULL if out of memory.
+ */
+static scheme_element *_resolve_list(scheme_element *list, struct _scope *scope);
+
+/**
+ * Resolve the body of a lambda procedure or "let".
+ *
+ * @param  arguments  Argument identifiers.
+ * @param  body       List of expressions.
+ * @param  parent     Enclosing scope, or NULL.
+ *
+ * @return Resolved body, or NULL if out of memory.
+ */
+static scheme_element *_resolve_body(scheme_element *arguments, scheme_element *body, struct _scope *parent);
+
+/**
+ * Resolve the clauses of "cond", leaving "else" in place.
+ *
+ * @param  clauses  A list of clauses.
+ * @param  scope    Innermost scope, or NULL.
+ *
+ * @return Resolved clauses, or NULL if out of memory.
+ */
+static scheme_element *_resolve_clauses(scheme_element *clauses, struct _scope *scope);
+
+/**
+ * Create a pair unless it would be equal to an existing one.
+ *
+ * @param  original  Existing pair.
+ * @param  first     Resolved first element, whose reference is taken over.
+ * @param  second    Resolved second element, whose reference is taken over.
+ *
+ * @return A pair, or NULL if out of memory.
+ */
+static scheme_element *_rebuild(scheme_pair *original, scheme_element *first, scheme_element *second);
+
+/**** Private variables ****/
+
+static scheme_symbol *_symbol_quote = NULL;
+static scheme_symbol *_symbol_lambda = NULL;
+static scheme_symbol *_symbol_define = NULL;
+static scheme_symbol *_symbol_let = NULL;
+static scheme_symbol *_symbol_cond = NULL;
+static scheme_symbol *_symbol_else = NULL;
+
+/**** Private function implementations ****/
+
+static int _add_symbol(scheme_symbol ***array, int *count, int *size, scheme_symbol *symbol)
+{
+    if (_find_symbol(*array, *count, symbol) >= 0) return 1;
+
+    if (*count >= *size)
+    {
+        int newSize = *size > 0 ? *size * 2 : SCHEME_RESOLVER_INITIAL_SIZE;
+        scheme_symbol **newArray = realloc(*array, sizeof(scheme_symbol *) * newSize);
+        if (newArray == NULL) return 0;
+
+        *array = newArray;
+        *size = newSize;
+    }
+
+    (*array)[(*count)++] = symbol;
+    return 1;
+}
+
+static int _find_symbol(scheme_symbol **array, int count, scheme_symbol *symbol)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (array[i] == symbol)
+            return i;
+    }
+
+    return -1;
+}
+
+static int _scope_init(struct _scope *scope, scheme_element *arguments, scheme_element *body, struct _scope *parent)
+{
+    scope->slots = NULL;
+    scope->slotCount = 0;
+    scope->slotSize = 0;
+    scope->defined = NULL;
+    scope->definedCount = 0;
+    scope->definedSize = 0;
+    scope->parent = parent;
+
+    // Arguments are stored in order, then the rest ID.
+    scheme_element *argument = arguments;
+    while (scheme_element_is_pair(argument) && !scheme_pair_is_empty((scheme_pair *)argument))
+    {
+        scheme_element *id = scheme_pair_get_first((scheme_pair *)argument);
+
+        // Argument with a default value.
+        if (scheme_element_is_pair(id) && !scheme_pair_is_empty((scheme_pair *)id))
+            id = scheme_pair_get_first((scheme_pair *)id);
+
+        if (!scheme_element_is_symbol(id))
+        {
+            _scope_free_content(scope);
+            return 0;
+        }
+
+        if (!_add_symbol(&scope->slots, &scope->slotCount, &scope->slotSize, (scheme_symbol *)id))
+        {
+            _scope_free_content(scope);
+            return 0;
+        }
+
+        argument = scheme_pair_get_second((scheme_pair *)argument);
+    }
+
+    if (scheme_element_is_symbol(argument))
+    {
+        if (!_add_symbol(&scope->slots, &scope->slotCount, &scope->slotSize, (scheme_symbol *)argument))
+        {
+            _scope_free_content(scope);
+            return 0;
+        }
+    }
+    else if (!scheme_element_is_pair(argument))
+    {
+        _scope_free_content(scope);
+        return 0;
+    }
+
+    if (!_collect_definitions(scope, body))
+    {
+        _scope_free_content(scope);
+        return 0;
+    }
+
+    return 1;
+}
+
+static void _scope_free_content(struct _scope *scope)
+{
+    free(scope->slots);
+    free(scope->defined);
+}
+
+static int _collect_definitions(struct _scope *scope, scheme_element *element)
+{
+    if (!scheme_element_is_pair(element) || scheme_pair_is_empty((scheme_pair *)element))
+        return 1;
+
+    scheme_element *first = scheme_pair_get_first((scheme_pair *)element);
+    scheme_element *second = scheme_pair_get_second((scheme_pair *)element);
+
+    if (first == (scheme_element *)_symbol_quote)
+        return 1;
+
+    if (first == (scheme_element *)_symbol_define
+        && scheme_element_is_pair(second)
+        && !scheme_pair_is_empty((scheme_pair *)second))
+    {
+        // Either (define <identifier> ...) or (define (<identifier> ...) ...).
+        scheme_element *target = scheme_pair_get_first((scheme_pair *)second);
+        if (scheme_element_is_pair(target) && !scheme_pair_is_empty((scheme_pair *)target))
+            target = scheme_pair_get_first((scheme_pair *)target);
+
+        if (scheme_element_is_symbol(target)
+            && !_add_symbol(&scope->defined, &scope->definedCount, &scope->definedSize, (scheme_symbol *)target))
+            return 0;
+    }
+
+    // Look for definitions in every element of the list.
+    while (scheme_element_is_pair(element) && !scheme_pair_is_empty((scheme_pair *)element))
+    {
+        if (!_collect_definitions(scope, scheme_pair_get_first((scheme_pair *)element)))
+            return 0;
+
+        element = scheme_pair_get_second((scheme_pair *)element);
+    }
+
+    return 1;
+}
+
+static int _lookup(struct _scope *scope, scheme_symbol *symbol, int *depth, int *slot)
+{
+    for (int i = 0; scope != NULL; ++i, scope = scope->parent)
+    {
+        int index = _find_symbol(scope->slots, scope->slotCount, symbol);
+        if (index >= 0)
+        {
+            *depth = i;
+            *slot = index;
+            return 1;
+        }
+
+        // Symbol may be defined in this scope at run time.
+        if (_find_symbol(scope->defined, scope->definedCount, symbol) >= 0)
+        {
+            *depth = SCHEME_REFERENCE_DYNAMIC;
+            *slot = -1;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static scheme_element *_resolve(scheme_element *element, struct _scope *scope)
+{
+    if (scheme_element_is_symbol(element))
+    {
+        int depth, slot;
+        if (_lookup(scope, (scheme_symbol *)element, &depth, &slot))
+            return (scheme_element *)scheme_reference_new((scheme_symbol *)element, depth, slot);
+
+        return scheme_element_copy(element);
+    }
+
+    if (!scheme_element_is_pair(element) || scheme_pair_is_empty((scheme_pair *)element))
+        return scheme_element_copy(element);
+
+    scheme_pair *pair = (scheme_pair *)element;
+    scheme_element *first = scheme_pair_get_first(pair);
+    scheme_element *rest = scheme_pair_get_second(pair);
+
+    // Special forms only apply if their identifier is not a variable, and
+    // cannot be defined as one by an enclosing body.
+    int depth, slot;
+    if (!scheme_element_is_symbol(first)
+        || _lookup(scope, (scheme_symbol *)first, &depth, &slot)
+        || !scheme_element_is_pair(rest)
+        || scheme_pair_is_empty((scheme_pair *)rest))
+    {
+        return _resolve_list(element, scope);
+    }
+
+    scheme_element *second = scheme_pair_get_first((scheme_pair *)rest);
+    scheme_element *body = scheme_pair_get_second((scheme_pair *)rest);
+
+    if (first == (scheme_element *)_symbol_quote)
+    {
+        return scheme_element_copy(element);
+    }
+    else if (first == (scheme_element *)_symbol_lambda)
+    {
+        // (lambda <arguments> <expression> ...)
+        scheme_element *resolvedBody = _resolve_body(second, body, scope);
+        if (resolvedBody == NULL) return NULL;
+
+        scheme_element *resolvedRest = _rebuild((scheme_pair *)rest, scheme_element_copy(second), resolvedBody);
+        if (resolvedRest == NULL) return NULL;
+
+        return _rebuild(pair, scheme_element_copy(first), resolvedRest);
+    }
+    else if (first == (scheme_element *)_symbol_define
+             && scheme_element_is_pair(second)
+             && !scheme_pair_is_empty((scheme_pair *)second))
+    {
+        // (define (<identifier> <arguments> ...) <expression> ...)
+        scheme_element *arguments = scheme_pair_get_second((scheme_pair *)second);
+        scheme_element *resolvedBody = _resolve_body(arguments, body, scope);
+        if (resolvedBody == NULL) return NULL;
+
+        scheme_element *resolvedRest = _rebuild((scheme_pair *)rest, scheme_element_copy(second), resolvedBody);
+        if (resolvedRest == NULL) return NULL;
+
+        return _rebuild(pair, scheme_element_copy(first), resolvedRest);
+    }
+    else if (first == (scheme_element *)_symbol_define)
+    {
+        // (define <identifier> <expression>)
+        scheme_element *resolvedBody = _resolve_list(body, scope);
+        if (resolvedBody == NULL) return NULL;
+
+        scheme_element *resolvedRest = _rebuild((scheme_pair *)rest, scheme_element_copy(second), resolvedBody);
+        if (resolvedRest == NULL) return NULL;
+
+        return _rebuild(pair, scheme_element_copy(first), resolvedRest);
+    }
+    else if (first == (scheme_element *)_symbol_let && scheme_element_is_pair(second))
+    {
+        // (let (<binding> ...) <expression> ...)
+        scheme_element *resolvedBody = _resolve_body(second, body, scope);
+        if (resolvedBody == NULL) return NULL;
+
+        scheme_element *resolvedRest = _rebuild((scheme_pair *)rest, scheme_element_copy(second), resolvedBody);
+        if (resolvedRest == NULL) return NULL;
+
+        return _rebuild(pair, scheme_element_copy(first), resolvedRest);
+    }
+    else if (first == (scheme_element *)_symbol_let
+             && scheme_element_is_symbol(second)
+             && scheme_element_is_pair(body)
+             && !scheme_pair_is_empty((scheme_pair *)body))
+    {
+        // (let <identifier> (<binding> ...) <expression> ...)
+        scheme_element *bindings = scheme_pair_get_first((scheme_pair *)body);
+        scheme_element *expressions = scheme_pair_get_second((scheme_pair *)body);
+
+        // Namespace holding the procedure's name.
+        scheme_symbol *name = (scheme_symbol *)second;
+        struct _scope nameScope = {
+            .slots = &name,
+            .slotCount = 1,
+            .slotSize = 1,
+            .defined = NULL,
+            .definedCount = 0,
+            .definedSize = 0,
+            .parent = scope
+        };
+
+        scheme_element *resolvedExpressions = _resolve_body(bindings, expressions, &nameScope);
+        if (resolvedExpressions == NULL) return NULL;
+
+        scheme_element *resolvedBody = _rebuild((scheme_pair *)body, scheme_element_copy(bindings), resolvedExpressions);
+        if (resolvedBody == NULL) return NULL;
+
+        scheme_element *resolvedRest = _rebuild((scheme_pair *)rest, scheme_element_copy(second), resolvedBody);
+        if (resolvedRest == NULL) return NULL;
+
+        return _rebuild(pair, scheme_element_copy(first), resolvedRest);
+    }
+    else if (first == (scheme_element *)_symbol_cond)
+    {
+        // (cond (<condition> <expression> ...) ...)
+        scheme_element *resolvedRest = _resolve_clauses(rest, scope);
+        if (resolvedRest == NULL) return NULL;
+
+        return _rebuild(pair, scheme_element_copy(first), resolvedRest);
+    }
+
+    return _resolve_list(element, scope);
+}
+
+static scheme_element *_resolve_list(scheme_element *list, struct _scope *scope)
+{
+    if (!scheme_element_is_pair(list))
+        return _resolve(list, scope);
+
+    if (scheme_pair_is_empty((scheme_pair *)list))
+        return scheme_element_copy(list);
+
+    scheme_element *first = _resolve(scheme_pair_get_first((scheme_pair *)list), scope);
+    if (first == NULL) return NULL;
+
+    scheme_element *second = _resolve_list(scheme_pair_get_second((scheme_pair *)list), scope);
+    if (second == NULL)
+    {
+        scheme_element_free(first);
+        return NULL;
+    }
+
+    return _rebuild((scheme_pair *)list, first, second);
+}
+
+static scheme_element *_resolve_body(scheme_element *arguments, scheme_element *body, struct _scope *parent)
+{
+    // Leave malformed procedures for the evaluator to reject.
+    struct _scope scope;
+    if (!_scope_init(&scope, arguments, body, parent))
+        return scheme_element_copy(body);
+
+    scheme_element *result = _resolve_list(body, &scope);
+    _scope_free_content(&scope);
+
+    return result;
+}
+
+static scheme_element *_resolve_clauses(scheme_element *clauses, struct _scope *scope)
+{
+    if (!scheme_element_is_pair(clauses) || scheme_pair_is_empty((scheme_pair *)clauses))
+        return scheme_element_copy(clauses);
+
+    scheme_element *clause = scheme_pair_get_first((scheme_pair *)clauses);
+    scheme_element *resolvedClause;
+    if (scheme_element_is_pair(clause)
+        && !scheme_pair_is_empty((scheme_pair *)clause)
+        && scheme_pair_get_first((scheme_pair *)clause) == (scheme_element *)_symbol_else)
+    {
+        scheme_element *expressions = _resolve_list(scheme_pair_get_second((scheme_pair *)clause), scope);
+        if (expressions == NULL) return NULL;
+
+        resolvedClause = _rebuild((scheme_pair *)clause, scheme_element_copy((scheme_element *)_symbol_else), expressions);
+    }
+    else
+    {
+        resolvedClause = _resolve_list(clause, scope);
+    }
+
+    if (resolvedClause == NULL) return NULL;
+
+    scheme_element *rest = _resolve_clauses(scheme_pair_get_second((scheme_pair *)clauses), scope);
+    if (rest == NULL)
+    {
+        scheme_element_free(resolvedClause);
+        return NULL;
+    }
+
+    return _rebuild((scheme_pair *)clauses, resolvedClause, rest);
+}
+
+static scheme_element *_rebuild(scheme_pair *original, scheme_element *first, scheme_element *second)
+{
+    if (first == NULL || second == NULL)
+    {
+        scheme_element_free(first);
+        scheme_element_free(second);
+        return NULL;
+    }
+
+    scheme_element *result;
+    if (first == scheme_pair_get_first(original) && second == scheme_pair_get_second(original))
+        result = scheme_element_copy((scheme_element *)original);
+    else
+        result = (scheme_element *)scheme_pair_new(first, second);
+
+    scheme_element_free(first);
+    scheme_element_free(second);
+
+    return result;
+}
+
+/**** Public function implementations ****/
+
+scheme_element *scheme_resolve(scheme_element *expression)
+{
+    if (_symbol_quote == NULL)
+    {
+        _symbol_quote = scheme_symbol_new("quote");
+        _symbol_lambda = scheme_symbol_new("lambda");
+        _symbol_define = scheme_symbol_new("define");
+        _symbol_let = scheme_symbol_new("let");
+        _symbol_cond = scheme_symbol_new("cond");
+        _symbol_else = scheme_symbol_new("else");
+    }
+
+    return _resolve(expression, NULL);
+}
@@ -0,0 +1,26 @@
+/**
+ * Scheme variable resolver.
+ *
+ * Rewrites a parsed expression so that references to variables bound by an
+ * enclosing lambda procedure or "let" are replaced with Scheme variable
+ * references, which the evaluator looks up by slot instead of by name.
+ */
+
+#ifndef __SCHEME_RESOLVER_H__
+#define __SCHEME_RESOLVER_H__
+
+#include "scheme-data-types.h"
+
+/**
+ * Resolve variable references in a top-level Scheme expression.
+ *
+ * Returned element must be freed with scheme_element_free(). Parts of the
+ * expression that contain nothing to resolve are shared with it.
+ *
+ * @param  expression  A Scheme expression.
+ *
+ * @return Resolved expression, or NULL if out of memory.
+ */
+scheme_element *scheme_resolve(scheme_element *expression);
+
+#endif
@@ -8,7 +8,7 @@ int scheme_pair_is_list(scheme_pair *list)
     while (1)
     {
         // Element must be a pair.
-        if (!scheme_element_is_type((scheme_element *)list, scheme_pair_get_type()))
+        if (!scheme_element_is_pair((scheme_element *)list))
             return 0;
 
         // If we have reached the empty pair, then element is a list.
@@ -22,7 +22,7 @@ int scheme_pair_is_list(scheme_pair *list)
 scheme_element **scheme_list_to_array(scheme_pair *list, int *count)
 {
     // Element must be a pair.
-    if (!scheme_element_is_type((scheme_element *)list, scheme_pair_get_type()))
+    if (!scheme_element_is_pair((scheme_element *)list))
     {
         if (count != NULL) *count = -1;
         return NULL;
@@ -43,7 +43,7 @@ scheme_element **scheme_list_to_array(scheme_pair *list, int *count)
         ++argCount;
 
         rest = scheme_pair_get_second((scheme_pair *)rest);
-        if (!scheme_element_is_type(rest, scheme_pair_get_type()))
+        if (!scheme_element_is_pair(rest))
         {
             // Not a list.
             if (count != NULL) *count = -1;
@@ -73,7 +73,7 @@ scheme_element **scheme_list_to_array(scheme_pair *list, int *count)
 
 scheme_pair *scheme_list_evaluated(scheme_pair *list, scheme_namespace *namespace)
 {
-    if (!scheme_element_is_type((scheme_element *)list, scheme_pair_get_type()))
+    if (!scheme_element_is_pair((scheme_element *)list))
     {
         return NULL;
     }
@@ -90,7 +90,7 @@ scheme_pair *scheme_list_evaluated(scheme_pair *list, scheme_namespace *namespac
 
     // Evaluate second element.
     scheme_element *evaluatedSecond = scheme_pair_get_second(list);
-    if (scheme_element_is_type(evaluatedSecond, scheme_pair_get_type()))
+    if (scheme_element_is_pair(evaluatedSecond))
     {
         // Second element is a list. Evaluate list recursively.
         evaluatedSecond = (scheme_element *)scheme_list_evaluated((scheme_pair *)evaluatedSecond, namespace);
@@ -128,6 +128,7 @@ scheme_pair *scheme_element_quote(scheme_element *element)
     scheme_pair *quotedElement = scheme_pair_new((scheme_element *)quoteSymbol, (scheme_element *)listedElement);
 
     scheme_element_free((scheme_element *)listedElement);
+    scheme_element_free((scheme_element *)quoteSymbol);
 
     return quotedElement;
 }
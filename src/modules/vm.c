@@ -0,0 +1,508 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vm.h"
+#include "eval.h"
+#include "compiler.h"
+
+// Initial capacity of the value and frame stacks.
+#define SCHEME_VM_INITIAL_SIZE 64
+
+// Procedure being executed.
+struct _frame {
+    scheme_bytecode *bytecode;
+    int position;
+    // Active namespace.
+    scheme_namespace *namespace;
+    // Lambda procedure being applied, which holds the bytecode and whose
+    // local namespace is the active namespace. NULL for a top-level
+    // expression, whose bytecode and namespace belong to the caller.
+    scheme_lambda *procedure;
+    // Number of values on the stack when the procedure was entered.
+    int base;
+};
+
+// State of the virtual machine.
+struct _machine {
+    scheme_element **stack;
+    int stackCount;
+    int stackSize;
+    struct _frame *frames;
+    int frameCount;
+    int frameSize;
+};
+
+// Usage of the stacks across every execution.
+struct _stats {
+    // Largest number of frames at once.
+    int maxFrameCount;
+    // Largest number of values at once.
+    int maxValueCount;
+    // Number of executions stopped by the frame limit.
+    long overflowCount;
+};
+
+/**** Private function declarations ****/
+
+/**
+ * Push a value onto the stack, taking over the caller's reference.
+ *
+ * @param  machine  Virtual machine.
+ * @param  element  A Scheme element, may be NULL.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _push(struct _machine *machine, scheme_element *element);
+
+/**
+ * Release values on top of the stack.
+ *
+ * @param  machine  Virtual machine.
+ * @param  count    Number of values.
+ */
+static void _drop(struct _machine *machine, int count);
+
+/**
+ * Enter a procedure.
+ *
+ * @param  machine    Virtual machine.
+ * @param  bytecode   Bytecode to execute.
+ * @param  namespace  Active namespace.
+ * @param  procedure  Lambda procedure being applied, whose reference the
+ *                    frame takes over, or NULL.
+ *
+ * @return 1 on success, 0 if out of memory or if the frame limit is
+ *         reached.
+ */
+static int _push_frame(struct _machine *machine,
+                       scheme_bytecode *bytecode,
+                       scheme_namespace *namespace,
+                       scheme_lambda *procedure);
+
+/**
+ * Release the namespace and procedure held by a frame.
+ *
+ * @param  frame  A frame.
+ */
+static void _release_frame(struct _frame *frame);
+
+/**
+ * Get a lambda procedure's bytecode, compiling it if needed.
+ *
+ * @param  lambda     A lambda procedure.
+ * @param  namespace  Active namespace.
+ *
+ * @return Bytecode held by the procedure, or NULL if out of memory.
+ */
+static scheme_bytecode *_procedure_bytecode(scheme_lambda *lambda, scheme_namespace *namespace);
+
+/**
+ * Execute instructions until the outermost frame returns.
+ *
+ * @param  machine  Virtual machine with one frame.
+ *
+ * @return Result, or NULL if an error occurs.
+ */
+static scheme_element *_run(struct _machine *machine);
+
+/**** Private variables ****/
+
+// Maximum number of frames, or 0 for no limit other than memory.
+static int _maxFrameCount = 0;
+
+static struct _stats _stats = {
+    .maxFrameCount = 0,
+    .maxValueCount = 0,
+    .overflowCount = 0
+};
+
+/**** Private function implementations ****/
+
+static int _push(struct _machine *machine, scheme_element *element)
+{
+    // Ensure we have enough space.
+    if (machine->stackCount >= machine->stackSize)
+    {
+        int newSize = machine->stackSize > 0 ? machine->stackSize * 2 : SCHEME_VM_INITIAL_SIZE;
+        scheme_element **newStack = realloc(machine->stack, sizeof(scheme_element *) * newSize);
+        if (newStack == NULL)
+        {
+            scheme_element_free(element);
+            return 0;
+        }
+
+        machine->stack = newStack;
+        machine->stackSize = newSize;
+    }
+
+    machine->stack[machine->stackCount++] = element;
+    if (machine->stackCount > _stats.maxValueCount)
+        _stats.maxValueCount = machine->stackCount;
+
+    return 1;
+}
+
+static void _drop(struct _machine *machine, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        scheme_element_free(machine->stack[--machine->stackCount]);
+    }
+}
+
+static int _push_frame(struct _machine *machine,
+                       scheme_bytecode *bytecode,
+                       scheme_namespace *namespace,
+                       scheme_lambda *procedure)
+{
+    if (_maxFrameCount > 0 && machine->frameCount >= _maxFrameCount)
+    {
+        fprintf(stderr, "Stack limit of %d frames reached.\n", _maxFrameCount);
+        _stats.overflowCount += 1;
+        return 0;
+    }
+
+    // Ensure we have enough space.
+    if (machine->frameCount >= machine->frameSize)
+    {
+        int newSize = machine->frameSize > 0 ? machine->frameSize * 2 : SCHEME_VM_INITIAL_SIZE;
+        struct _frame *newFrames = realloc(machine->frames, sizeof(struct _frame) * newSize);
+        if (newFrames == NULL) return 0;
+
+        machine->frames = newFrames;
+        machine->frameSize = newSize;
+    }
+
+    struct _frame *frame = machine->frames + machine->frameCount++;
+    frame->bytecode = bytecode;
+    frame->position = 0;
+    frame->namespace = namespace;
+    frame->procedure = procedure;
+    frame->base = machine->stackCount;
+
+    if (machine->frameCount > _stats.maxFrameCount)
+        _stats.maxFrameCount = machine->frameCount;
+
+    return 1;
+}
+
+static void _release_frame(struct _frame *frame)
+{
+    if (frame->procedure == NULL) return;
+
+    scheme_element_free((scheme_element *)frame->namespace);
+    scheme_element_free((scheme_element *)frame->procedure);
+}
+
+static scheme_bytecode *_procedure_bytecode(scheme_lambda *lambda, scheme_namespace *namespace)
+{
+    scheme_element *code = scheme_lambda_get_code(lambda);
+    if (code != NULL && scheme_element_get_tag(code) == SCHEME_ELEMENT_TAG_BYTECODE)
+        return (scheme_bytecode *)code;
+
+    // Lambda procedures created outside the virtual machine are compiled
+    // the first time it applies them.
+    scheme_bytecode *bytecode = scheme_compile_procedure(lambda, namespace);
+    if (bytecode == NULL) return NULL;
+
+    scheme_lambda_set_code(lambda, (scheme_element *)bytecode);
+    scheme_element_free((scheme_element *)bytecode);
+
+    return bytecode;
+}
+
+static scheme_element *_run(struct _machine *machine)
+{
+    while (1)
+    {
+        struct _frame *frame = machine->frames + machine->frameCount - 1;
+        const int *words = scheme_bytecode_get_words(frame->bytecode);
+        scheme_element **constants = scheme_bytecode_get_constants(frame->bytecode);
+
+        switch (words[frame->position++])
+        {
+            case SCHEME_OP_CONSTANT:
+            {
+                scheme_element *constant = constants[words[frame->position++]];
+                if (!_push(machine, scheme_element_copy(constant))) return NULL;
+                break;
+            }
+
+            case SCHEME_OP_LOCAL:
+            {
+                scheme_reference *reference = (scheme_reference *)constants[words[frame->position++]];
+                scheme_element *element = scheme_reference_lookup_ref(reference, frame->namespace);
+                if (element == NULL) return NULL;
+                if (!_push(machine, scheme_element_copy(element))) return NULL;
+                break;
+            }
+
+            case SCHEME_OP_GLOBAL:
+            {
+                scheme_symbol *symbol = (scheme_symbol *)constants[words[frame->position++]];
+                scheme_element *element = scheme_namespace_lookup_ref(frame->namespace, symbol);
+                if (element == NULL) return NULL;
+                if (!_push(machine, scheme_element_copy(element))) return NULL;
+                break;
+            }
+
+            case SCHEME_OP_CALLEE:
+            {
+                scheme_symbol *symbol = (scheme_symbol *)constants[words[frame->position++]];
+                scheme_namespace_cache *cache = scheme_bytecode_get_caches(frame->bytecode) + words[frame->position++];
+                scheme_element *element = scheme_namespace_lookup_cached_ref(frame->namespace, symbol, cache);
+                if (element == NULL) return NULL;
+                if (!_push(machine, scheme_element_copy(element))) return NULL;
+                break;
+            }
+
+            case SCHEME_OP_DEFINE:
+            {
+                scheme_symbol *symbol = (scheme_symbol *)constants[words[frame->position++]];
+                scheme_namespace_set_symbol(frame->namespace, symbol, machine->stack[machine->stackCount - 1]);
+                break;
+            }
+
+            case SCHEME_OP_POP:
+            {
+                _drop(machine, 1);
+                break;
+            }
+
+            case SCHEME_OP_JUMP:
+            {
+                frame->position = words[frame->position];
+                break;
+            }
+
+            case SCHEME_OP_JUMP_IF_FALSE:
+            {
+                int target = words[frame->position++];
+                scheme_element *condition = machine->stack[machine->stackCount - 1];
+                if (scheme_element_compare(condition, (scheme_element *)scheme_boolean_get_false()))
+                    frame->position = target;
+
+                _drop(machine, 1);
+                break;
+            }
+
+            case SCHEME_OP_JUMP_IF_TRUE_OR_POP:
+            {
+                int target = words[frame->position++];
+                scheme_element *condition = machine->stack[machine->stackCount - 1];
+                if (scheme_element_compare(condition, (scheme_element *)scheme_boolean_get_false()))
+                    _drop(machine, 1);
+                else
+                    frame->position = target;
+
+                break;
+            }
+
+            case SCHEME_OP_JUMP_IF_IS_FALSE:
+            {
+                int target = words[frame->position++];
+                if (machine->stack[machine->stackCount - 1] == (scheme_element *)scheme_boolean_get_false())
+                    frame->position = target;
+
+                _drop(machine, 1);
+                break;
+            }
+
+            case SCHEME_OP_JUMP_IF_IS_NOT_FALSE_OR_POP:
+            {
+                int target = words[frame->position++];
+                if (machine->stack[machine->stackCount - 1] == (scheme_element *)scheme_boolean_get_false())
+                    _drop(machine, 1);
+                else
+                    frame->position = target;
+
+                break;
+            }
+
+            case SCHEME_OP_CLOSURE:
+            {
+                scheme_lambda *template = (scheme_lambda *)constants[words[frame->position++]];
+                scheme_lambda *closure = scheme_lambda_new_closure(template, frame->namespace);
+                if (closure == NULL) return NULL;
+                if (!_push(machine, (scheme_element *)closure)) return NULL;
+                break;
+            }
+
+            case SCHEME_OP_NAMED_CLOSURE:
+            {
+                scheme_lambda *template = (scheme_lambda *)constants[words[frame->position++]];
+                scheme_symbol *name = (scheme_symbol *)constants[words[frame->position++]];
+
+                // The namespace is kept alive by the procedure alone.
+                scheme_namespace *nameNamespace = scheme_namespace_new_frame(frame->namespace, 1);
+                if (nameNamespace == NULL) return NULL;
+
+                scheme_lambda *closure = scheme_lambda_new_closure(template, nameNamespace);
+                if (closure != NULL)
+                    scheme_namespace_bind_symbol(nameNamespace, name, (scheme_element *)closure);
+                scheme_element_free((scheme_element *)nameNamespace);
+
+                if (closure == NULL) return NULL;
+                if (!_push(machine, (scheme_element *)closure)) return NULL;
+                break;
+            }
+
+            case SCHEME_OP_SYNTAX:
+            {
+                scheme_element *arguments = constants[words[frame->position++]];
+                int target = words[frame->position++];
+
+                scheme_element *procedure = machine->stack[machine->stackCount - 1];
+                if (!scheme_evaluator_is_syntax(procedure)) break;
+
+                scheme_element *result = scheme_procedure_apply((scheme_procedure *)procedure, arguments, frame->namespace);
+                _drop(machine, 1);
+                if (result == NULL) return NULL;
+                if (!_push(machine, result)) return NULL;
+
+                frame->position = target;
+                break;
+            }
+
+            case SCHEME_OP_CALL:
+            case SCHEME_OP_TAIL_CALL:
+            {
+                int tail = words[frame->position - 1] == SCHEME_OP_TAIL_CALL;
+                int count = words[frame->position++];
+                scheme_element **arguments = machine->stack + machine->stackCount - count;
+                scheme_element *procedure = arguments[-1];
+
+                if (scheme_element_is_lambda(procedure))
+                {
+                    scheme_lambda *lambda = (scheme_lambda *)procedure;
+
+                    scheme_bytecode *bytecode = _procedure_bytecode(lambda, frame->namespace);
+                    if (bytecode == NULL) return NULL;
+
+                    scheme_namespace *localNamespace = scheme_lambda_bind(lambda, arguments, count, frame->namespace);
+                    if (localNamespace == NULL) return NULL;
+
+                    // The new frame takes over the reference to the procedure.
+                    _drop(machine, count);
+                    machine->stackCount -= 1;
+
+                    if (tail)
+                    {
+                        // Replace the procedure being executed.
+                        _release_frame(frame);
+                        frame->bytecode = bytecode;
+                        frame->position = 0;
+                        frame->namespace = localNamespace;
+                        frame->procedure = lambda;
+                    }
+                    else if (!_push_frame(machine, bytecode, localNamespace, lambda))
+                    {
+                        scheme_element_free((scheme_element *)localNamespace);
+                        scheme_element_free(procedure);
+                        return NULL;
+                    }
+                }
+                else if (scheme_element_is_procedure(procedure))
+                {
+                    scheme_element *result = scheme_procedure_apply_values((scheme_procedure *)procedure, arguments, count, frame->namespace);
+                    _drop(machine, count + 1);
+                    if (result == NULL) return NULL;
+                    if (!_push(machine, result)) return NULL;
+                }
+                else
+                {
+                    // Not a procedure.
+                    return NULL;
+                }
+
+                break;
+            }
+
+            case SCHEME_OP_RETURN:
+            {
+                scheme_element *result = machine->stack[--machine->stackCount];
+
+                _release_frame(frame);
+                machine->frameCount -= 1;
+
+                if (machine->frameCount == 0)
+                    return result;
+
+                if (!_push(machine, result)) return NULL;
+                break;
+            }
+
+            case SCHEME_OP_EVALUATE:
+            {
+                scheme_element *expression = constants[words[frame->position++]];
+                scheme_element *result = scheme_evaluate(expression, frame->namespace);
+                if (result == NULL) return NULL;
+                if (!_push(machine, result)) return NULL;
+                break;
+            }
+
+            default:
+                return NULL;
+        }
+    }
+}
+
+/**** Public function implementations ****/
+
+scheme_element *scheme_vm_evaluate(scheme_element *expression, scheme_namespace *namespace)
+{
+    scheme_bytecode *bytecode = scheme_compile(expression, namespace);
+    if (bytecode == NULL) return NULL;
+
+    scheme_element *result = scheme_vm_execute(bytecode, namespace);
+    scheme_element_free((scheme_element *)bytecode);
+
+    return result;
+}
+
+void scheme_vm_set_max_frame_count(int count)
+{
+    _maxFrameCount = count > 0 ? count : 0;
+}
+
+void scheme_vm_print_stats()
+{
+    if (_maxFrameCount > 0)
+        fprintf(stderr, "Frame limit: %d\n", _maxFrameCount);
+    else
+        fprintf(stderr, "Frame limit: none\n");
+
+    fprintf(stderr, "Most frames at once: %d (%lu bytes)\n",
+            _stats.maxFrameCount, (unsigned long)(sizeof(struct _frame) * _stats.maxFrameCount));
+    fprintf(stderr, "Most values at once: %d (%lu bytes)\n",
+            _stats.maxValueCount, (unsigned long)(sizeof(scheme_element *) * _stats.maxValueCount));
+    fprintf(stderr, "Executions past the frame limit: %ld\n", _stats.overflowCount);
+}
+
+scheme_element *scheme_vm_execute(scheme_bytecode *bytecode, scheme_namespace *namespace)
+{
+    struct _machine machine = {
+        .stack = NULL,
+        .stackCount = 0,
+        .stackSize = 0,
+        .frames = NULL,
+        .frameCount = 0,
+        .frameSize = 0
+    };
+
+    scheme_element *result = NULL;
+    if (_push_frame(&machine, bytecode, namespace, NULL))
+        result = _run(&machine);
+
+    // After an error, release whatever is left.
+    _drop(&machine, machine.stackCount);
+    for (int i = 0; i < machine.frameCount; ++i)
+    {
+        _release_frame(machine.frames + i);
+    }
+
+    free(machine.stack);
+    free(machine.frames);
+
+    return result;
+}
@@ -0,0 +1,57 @@
+/**
+ * Scheme virtual machine.
+ *
+ * Executes bytecode produced by the compiler. Calls between lambda
+ * procedures are executed in a loop with a stack of frames, instead of
+ * through recursive calls to scheme_evaluate(). Strict built-in procedures
+ * are given the arguments on top of the stack as an array, and other
+ * built-in procedures a list of already evaluated arguments, except for
+ * those that receive their arguments unevaluated.
+ *
+ * The frames and values live on the heap and grow as needed, so the depth
+ * of non-tail recursion is bounded by memory rather than by the C stack,
+ * or by a limit on the number of frames if one is set.
+ */
+
+#ifndef __SCHEME_VM_H__
+#define __SCHEME_VM_H__
+
+#include "scheme-data-types.h"
+#include "scheme-bytecode.h"
+
+/**
+ * Compile and execute a top-level Scheme expression.
+ * Returned element must be freed with scheme_element_free().
+ *
+ * @param  expression  A resolved Scheme expression.
+ * @param  namespace   Active namespace.
+ *
+ * @return Result, or NULL if expression could not be evaluated.
+ */
+scheme_element *scheme_vm_evaluate(scheme_element *expression, scheme_namespace *namespace);
+
+/**
+ * Execute bytecode.
+ * Returned element must be freed with scheme_element_free().
+ *
+ * @param  bytecode   Bytecode of a top-level expression.
+ * @param  namespace  Active namespace.
+ *
+ * @return Result, or NULL if bytecode could not be executed.
+ */
+scheme_element *scheme_vm_execute(scheme_bytecode *bytecode, scheme_namespace *namespace);
+
+/**
+ * Limit the number of frames of an execution. An execution that needs
+ * more frames stops with an error.
+ *
+ * @param  count  Maximum number of frames, or 0 for no limit.
+ */
+void scheme_vm_set_max_frame_count(int count);
+
+/**
+ * Print the largest sizes the stacks reached to stderr.
+ */
+void scheme_vm_print_stats();
+
+#endif
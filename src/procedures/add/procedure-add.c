@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "utils.h"
 #include "scheme-data-types.h"
 #include "scheme-procedure-init.h"
@@ -21,16 +20,16 @@ static int _proc_initd = 0;
  * Compute the sum of a list of numbers.
  *
  * Will return NULL if:
- * - Element is not a list in the format: (<number> ...).
+ * - Arguments are not in the format: (<number> ...).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Sum of numbers in the list or NULL if an error occurs.
  */
-static scheme_element *_add_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_add_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -42,53 +41,19 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_add_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_add_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Evaluate each argument.
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
-    {
-        return NULL;
-    }
-
-    // Get arguments.
-    int argCount;
-    scheme_element **arguments = scheme_list_to_array(evaluatedList, &argCount);
-
-    // Terminate if element is not a list.
-    if (argCount == -1)
-    {
-        return NULL;
-    }
-
-    // Return 0 if there is no argument.
-    if (argCount == 0)
-    {
-        return (scheme_element *)scheme_number_new(0);
-    }
-
-    // Verify that every argument is a number.
-    for (int i = 0; i < argCount; ++i)
+    // Compute sum of all numbers. Return 0 if there is no argument.
+    long sum = 0;
+    for (int i = 0; i < count; ++i)
     {
-        scheme_element *anArgument = arguments[i];
-
-        if (!scheme_element_is_type(anArgument, scheme_number_get_type()))
-        {
-            free(arguments);
-            scheme_element_free((scheme_element *)evaluatedList);
+        // Terminate if argument is not a number.
+        if (!scheme_element_is_number(arguments[i]))
             return NULL;
-        }
-    }
 
-    // Compute sum of all numbers.
-    long sum = 0;
-    for (int i = 0; i < argCount; ++i)
-    {
         sum += scheme_number_get_value((scheme_number *)arguments[i]);
     }
 
-    free(arguments);
-    scheme_element_free((scheme_element *)evaluatedList);
     return (scheme_element *)scheme_number_new(sum);
 }
 
@@ -98,7 +63,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_add, PROCEDURE_ADD_NAME, _add_function);
+        scheme_procedure_init_strict(&_procedure_add, PROCEDURE_ADD_NAME, _add_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_add.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -109,3 +74,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_add;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
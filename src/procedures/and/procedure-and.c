@@ -43,16 +43,9 @@ static void _procedure_free(scheme_element *element) {}
 
 static scheme_element *_and_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
 {
-    // Evaluate each argument.
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
-    {
-        return NULL;
-    }
-
     // Get arguments.
     int argCount;
-    scheme_element **arguments = scheme_list_to_array(evaluatedList, &argCount);
+    scheme_element **arguments = scheme_list_to_array((scheme_pair *)element, &argCount);
 
     // Terminate if element is not a list.
     if (argCount == -1)
@@ -66,22 +59,34 @@ static scheme_element *_and_function(scheme_procedure *procedure, scheme_element
         return (scheme_element *)scheme_boolean_get_true();
     }
 
-    // Go through each evaluated argument and return #f as soon as we find one.
+    // Evaluate each argument, and remember whether one of them evaluated to
+    // #f. The last one is not in tail position, since a result equal to #f,
+    // such as an empty list, is returned as #f itself.
+    int foundFalse = 0;
     for (int i = 0; i < argCount; ++i)
     {
-        if (scheme_element_compare(arguments[i], (scheme_element *)scheme_boolean_get_false()))
+        scheme_element *argument = scheme_evaluate(arguments[i], namespace);
+        if (argument == NULL)
+        {
+            free(arguments);
+            return NULL;
+        }
+
+        if (scheme_element_compare(argument, (scheme_element *)scheme_boolean_get_false()))
+            foundFalse = 1;
+
+        // No argument evaluated to #f. Return evaluated last argument.
+        if (i == argCount - 1 && !foundFalse)
         {
             free(arguments);
-            scheme_element_free((scheme_element *)evaluatedList);
-            return (scheme_element *)scheme_boolean_get_false();
+            return argument;
         }
+
+        scheme_element_free(argument);
     }
 
-    // No argument evaluated to #f. Return evaluated last argument.
-    scheme_element *last = scheme_element_copy(arguments[argCount - 1]);
     free(arguments);
-    scheme_element_free((scheme_element *)evaluatedList);
-    return last;
+    return (scheme_element *)scheme_boolean_get_false();
 }
 
 /**** Public function implementations ****/
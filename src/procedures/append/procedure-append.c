@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -23,17 +22,17 @@ static int _proc_initd = 0;
  * given list.
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format: (<list> <element>).
+ * - Arguments are not in the format: (<list> <element>).
  * - First argument is not a list, defined as either the empty pair or
  *   a pair whose second element is also a list.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return New list as described, or NULL if an error occurs.
  */
-static scheme_element *_append_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_append_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Create a copy of given list with element appended to the end.
@@ -59,47 +58,16 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_append_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_append_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)element, &argCount);
+    // Check number of arguments.
+    if (count != 2) return NULL;
 
-    // Check if argument list is invalid.
-    if (argCount == -1) return NULL;
-    else if (argCount != 2)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
-        return NULL;
-    }
-
-    scheme_element *firstArg = args[0];
-    scheme_element *secondArg = args[1];
-    free(args);
-
-    // Evaluate arguments.
-    firstArg = scheme_evaluate(firstArg, namespace);
-    secondArg = scheme_evaluate(secondArg, namespace);
-    if (firstArg == NULL || secondArg == NULL)
-    {
-        scheme_element_free(firstArg);
-        scheme_element_free(secondArg);
-        return NULL;
-    }
-
-    // First argument must resolve to a pair.
-    if (!scheme_element_is_type(firstArg, scheme_pair_get_type()))
-    {
-        scheme_element_free(firstArg);
-        scheme_element_free(secondArg);
+    // First argument must be a pair.
+    if (!scheme_element_is_pair(arguments[0]))
         return NULL;
-    }
 
-    scheme_element *newList = _append_list((scheme_pair *)firstArg, secondArg);
-    scheme_element_free(firstArg);
-    scheme_element_free(secondArg);
-    return newList;
+    return _append_list((scheme_pair *)arguments[0], arguments[1]);
 }
 
 static scheme_element *_append_list(scheme_pair *list, scheme_element *element)
@@ -110,7 +78,7 @@ static scheme_element *_append_list(scheme_pair *list, scheme_element *element)
 
     // Second element of list must be a pair.
     scheme_element *second = scheme_pair_get_second(list);
-    if (!scheme_element_is_type(second, scheme_pair_get_type()))
+    if (!scheme_element_is_pair(second))
         return NULL;
 
     // Append element onto second element of list.
@@ -131,7 +99,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_append, PROCEDURE_APPEND_NAME, _append_function);
+        scheme_procedure_init_strict(&_procedure_append, PROCEDURE_APPEND_NAME, _append_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_append.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -142,3 +110,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_append;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -22,18 +21,18 @@ static int _proc_initd = 0;
  * or #f if the given element does not associate with any pair in the list.
  *
  * Will return NULL if:
- * - Supplied element is not a list in the format: (<element> <list>).
+ * - Arguments are not in the format: (<element> <list>).
  * - An element in <list> is not in the format (<element> ...).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Associated pair as described, or #f if no pair is found, or NULL
  *         if an error occurs.
  */
-static scheme_element *_assoc_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_assoc_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -45,73 +44,35 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_assoc_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_assoc_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)element, &argCount);
+    // Check number of arguments.
+    if (count != 2) return NULL;
 
-    // Check if argument list is invalid.
-    if (argCount == -1) return NULL;
-    else if (argCount != 2)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
-        return NULL;
-    }
-
-    scheme_element *key = args[0];
-    scheme_element *list = args[1];
-    free(args);
+    scheme_element *key = arguments[0];
+    scheme_element *list = arguments[1];
 
-    // Evaluate arguments.
-    key = scheme_evaluate(key, namespace);
-    list = scheme_evaluate(list, namespace);
-    if (key == NULL || list == NULL)
+    // Go through each item in list.
+    while (scheme_element_is_pair(list) && !scheme_pair_is_empty((scheme_pair *)list))
     {
-        scheme_element_free(key);
-        scheme_element_free(list);
-        return NULL;
-    }
+        scheme_element *p = scheme_pair_get_first((scheme_pair *)list);
 
-    // Get items in list.
-    scheme_element **pairs = scheme_list_to_array((scheme_pair *)list, &argCount);
+        // Each item in list must be a pair.
+        if (!scheme_element_is_pair(p))
+            return NULL;
 
-    scheme_element *ret = (scheme_element *)scheme_boolean_get_false();
-    if (argCount == -1)
-    {
-        // List is not in the right format.
-        ret = NULL;
-    }
-    else
-    {
-        // Go through each item in list.
-        for (int i = 0; i < argCount; ++i)
-        {
-            scheme_element *p = *(pairs + i);
-
-            // Each item in list must be a pair.
-            if (!scheme_element_is_type(p, scheme_pair_get_type()))
-            {
-                ret = NULL;
-                break;
-            }
-
-            scheme_element *first = scheme_pair_get_first((scheme_pair *)p);
-
-            if (scheme_element_compare(key, first))
-            {
-                // Found a pair that is associated with key.
-                ret = scheme_element_copy(p);
-                break;
-            }
-        }
+        // Found a pair that is associated with key.
+        if (scheme_element_compare(key, scheme_pair_get_first((scheme_pair *)p)))
+            return scheme_element_copy(p);
+
+        list = scheme_pair_get_second((scheme_pair *)list);
     }
 
-    scheme_element_free(key);
-    scheme_element_free(list);
-    free(pairs);
-    return ret;
+    // List is not in the right format.
+    if (!scheme_element_is_pair(list))
+        return NULL;
+
+    return (scheme_element *)scheme_boolean_get_false();
 }
 
 /**** Public function implementations ****/
@@ -120,7 +81,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_assoc, PROCEDURE_ASSOC_NAME, _assoc_function);
+        scheme_procedure_init_strict(&_procedure_assoc, PROCEDURE_ASSOC_NAME, _assoc_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_assoc.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -131,3 +92,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_assoc;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
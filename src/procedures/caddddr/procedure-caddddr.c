@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "utils.h"
 
 #include "scheme-data-types.h"
@@ -19,17 +18,17 @@ static int _proc_initd = 0;
  * Implementation of Scheme procedure "caddddr".
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format: (<pair>)
+ * - Arguments are not in the format: (<pair>)
  * - Argument <pair> is not a list with at least 5 elements.
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Result of evaluation or NULL if an error occurs.
  */
-static scheme_element *_caddddr_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_caddddr_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -41,50 +40,24 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_caddddr_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_caddddr_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    scheme_element *result, *parameter, *temp;
+    // Check number of arguments.
+    if (count != 1) return NULL;
 
-    // Get procedures car and cdr.
-    scheme_procedure *procedure_car = (scheme_procedure *)scheme_namespace_get(namespace, "car");
-    if (!scheme_element_is_type((scheme_element *)procedure_car, scheme_procedure_get_type()))
+    // Take cdr 4 times, then car, of argument. Each must be applied to a
+    // non-empty pair.
+    scheme_element *pair = arguments[0];
+    for (int i = 0; i <= 4; ++i)
     {
-        return NULL;
-    }
-    scheme_procedure *procedure_cdr = (scheme_procedure *)scheme_namespace_get(namespace, "cdr");
-    if (!scheme_element_is_type((scheme_element *)procedure_cdr, scheme_procedure_get_type()))
-    {
-        return NULL;
-    }
-
-    // Call cdr 4 times.
-    parameter = scheme_element_copy(element);
-    for (int i = 0; i < 4; ++i)
-    {
-        // Perform cdr call.
-        result = scheme_procedure_apply(procedure_cdr, parameter, namespace);
-        scheme_element_free(parameter);
-
-        if (result == NULL)
-        {
+        if (!scheme_element_is_pair(pair) || scheme_pair_is_empty((scheme_pair *)pair))
             return NULL;
-        }
 
-        // Quote result.
-        parameter = (scheme_element *)scheme_element_quote(result);
-        scheme_element_free(result);
-
-        // Add quoted result to a list of 1 element.
-        temp = (scheme_element *)scheme_pair_new(parameter, (scheme_element *)scheme_pair_get_empty());
-        scheme_element_free(parameter);
-        parameter = temp;
+        if (i < 4)
+            pair = scheme_pair_get_second((scheme_pair *)pair);
     }
 
-    // Call car on resulting list.
-    result = scheme_procedure_apply(procedure_car, parameter, namespace);
-    scheme_element_free(parameter);
-
-    return result;
+    return scheme_element_copy(scheme_pair_get_first((scheme_pair *)pair));
 }
 
 /**** Public function implementations ****/
@@ -93,7 +66,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_caddddr, PROCEDURE_CADDDDR_NAME, _caddddr_function);
+        scheme_procedure_init_strict(&_procedure_caddddr, PROCEDURE_CADDDDR_NAME, _caddddr_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_caddddr.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -104,3 +77,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_caddddr;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -22,16 +21,16 @@ static int _proc_initd = 0;
  * Return the first element of the Scheme pair supplied as argument.
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format: (<pair>)
+ * - Arguments are not in the format: (<pair>)
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return First element of pair, or NULL if an error occurs.
  */
-static scheme_element *_car_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_car_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -43,42 +42,18 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_car_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_car_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)element, &argCount);
+    // Check number of arguments.
+    if (count != 1) return NULL;
 
-    // Check if argument list is invalid.
-    if (argCount == -1) return NULL;
-    else if (argCount != 1)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
+    // Argument must be a non-empty pair.
+    scheme_element *pair = arguments[0];
+    if (!scheme_element_is_pair(pair) || scheme_pair_is_empty((scheme_pair *)pair))
         return NULL;
-    }
-
-    scheme_element *arg = *args;
-    free(args);
-
-    // Evaluate argument.
-    scheme_element *result = scheme_evaluate(arg, namespace);
-    if (result == NULL) return NULL;
 
-    // Evaluated result must be a pair.
-    if (!scheme_element_is_type(result, scheme_pair_get_type()))
-    {
-        scheme_element_free(result);
-        return NULL;
-    }
-
-    // Get a copy of the first element of result.
-    scheme_element *car = scheme_pair_get_first((scheme_pair *)result);
-    car = scheme_element_copy(car);
-
-    scheme_element_free(result);
-
-    return car;
+    // Get a copy of the first element of argument.
+    return scheme_element_copy(scheme_pair_get_first((scheme_pair *)pair));
 }
 
 /**** Public function implementations ****/
@@ -87,7 +62,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_car, PROCEDURE_CAR_NAME, _car_function);
+        scheme_procedure_init_strict(&_procedure_car, PROCEDURE_CAR_NAME, _car_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_car.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -98,3 +73,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_car;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
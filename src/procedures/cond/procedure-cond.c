@@ -14,6 +14,9 @@ static scheme_procedure _procedure_cond;
 static struct scheme_element_vtable _procedure_vtable;
 static int _proc_initd = 0;
 
+// Interned symbol "else", compared by pointer.
+static scheme_element *_else_symbol = NULL;
+
 /**** Private function declarations ****/
 
 /**
@@ -31,6 +34,8 @@ static int _proc_initd = 0;
  *
  * If all conditions evaluate to #f, return void symbol.
  *
+ * The last <expression> of the chosen block is in tail position.
+ *
  * In summary, will return NULL if:
  * - Supplied element is not a pair in the format of: ((<condition> [<expression>]) ...).
  * - Any of the condition-expression block is not a list in the given format.
@@ -60,14 +65,17 @@ static scheme_element *_cond_function(scheme_procedure *procedure, scheme_elemen
  *
  * If condition is followed by one or more expressions, return #f if condition
  * evaluates to #f. Otherwise, evaluate expressions sequentially and return result
- * of evaluating the last one. If any expression evaluates to NULL, return NULL
+ * of evaluating the last one, in tail position. If any expression evaluates to
+ * NULL, return NULL
  *
  * @param  element    Condition-expression block.
  * @param  namespace  Active namespace.
+ * @param  isChosen   Set to 1 if the block's condition did not evaluate to #f,
+ *                    0 otherwise.
  *
  * @return Result as described above.
  */
-static scheme_element *_parse_condition_block(scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_parse_condition_block(scheme_element *element, scheme_namespace *namespace, int *isChosen);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -95,7 +103,7 @@ static scheme_element *_cond_function(scheme_procedure *procedure, scheme_elemen
     {
         scheme_element *block = *(args + i);
 
-        if (!scheme_element_is_type(block, scheme_pair_get_type()) || scheme_pair_is_empty((scheme_pair *)block))
+        if (!scheme_element_is_pair(block) || scheme_pair_is_empty((scheme_pair *)block))
         {
             free(args);
             return NULL;
@@ -103,9 +111,7 @@ static scheme_element *_cond_function(scheme_procedure *procedure, scheme_elemen
 
         scheme_element *condition = scheme_pair_get_first((scheme_pair *)block);
 
-        if (i < argCount - 2
-                && scheme_element_is_type(condition, scheme_symbol_get_type())
-                && scheme_symbol_value_equals((scheme_symbol *)condition, "else"))
+        if (i < argCount - 2 && condition == _else_symbol)
         {
             free(args);
             return NULL;
@@ -117,7 +123,8 @@ static scheme_element *_cond_function(scheme_procedure *procedure, scheme_elemen
     for (int i = 0; i < argCount; ++i)
     {
         scheme_element *block = *(args + i);
-        scheme_element *result = _parse_condition_block(block, namespace);
+        int isChosen;
+        scheme_element *result = _parse_condition_block(block, namespace, &isChosen);
 
         if (result == NULL)
         {
@@ -127,7 +134,7 @@ static scheme_element *_cond_function(scheme_procedure *procedure, scheme_elemen
         }
 
         // Continue if condition was #f.
-        if (result == (scheme_element *)scheme_boolean_get_false()) continue;
+        if (!isChosen) continue;
 
         // Return result if condition was not #f.
         ret = result;
@@ -138,9 +145,10 @@ static scheme_element *_cond_function(scheme_procedure *procedure, scheme_elemen
     return ret;
 }
 
-static scheme_element *_parse_condition_block(scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_parse_condition_block(scheme_element *element, scheme_namespace *namespace, int *isChosen)
 {
     scheme_pair *block = (scheme_pair *)element;
+    *isChosen = 0;
 
     int exprCount;
     scheme_element **exprs = scheme_list_to_array((scheme_pair *)block, &exprCount);
@@ -151,8 +159,7 @@ static scheme_element *_parse_condition_block(scheme_element *element, scheme_na
 
     // Evaluate condition.
     scheme_element *condition = *exprs;
-    int conditionIsElse = scheme_element_is_type(condition, scheme_symbol_get_type())
-                       && scheme_symbol_value_equals((scheme_symbol *)condition, "else");
+    int conditionIsElse = condition == _else_symbol;
 
     condition = scheme_evaluate(condition, namespace);
 
@@ -175,6 +182,7 @@ static scheme_element *_parse_condition_block(scheme_element *element, scheme_na
             return NULL;
         }
 
+        *isChosen = condition != (scheme_element *)scheme_boolean_get_false();
         return condition;
     }
     else
@@ -191,6 +199,7 @@ static scheme_element *_parse_condition_block(scheme_element *element, scheme_na
         }
 
         // Evaluate each expression and return the result of the last one.
+        *isChosen = 1;
         scheme_element *expression;
         for (int e = 1; e < exprCount - 1; ++e)
         {
@@ -205,7 +214,7 @@ static scheme_element *_parse_condition_block(scheme_element *element, scheme_na
             scheme_element_free(expression);
         }
 
-        expression = scheme_evaluate(*(exprs + exprCount - 1), namespace);
+        expression = scheme_evaluate_tail(*(exprs + exprCount - 1), namespace);
 
         free(exprs);
         return expression;
@@ -224,6 +233,8 @@ scheme_procedure *scheme_procedure_get()
         _procedure_vtable.free = _procedure_free;
         _procedure_cond.super.vtable = &_procedure_vtable;
 
+        _else_symbol = (scheme_element *)scheme_symbol_new("else");
+
         _proc_initd = 1;
     }
 
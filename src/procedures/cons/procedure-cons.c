@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -23,16 +22,16 @@ static int _proc_initd = 0;
  * arguments.
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format: (<element> <element>)
+ * - Arguments are not in the format: (<element> <element>)
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Constructed pair, or NULL if an error occurred.
  */
-static scheme_element *_cons_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_cons_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -44,40 +43,12 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_cons_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_cons_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
-    {
-        return NULL;
-    }
+    // Check number of arguments.
+    if (count != 2) return NULL;
 
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)evaluatedList, &argCount);
-
-    // Check if argument list is invalid.
-    if (argCount == -1)
-    {
-        scheme_element_free((scheme_element *)evaluatedList);
-        return NULL;
-    }
-    else if (argCount != 2)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
-        scheme_element_free((scheme_element *)evaluatedList);
-        return NULL;
-    }
-
-    scheme_element *firstArg = args[0];
-    scheme_element *secondArg = args[1];
-    free(args);
-
-    scheme_pair *pair = scheme_pair_new(firstArg, secondArg);
-
-    scheme_element_free((scheme_element *)evaluatedList);
-    return (scheme_element *)pair;
+    return (scheme_element *)scheme_pair_new(arguments[0], arguments[1]);
 }
 
 /**** Public function implementations ****/
@@ -86,7 +57,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_cons, PROCEDURE_CONS_NAME, _cons_function);
+        scheme_procedure_init_strict(&_procedure_cons, PROCEDURE_CONS_NAME, _cons_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_cons.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -97,3 +68,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_cons;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
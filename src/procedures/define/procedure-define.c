@@ -61,7 +61,7 @@ static scheme_element *_define_function(scheme_procedure *procedure, scheme_elem
 
     scheme_element *first = args[0];
 
-    if (scheme_element_is_type(first, scheme_symbol_get_type()))
+    if (scheme_element_is_symbol(first))
     {
         // Usage 1: Associate an identifier with a Scheme element.
         // Must have exactly 2 arguments.
@@ -80,13 +80,11 @@ static scheme_element *_define_function(scheme_procedure *procedure, scheme_elem
         if (symbolElement == NULL) return NULL;
 
         // Store in namespace.
-        char *symbolName = scheme_symbol_get_value(symbol);
-        scheme_namespace_set(namespace, symbolName, symbolElement);
-        free(symbolName);
+        scheme_namespace_set_symbol(namespace, symbol, symbolElement);
 
         return symbolElement;
     }
-    else if (scheme_element_is_type(first, scheme_pair_get_type()))
+    else if (scheme_element_is_pair(first))
     {
         // Usage 2: Define a lambda function.
         free(args);
@@ -99,22 +97,21 @@ static scheme_element *_define_function(scheme_procedure *procedure, scheme_elem
 
         // Get procedure's name.
         scheme_element *nameSymbol = scheme_pair_get_first((scheme_pair *)first);
-        if (!scheme_element_is_type(nameSymbol, scheme_symbol_get_type()))
+        if (!scheme_element_is_symbol(nameSymbol))
         {
             return NULL;
         }
-        char *name = scheme_symbol_get_value((scheme_symbol *)nameSymbol);
+        const char *name = scheme_symbol_get_value_ref((scheme_symbol *)nameSymbol);
 
         // Get list of arguments.
         scheme_element *arguments = scheme_pair_get_second((scheme_pair *)first);
         // Get list of expressions: Second elemnet of input list.
         scheme_element *expressions = scheme_pair_get_second((scheme_pair *)element);
 
-        scheme_lambda *result = scheme_lambda_new_from_elements(name, arguments, expressions);
+        scheme_lambda *result = scheme_lambda_new_from_elements(name, arguments, expressions, namespace);
 
         // Store procedure in namespace.
-        scheme_namespace_set(namespace, name, (scheme_element *)result);
-        free(name);
+        scheme_namespace_set_symbol(namespace, (scheme_symbol *)nameSymbol, (scheme_element *)result);
 
         return (scheme_element *)result;
     }
@@ -67,10 +67,12 @@ static scheme_element *_exit_function(scheme_procedure *procedure, scheme_elemen
         if (result == NULL) return NULL;
 
         // If evaluated result is a number, set the number as exit code.
-        if (scheme_element_is_type(result, scheme_number_get_type()))
+        if (scheme_element_is_number(result))
         {
             g_SchemeProgramTerminationCode = scheme_number_get_value((scheme_number *)result) % 256;
         }
+
+        scheme_element_free(result);
     }
 
     // Signal main program to terminate.
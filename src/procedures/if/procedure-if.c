@@ -24,7 +24,7 @@ static int _proc_initd = 0;
  * Takes a test expression and two additional expressions. If test expression
  * evaluates to anything other than #f, first out of the two additional
  * expressions is evaluated and returned. Otherwise, second expression is
- * evaluated and returned.
+ * evaluated and returned. Either expression is in tail position.
  *
  * Will return NULL if:
  * - Supplied element is not a list with exactly three arguments as described above.
@@ -81,11 +81,11 @@ static scheme_element *_if_function(scheme_procedure *procedure, scheme_element
 
     if (conditionIsFalse)
     {
-        return scheme_evaluate(elseExpr, namespace);
+        return scheme_evaluate_tail(elseExpr, namespace);
     }
     else
     {
-        return scheme_evaluate(thenExpr, namespace);
+        return scheme_evaluate_tail(thenExpr, namespace);
     }
 }
 
@@ -1,7 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -25,17 +24,17 @@ static int _proc_initd = 0;
  * Compare two Scheme elements.
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format (<element> <element>).
+ * - Arguments are not in the format: (<element> <element>).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Scheme boolean #t if two elements are equal, #f if not, or NULL
  *         if an error occurs.
  */
-static scheme_element *_equal_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_equal_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -47,39 +46,12 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_equal_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_equal_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Evaluate each argument.
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
-    {
-        return NULL;
-    }
-
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array(evaluatedList, &argCount);
-
-    // Check if argument list is invalid.
-    if (argCount == -1)
-    {
-        scheme_element_free((scheme_element *)evaluatedList);
-        return NULL;
-    }
-    else if (argCount != 2)
-    {
-        // Wrong number of arguments.
-        free(args);
-        scheme_element_free((scheme_element *)evaluatedList);
-        return NULL;
-    }
-
-    scheme_element *firstArg = args[0];
-    scheme_element *secondArg = args[1];
-    free(args);
+    // Check number of arguments.
+    if (count != 2) return NULL;
 
-    int comparison = scheme_element_compare(firstArg, secondArg);
-    scheme_element_free((scheme_element *)evaluatedList);
+    int comparison = scheme_element_compare(arguments[0], arguments[1]);
 
     return (scheme_element *)(comparison ? scheme_boolean_get_true() : scheme_boolean_get_false());
 }
@@ -90,7 +62,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_equal, PROCEDURE_EQUAL_NAME, _equal_function);
+        scheme_procedure_init_strict(&_procedure_equal, PROCEDURE_EQUAL_NAME, _equal_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_equal.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -113,3 +85,8 @@ const char *scheme_procedure_get_alias(int index)
 
     return _procedure_aliases[index];
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
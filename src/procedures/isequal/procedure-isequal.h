@@ -27,4 +27,10 @@ int scheme_procedure_get_alias_count();
  */
 const char *scheme_procedure_get_alias(int index);
 
+/**
+ * @return 1, since this procedure has no side effects and its result only
+ *         depends on its arguments.
+ */
+int scheme_procedure_get_purity();
+
 #endif
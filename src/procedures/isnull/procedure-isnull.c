@@ -1,7 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -25,17 +24,17 @@ static int _proc_initd = 0;
  * Check if a Scheme element is the empty pair or #f.
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format (<element>).
+ * - Arguments are not in the format: (<element>).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Scheme boolean #t if element is the empty pair or #f,
  *         or NULL if an error occurs.
  */
-static scheme_element *_null_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_null_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -47,30 +46,12 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_null_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_null_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)element, &argCount);
+    // Check number of arguments.
+    if (count != 1) return NULL;
 
-    // Check if argument list is invalid.
-    if (argCount == -1) return NULL;
-    else if (argCount != 1)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
-        return NULL;
-    }
-
-    scheme_element *arg = args[0];
-    free(args);
-
-    // Evaluate argument.
-    arg = scheme_evaluate(arg, namespace);
-    if (arg == NULL) return NULL;
-
-    int isEmpty = scheme_element_compare(arg, (scheme_element *)scheme_pair_get_empty());
-    scheme_element_free(arg);
+    int isEmpty = scheme_element_compare(arguments[0], (scheme_element *)scheme_pair_get_empty());
 
     return (scheme_element *)(isEmpty ? scheme_boolean_get_true() : scheme_boolean_get_false());
 }
@@ -80,7 +61,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_null, PROCEDURE_NULL_NAME, _null_function);
+        scheme_procedure_init_strict(&_procedure_null, PROCEDURE_NULL_NAME, _null_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_null.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -103,3 +84,8 @@ const char *scheme_procedure_get_alias(int index)
 
     return _procedure_aliases[index];
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
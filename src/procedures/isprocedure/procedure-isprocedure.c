@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -21,19 +20,17 @@ static int _proc_initd = 0;
  * Check if given argument is a procedure.
  *
  * Will return NULL if:
- * - Supplied element is not in the format (<element>).
+ * - Arguments are not in the format: (<element>).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Scheme boolean #t if argument is a procedure, #f if not,
  *         or NULL if an error occurs.
  */
-static scheme_element *_isprocedure_function(scheme_procedure *procedure,
-                                             scheme_element *element,
-                                             scheme_namespace *namespace);
+static scheme_element *_isprocedure_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -45,40 +42,13 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_isprocedure_function(scheme_procedure *procedure,
-                                             scheme_element *element,
-                                             scheme_namespace *namespace)
+static scheme_element *_isprocedure_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)element, &argCount);
+    // Check number of arguments.
+    if (count != 1) return NULL;
 
-    // Check if argument list is invalid.
-    if (argCount == -1) return NULL;
-    else if (argCount != 1)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
-        return NULL;
-    }
-
-    scheme_element *arg = *args;
-    free(args);
-
-    // Evaluate argument.
-    arg = scheme_evaluate(arg, namespace);
-
-    if (arg == NULL)
-    {
-        // Could not evaluate argument.
-        return NULL;
-    }
-
-    // Check arg's type.
-    int isProcedure = scheme_element_is_type(arg, scheme_procedure_get_type());
-    scheme_element_free(arg);
-
-    if (isProcedure)
+    // Check argument's type.
+    if (scheme_element_is_procedure(arguments[0]))
         return (scheme_element *)scheme_boolean_get_true();
     else
         return (scheme_element *)scheme_boolean_get_false();
@@ -90,7 +60,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_isprocedure, PROCEDURE_ISPROCEDURE_NAME, _isprocedure_function);
+        scheme_procedure_init_strict(&_procedure_isprocedure, PROCEDURE_ISPROCEDURE_NAME, _isprocedure_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_isprocedure.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -102,3 +72,7 @@ scheme_procedure *scheme_procedure_get()
     return &_procedure_isprocedure;
 }
 
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
@@ -44,7 +44,7 @@ static void _procedure_free(scheme_element *element) {}
 static scheme_element *_lambda_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
 {
     // Element must be a non-empty pair.
-    if (!scheme_element_is_type(element, scheme_pair_get_type()))
+    if (!scheme_element_is_pair(element))
         return NULL;
     if (scheme_pair_is_empty((scheme_pair *)element))
         return NULL;
@@ -55,7 +55,7 @@ static scheme_element *_lambda_function(scheme_procedure *procedure, scheme_elem
     // Get list of expressions.
     scheme_element *expressions = scheme_pair_get_second((scheme_pair *)element);
 
-    return (scheme_element *)scheme_lambda_new_from_elements(NULL, arguments, expressions);
+    return (scheme_element *)scheme_lambda_new_from_elements(NULL, arguments, expressions, namespace);
 }
 
 /**** Public function implementations ****/
@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -20,16 +19,16 @@ static int _proc_initd = 0;
  * Implementation of Scheme procedure "last".
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format: (<list>)
+ * - Arguments are not in the format: (<list>)
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Last element of list, or NULL if an error occurs.
  */
-static scheme_element *_last_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_last_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -41,48 +40,25 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_last_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_last_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)element, &argCount);
+    // Check number of arguments.
+    if (count != 1) return NULL;
 
-    // Check if argument list is invalid.
-    if (argCount == -1) return NULL;
-    else if (argCount != 1)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
+    // Argument must be a pair.
+    scheme_element *arg = arguments[0];
+    if (!scheme_element_is_pair(arg))
         return NULL;
-    }
-
-    scheme_element *arg = args[0];
-    free(args);
-
-    // Evaluate argument.
-    arg = scheme_evaluate(arg, namespace);
-    if (arg == NULL) return NULL;
 
-    // Evaluated result must be a pair.
-    if (!scheme_element_is_type(arg, scheme_pair_get_type()))
-    {
-        scheme_element_free(arg);
-        return NULL;
-    }
-
-    // Get every item in evaluated result and verify that it is a non-empty list.
+    // Get every item in argument and verify that it is a non-empty list.
     int itemCount;
     scheme_element **items = scheme_list_to_array((scheme_pair *)arg, &itemCount);
     if (itemCount == -1 || itemCount == 0)
-    {
-        scheme_element_free(arg);
         return NULL;
-    }
 
     // Get last element.
     scheme_element *result = scheme_element_copy(items[itemCount - 1]);
     free(items);
-    scheme_element_free(arg);
 
     return result;
 }
@@ -93,7 +69,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_last, PROCEDURE_LAST_NAME, _last_function);
+        scheme_procedure_init_strict(&_procedure_last, PROCEDURE_LAST_NAME, _last_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_last.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -104,3 +80,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_last;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -20,16 +19,16 @@ static int _proc_initd = 0;
  * Implementation of Scheme procedure "length".
  *
  * Will return NULL if:
- * - Supplied element is not a pair in the format: (<list>)
+ * - Arguments are not in the format: (<list>)
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Length of list, or NULL if an error occurs.
  */
-static scheme_element *_length_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_length_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -41,46 +40,27 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_length_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_length_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Get arguments.
-    int argCount;
-    scheme_element **args = scheme_list_to_array((scheme_pair *)element, &argCount);
+    // Check number of arguments.
+    if (count != 1) return NULL;
 
-    // Check if argument list is invalid.
-    if (argCount == -1) return NULL;
-    else if (argCount != 1)
-    {
-        // Wrong number of arguments.
-        if (args != NULL) free(args);
+    // Argument must be a pair.
+    scheme_element *arg = arguments[0];
+    if (!scheme_element_is_pair(arg))
         return NULL;
-    }
-
-    scheme_element *arg = args[0];
-    free(args);
 
-    // Evaluate argument.
-    arg = scheme_evaluate(arg, namespace);
-    if (arg == NULL) return NULL;
-
-    // Evaluated result must be a pair.
-    if (!scheme_element_is_type(arg, scheme_pair_get_type()))
+    // Count items in argument, verifying that it is a list.
+    int itemCount = 0;
+    while (!scheme_pair_is_empty((scheme_pair *)arg))
     {
-        scheme_element_free(arg);
-        return NULL;
-    }
+        arg = scheme_pair_get_second((scheme_pair *)arg);
+        if (!scheme_element_is_pair(arg))
+            return NULL;
 
-    // Get every item in evaluated result and verify that it is a non-empty list.
-    int itemCount;
-    scheme_element **items = scheme_list_to_array((scheme_pair *)arg, &itemCount);
-    if (itemCount == -1)
-    {
-        scheme_element_free(arg);
-        return NULL;
+        ++itemCount;
     }
 
-    free(items);
-    scheme_element_free(arg);
     return (scheme_element *)scheme_number_new(itemCount);
 }
 
@@ -90,7 +70,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_length, PROCEDURE_LENGTH_NAME, _length_function);
+        scheme_procedure_init_strict(&_procedure_length, PROCEDURE_LENGTH_NAME, _length_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_length.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -102,3 +82,7 @@ scheme_procedure *scheme_procedure_get()
     return &_procedure_length;
 }
 
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
@@ -17,5 +17,11 @@
  */
 scheme_procedure *scheme_procedure_get();
 
+/**
+ * @return 1, since this procedure has no side effects and its result only
+ *         depends on its arguments.
+ */
+int scheme_procedure_get_purity();
+
 #endif
 
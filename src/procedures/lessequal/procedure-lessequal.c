@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -20,17 +19,17 @@ static int _proc_initd = 0;
  * Implementation of Scheme procedure "<=".
  *
  * Will return NULL if:
- * - Element is not a list in the format: (<number> ...).
+ * - Arguments are not in the format: (<number> ...).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return #t if numbers are in non-increasing order, #f if not,
  *         or NULL if an error occurs.
  */
-static scheme_element *_lessequal_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_lessequal_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -42,67 +41,33 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_lessequal_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_lessequal_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Evaluate each argument.
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
-    {
-        return NULL;
-    }
-
-    // Get arguments.
-    int argCount;
-    scheme_element **arguments = scheme_list_to_array(evaluatedList, &argCount);
-
-    // Terminate if element is not a list or is the empty list.
-    if (argCount == -1 || argCount == 0)
-    {
-        return NULL;
-    }
-
     // Terminate if there are less than 2 arguments.
-    if (argCount < 2)
-    {
-        free(arguments);
-        scheme_element_free((scheme_element *)evaluatedList);
-        return NULL;
-    }
+    if (count < 2) return NULL;
 
     // Verify that every argument is a number.
-    for (int i = 0; i < argCount; ++i)
+    for (int i = 0; i < count; ++i)
     {
-        scheme_element *anArgument = arguments[i];
-
-        if (!scheme_element_is_type(anArgument, scheme_number_get_type()))
-        {
-            free(arguments);
-            scheme_element_free((scheme_element *)evaluatedList);
+        if (!scheme_element_is_number(arguments[i]))
             return NULL;
-        }
     }
 
-    // Check if numbers are in strictly decreasing order.
+    // Check if numbers are in non-increasing order.
     long max = scheme_number_get_value((scheme_number *)arguments[0]);
-    scheme_boolean *result = scheme_boolean_get_true();
-    for (int i = 1; i < argCount; ++i)
+    for (int i = 1; i < count; ++i)
     {
         long value = scheme_number_get_value((scheme_number *)arguments[i]);
-        if (value <= max)
-        {
-            max = value;
-        }
-        else
+        if (!(value <= max))
         {
-            // Found a number out of strictly decreasing order.
-            result = scheme_boolean_get_false();
-            break;
+            // Found a number out of non-increasing order.
+            return (scheme_element *)scheme_boolean_get_false();
         }
+
+        max = value;
     }
 
-    free(arguments);
-    scheme_element_free((scheme_element *)evaluatedList);
-    return (scheme_element *)result;
+    return (scheme_element *)scheme_boolean_get_true();
 }
 
 /**** Public function implementations ****/
@@ -111,7 +76,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_lessequal, PROCEDURE_LESSEQUAL_NAME, _lessequal_function);
+        scheme_procedure_init_strict(&_procedure_lessequal, PROCEDURE_LESSEQUAL_NAME, _lessequal_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_lessequal.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -122,3 +87,8 @@ scheme_procedure *scheme_procedure_get()
 
     return &_procedure_lessequal;
 }
+
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
@@ -36,7 +36,7 @@ static void _procedure_free(scheme_element *element) {}
 static scheme_element *_let_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
 {
     // Element must be a non-empty pair.
-    if (!scheme_element_is_type(element, scheme_pair_get_type()))
+    if (!scheme_element_is_pair(element))
         return NULL;
     if (scheme_pair_is_empty((scheme_pair *)element))
         return NULL;
@@ -58,17 +58,17 @@ static scheme_element *_let_function(scheme_procedure *procedure, scheme_element
     scheme_element *lambdaData;
     char *procID = NULL;
 
-    if (scheme_element_is_type(first, scheme_pair_get_type()))
+    if (scheme_element_is_pair(first))
     {
         // First form: Given a list of argument identifiers with values and a list of expressions.
         lambdaData = element;
     }
-    else if (scheme_element_is_type(first, scheme_symbol_get_type()))
+    else if (scheme_element_is_symbol(first))
     {
         // Second form: Given procedure ID, then a list of argument identifiers with values and a list of expressions.
         lambdaData = scheme_pair_get_second((scheme_pair *)element);
 
-        if (!scheme_element_is_type(lambdaData, scheme_pair_get_type()))
+        if (!scheme_element_is_pair(lambdaData))
         {
             return NULL;
         }
@@ -86,25 +86,42 @@ static scheme_element *_let_function(scheme_procedure *procedure, scheme_element
     // Get list of expressions.
     scheme_element *expressions = scheme_pair_get_second((scheme_pair *)lambdaData);
 
+    // If call is in second form, the procedure is created in a local
+    // namespace where its ID is bound to it, so that it can call itself.
+    scheme_namespace *localNamespace = namespace;
+    if (procID != NULL)
+    {
+        localNamespace = scheme_namespace_new_frame(namespace, 1);
+        if (localNamespace == NULL)
+        {
+            free(procID);
+            return NULL;
+        }
+    }
+
     // Create procedure from given arguments and expressions.
-    scheme_lambda *lambda = scheme_lambda_new_from_elements(procID, argList, expressions);
+    scheme_lambda *lambda = scheme_lambda_new_from_elements(procID, argList, expressions, localNamespace);
     if (lambda == NULL)
     {
+        free(procID);
+        if (localNamespace != namespace)
+        {
+            scheme_element_free((scheme_element *)localNamespace);
+        }
+
         return NULL;
     }
 
-    // If call is in second form, also bind given procedure ID to lambda procedure in a local namespace.
-    scheme_namespace *localNamespace = namespace;
-    if (scheme_element_is_type(first, scheme_symbol_get_type()))
+    if (procID != NULL)
     {
-        localNamespace = scheme_namespace_new(namespace);
-
-        scheme_namespace_set(localNamespace, procID, (scheme_element *)lambda);
+        scheme_symbol *procSymbol = scheme_symbol_new(procID);
+        if (procSymbol != NULL)
+            scheme_namespace_bind_symbol(localNamespace, procSymbol, (scheme_element *)lambda);
         free(procID);
     }
 
-    // Run procedure with no arguments and return result.
-    scheme_element *result = scheme_procedure_apply((scheme_procedure *)lambda, (scheme_element *)scheme_pair_get_empty(), localNamespace);
+    // Run procedure with no arguments, in tail position, and return result.
+    scheme_element *result = scheme_procedure_apply_tail((scheme_procedure *)lambda, (scheme_element *)scheme_pair_get_empty(), localNamespace);
 
     scheme_element_free((scheme_element *)lambda);
     if (localNamespace != namespace)
@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -20,16 +19,16 @@ static int _proc_initd = 0;
  * Implementation of Scheme procedure "list".
  *
  * Will return NULL if:
- * - Element is not a list in the format: (<element> ...).
+ * - Arguments are not in the format: (<element> ...).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Newly created list or NULL if an error occurs.
  */
-static scheme_element *_list_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_list_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -41,27 +40,20 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_list_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_list_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Evaluate each argument.
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
+    // Build list from the last argument to the first.
+    scheme_element *list = scheme_element_copy((scheme_element *)scheme_pair_get_empty());
+    for (int i = count - 1; i >= 0; --i)
     {
-        return NULL;
-    }
-
-    // Count number of elements in evaluated list and verify that it is indeed a list.
-    int argCount;
-    scheme_element **arguments = scheme_list_to_array(evaluatedList, &argCount);
-    free(arguments);
+        scheme_element *pair = (scheme_element *)scheme_pair_new(arguments[i], list);
+        scheme_element_free(list);
+        if (pair == NULL) return NULL;
 
-    // Terminate if element is not a list.
-    if (argCount == -1)
-    {
-        return NULL;
+        list = pair;
     }
 
-    return (scheme_element *)evaluatedList;
+    return list;
 }
 
 /**** Public function implementations ****/
@@ -70,7 +62,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_list, PROCEDURE_LIST_NAME, _list_function);
+        scheme_procedure_init_strict(&_procedure_list, PROCEDURE_LIST_NAME, _list_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_list.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -82,3 +74,7 @@ scheme_procedure *scheme_procedure_get()
     return &_procedure_list;
 }
 
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
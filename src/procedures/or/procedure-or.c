@@ -43,16 +43,9 @@ static void _procedure_free(scheme_element *element) {}
 
 static scheme_element *_or_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
 {
-    // Evaluate each argument.
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
-    {
-        return NULL;
-    }
-
     // Get arguments.
     int argCount;
-    scheme_element **arguments = scheme_list_to_array(evaluatedList, &argCount);
+    scheme_element **arguments = scheme_list_to_array((scheme_pair *)element, &argCount);
 
     // Terminate if element is not a list.
     if (argCount == -1)
@@ -66,24 +59,43 @@ static scheme_element *_or_function(scheme_procedure *procedure, scheme_element
         return (scheme_element *)scheme_boolean_get_false();
     }
 
-    // Go through each evaluated argument and return one as soon as we find one that
-    // is not null (ie. not equal to #f).
-    for (int i = 0; i < argCount; ++i)
+    // Evaluate each argument but the last, and keep the first one that is
+    // not null (ie. not equal to #f).
+    scheme_element *result = NULL;
+    for (int i = 0; i < argCount - 1; ++i)
     {
-        if (!scheme_element_compare(arguments[i], (scheme_element *)scheme_boolean_get_false()))
+        scheme_element *argument = scheme_evaluate(arguments[i], namespace);
+        if (argument == NULL)
         {
-            scheme_element *result = scheme_element_copy(arguments[i]);
             free(arguments);
-            scheme_element_free((scheme_element *)evaluatedList);
-            return result;
+            scheme_element_free(result);
+            return NULL;
         }
+
+        if (result == NULL && !scheme_element_compare(argument, (scheme_element *)scheme_boolean_get_false()))
+            result = argument;
+        else
+            scheme_element_free(argument);
     }
 
-    // No argument fonud. Return evaluated last argument.
-    scheme_element *last = scheme_element_copy(arguments[argCount - 1]);
+    scheme_element *last = arguments[argCount - 1];
     free(arguments);
-    scheme_element_free((scheme_element *)evaluatedList);
-    return last;
+
+    // No argument found. Return evaluated last argument, which is in tail
+    // position.
+    if (result == NULL)
+        return scheme_evaluate_tail(last, namespace);
+
+    // Every argument is still evaluated.
+    last = scheme_evaluate(last, namespace);
+    if (last == NULL)
+    {
+        scheme_element_free(result);
+        return NULL;
+    }
+
+    scheme_element_free(last);
+    return result;
 }
 
 /**** Public function implementations ****/
@@ -1,6 +1,5 @@
 #include <stdlib.h>
 
-#include "eval.h"
 #include "scheme-data-types.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -23,16 +22,16 @@ static int _proc_initd = 0;
  * Given a list of numbers, return the first number subtracted by the rest.
  *
  * Will return NULL if:
- * - Element is not a list in the format: (<number> ...).
+ * - Arguments are not in the format: (<number> ...).
  * - Out of memory.
  *
  * @param  procedure  Procedure that refers to this function.
- * @param  element    A Scheme element.
- * @param  namespace  Active namespace.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
  *
  * @return Result of calculation or NULL if an error occurs.
  */
-static scheme_element *_subtract_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+static scheme_element *_subtract_function(scheme_procedure *procedure, scheme_element **arguments, int count);
 
 /**
  * Prevent freeing this statically allocated Scheme procedure.
@@ -44,58 +43,29 @@ static void _procedure_free(scheme_element *element) {}
 
 /**** Private function implementations ****/
 
-static scheme_element *_subtract_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+static scheme_element *_subtract_function(scheme_procedure *procedure, scheme_element **arguments, int count)
 {
-    // Evaluate each argument.
-    scheme_pair *evaluatedList = scheme_list_evaluated((scheme_pair *)element, namespace);
-    if (evaluatedList == NULL)
-    {
-        return NULL;
-    }
-
-    // Get arguments.
-    int argCount;
-    scheme_element **arguments = scheme_list_to_array(evaluatedList, &argCount);
-
-    // Terminate if element is not a list or is the empty list.
-    if (argCount == -1 || argCount == 0)
-    {
-        return NULL;
-    }
+    // Terminate if there is no argument.
+    if (count == 0) return NULL;
 
-    // Verify that every argument is a number.
-    for (int i = 0; i < argCount; ++i)
+    // If there is only one argument, negate it. If there are more than one
+    // arguments, get the first one and subtract it by the rest.
+    long result = 0;
+    for (int i = 0; i < count; ++i)
     {
-        scheme_element *anArgument = arguments[i];
-
-        if (!scheme_element_is_type(anArgument, scheme_number_get_type()))
-        {
-            free(arguments);
-            scheme_element_free((scheme_element *)evaluatedList);
+        // Terminate if argument is not a number.
+        if (!scheme_element_is_number(arguments[i]))
             return NULL;
-        }
-    }
 
-    long result;
-    if (argCount == 1)
-    {
-        // If there is only one argument, negate it.
-        result = -scheme_number_get_value((scheme_number *)arguments[0]);
+        long value = scheme_number_get_value((scheme_number *)arguments[i]);
+        result = i == 0 ? value : result - value;
     }
-    else
+
+    if (count == 1)
     {
-        // If there are more than one arguments, get the first one and
-        // subtract it by the rest.
-
-        result = scheme_number_get_value((scheme_number *)arguments[0]);
-        for (int i = 1; i < argCount; ++i)
-        {
-            result -= scheme_number_get_value((scheme_number *)arguments[i]);
-        }
+        result = -result;
     }
 
-    free(arguments);
-    scheme_element_free((scheme_element *)evaluatedList);
     return (scheme_element *)scheme_number_new(result);
 }
 
@@ -105,7 +75,7 @@ scheme_procedure *scheme_procedure_get()
 {
     if (!_proc_initd)
     {
-        scheme_procedure_init(&_procedure_subtract, PROCEDURE_SUBTRACT_NAME, _subtract_function);
+        scheme_procedure_init_strict(&_procedure_subtract, PROCEDURE_SUBTRACT_NAME, _subtract_function);
 
         scheme_element_vtable_clone(&_procedure_vtable, _procedure_subtract.super.vtable);
         _procedure_vtable.free = _procedure_free;
@@ -117,3 +87,7 @@ scheme_procedure *scheme_procedure_get()
     return &_procedure_subtract;
 }
 
+int scheme_procedure_get_purity()
+{
+    return 1;
+}
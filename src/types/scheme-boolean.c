@@ -27,16 +27,6 @@ static void _vtable_free(scheme_element *element);
  */
 static void _vtable_print(scheme_element *element);
 
-/**
- * Scheme boolean symbols are implemented as static variables and
- * cannot be copied. This function simply returns its parameter.
- *
- * @param  element  Should be a Scheme boolean symbol.
- *
- * @return Given parameter as-is.
- */
-static scheme_element *_vtable_copy(scheme_element *element);
-
 /**
  * Compare boolean symbol to another symbol.
  * Will return 0 if either pointers are not boolean symbols.
@@ -55,18 +45,19 @@ static struct scheme_element_vtable _scheme_boolean_vtable = {
     .get_type = scheme_boolean_get_type,
     .free = _vtable_free,
     .print = _vtable_print,
-    .copy = _vtable_copy,
     .compare = _vtable_compare
 };
 
 // Static variables for #t and #f symbols.
 static struct scheme_boolean _scheme_boolean_true = {
     .super.vtable = &_scheme_boolean_vtable,
+    .super.tag = SCHEME_ELEMENT_TAG_BOOLEAN,
     .value = SCHEME_BOOLEAN_VALUE_TRUE
 };
 
 static struct scheme_boolean _scheme_boolean_false = {
     .super.vtable = &_scheme_boolean_vtable,
+    .super.tag = SCHEME_ELEMENT_TAG_BOOLEAN,
     .value = SCHEME_BOOLEAN_VALUE_FALSE
 };
 
@@ -91,14 +82,9 @@ static void _vtable_print(scheme_element *element)
         printf("#f");
 }
 
-static scheme_element *_vtable_copy(scheme_element *element)
-{
-    return element;
-}
-
 static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    if (!scheme_element_is_type(other, &_scheme_boolean_type)) return 0;
+    if (!scheme_element_is_boolean(other)) return 0;
 
     // Boolean symbols are static, only need to compare pointers.
     return element == other;
@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "scheme-bytecode.h"
+#include "scheme-element-private.h"
+
+// Initial capacity of bytecode's arrays.
+#define SCHEME_BYTECODE_INITIAL_SIZE 16
+
+// Scheme bytecode.
+struct scheme_bytecode {
+    struct scheme_element super;
+    int *words;
+    int wordCount;
+    int wordSize;
+    scheme_element **constants;
+    int constantCount;
+    int constantSize;
+    scheme_namespace_cache *caches;
+    int cacheCount;
+};
+
+/**** Private function declarations ****/
+
+/**
+ * Free Scheme bytecode.
+ *
+ * @param  element  Should be Scheme bytecode.
+ */
+static void _vtable_free(scheme_element *element);
+
+/**
+ * Print Scheme bytecode to stdout.
+ *
+ * @param  element  Should be Scheme bytecode.
+ */
+static void _vtable_print(scheme_element *element);
+
+/**
+ * Compare bytecode to another element. Bytecode is only equal to itself.
+ *
+ * @param  element  Should be Scheme bytecode.
+ * @param  other    Other element.
+ *
+ * @return 1 if equal, 0 otherwise.
+ */
+static int _vtable_compare(scheme_element *element, scheme_element *other);
+
+/**
+ * Pass constants held by bytecode to a visitor.
+ *
+ * @param  element  Should be Scheme bytecode.
+ * @param  visit    A visitor.
+ */
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit);
+
+/**** Private variables ****/
+
+// Global virtual function table.
+static struct scheme_element_vtable _scheme_bytecode_vtable = {
+    .get_type = scheme_bytecode_get_type,
+    .free = _vtable_free,
+    .print = _vtable_print,
+    .compare = _vtable_compare,
+    .traverse = _vtable_traverse
+};
+
+// Global bytecode type.
+static struct scheme_element_type _scheme_bytecode_type = {
+    .super = NULL,
+    .name = "scheme_bytecode"
+};
+static int _scheme_bytecode_type_initd = 0;
+
+/**** Private function implementations ****/
+
+static void _vtable_free(scheme_element *element)
+{
+    scheme_bytecode *bytecode = (scheme_bytecode *)element;
+
+    for (int i = 0; i < bytecode->constantCount; ++i)
+    {
+        scheme_element_free(bytecode->constants[i]);
+    }
+
+    free(bytecode->caches);
+    free(bytecode->constants);
+    free(bytecode->words);
+}
+
+static void _vtable_print(scheme_element *element)
+{
+    printf("#<bytecode>");
+}
+
+static int _vtable_compare(scheme_element *element, scheme_element *other)
+{
+    return element == other;
+}
+
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit)
+{
+    scheme_bytecode *bytecode = (scheme_bytecode *)element;
+
+    for (int i = 0; i < bytecode->constantCount; ++i)
+    {
+        if (bytecode->constants[i] != NULL)
+            visit(&bytecode->constants[i]);
+    }
+}
+
+/**** Public function implementations ****/
+
+scheme_bytecode *scheme_bytecode_new()
+{
+    // Allocate bytecode.
+    scheme_bytecode *bytecode;
+    if ((bytecode = (scheme_bytecode *)scheme_element_new(sizeof(scheme_bytecode), &_scheme_bytecode_vtable, SCHEME_ELEMENT_TAG_BYTECODE)) == NULL)
+        return NULL;
+
+    bytecode->words = NULL;
+    bytecode->wordCount = 0;
+    bytecode->wordSize = 0;
+    bytecode->constants = NULL;
+    bytecode->constantCount = 0;
+    bytecode->constantSize = 0;
+    bytecode->caches = NULL;
+    bytecode->cacheCount = 0;
+
+    return bytecode;
+}
+
+int scheme_bytecode_emit(scheme_bytecode *bytecode, int word)
+{
+    // Ensure we have enough space.
+    if (bytecode->wordCount >= bytecode->wordSize)
+    {
+        int newSize = bytecode->wordSize > 0 ? bytecode->wordSize * 2 : SCHEME_BYTECODE_INITIAL_SIZE;
+        int *newWords = realloc(bytecode->words, sizeof(int) * newSize);
+        if (newWords == NULL) return -1;
+
+        bytecode->words = newWords;
+        bytecode->wordSize = newSize;
+    }
+
+    bytecode->words[bytecode->wordCount] = word;
+    return bytecode->wordCount++;
+}
+
+void scheme_bytecode_patch(scheme_bytecode *bytecode, int position, int word)
+{
+    if (position < 0 || position >= bytecode->wordCount) return;
+
+    bytecode->words[position] = word;
+}
+
+int scheme_bytecode_add_constant(scheme_bytecode *bytecode, scheme_element *element)
+{
+    // Reuse constant if bytecode already holds the same element.
+    for (int i = 0; i < bytecode->constantCount; ++i)
+    {
+        if (bytecode->constants[i] == element)
+            return i;
+    }
+
+    // Ensure we have enough space.
+    if (bytecode->constantCount >= bytecode->constantSize)
+    {
+        int newSize = bytecode->constantSize > 0 ? bytecode->constantSize * 2 : SCHEME_BYTECODE_INITIAL_SIZE;
+        scheme_element **newConstants = realloc(bytecode->constants, sizeof(scheme_element *) * newSize);
+        if (newConstants == NULL) return -1;
+
+        bytecode->constants = newConstants;
+        bytecode->constantSize = newSize;
+    }
+
+    bytecode->constants[bytecode->constantCount] = scheme_element_copy(element);
+    return bytecode->constantCount++;
+}
+
+int scheme_bytecode_add_cache(scheme_bytecode *bytecode)
+{
+    // Caches are few, so the array grows by one.
+    scheme_namespace_cache *newCaches = realloc(bytecode->caches, sizeof(scheme_namespace_cache) * (bytecode->cacheCount + 1));
+    if (newCaches == NULL) return -1;
+
+    bytecode->caches = newCaches;
+    bytecode->caches[bytecode->cacheCount].element = NULL;
+    bytecode->caches[bytecode->cacheCount].version = 0;
+
+    return bytecode->cacheCount++;
+}
+
+int scheme_bytecode_get_length(scheme_bytecode *bytecode)
+{
+    return bytecode->wordCount;
+}
+
+const int *scheme_bytecode_get_words(scheme_bytecode *bytecode)
+{
+    return bytecode->words;
+}
+
+scheme_element **scheme_bytecode_get_constants(scheme_bytecode *bytecode)
+{
+    return bytecode->constants;
+}
+
+scheme_namespace_cache *scheme_bytecode_get_caches(scheme_bytecode *bytecode)
+{
+    return bytecode->caches;
+}
+
+scheme_element_type *scheme_bytecode_get_type()
+{
+    if (!_scheme_bytecode_type_initd)
+    {
+        _scheme_bytecode_type.super = scheme_element_get_base_type();
+
+        _scheme_bytecode_type_initd = 1;
+    }
+
+    return &_scheme_bytecode_type;
+}
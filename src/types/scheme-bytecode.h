@@ -0,0 +1,170 @@
+/**
+ * Scheme bytecode.
+ *
+ * Compiled form of a Scheme expression or of the body of a lambda procedure,
+ * executed by the virtual machine. It holds a sequence of instructions, each
+ * made of an opcode followed by its operands, and the constants and inline
+ * caches the instructions refer to by index.
+ *
+ * This type is compatible with scheme_element.
+ * You may cast any scheme_bytecode pointer to scheme_element and pass it to
+ * any function that accepts a scheme_element pointer.
+ */
+
+#ifndef __SCHEME_BYTECODE_H__
+#define __SCHEME_BYTECODE_H__
+
+#include "scheme-element.h"
+#include "scheme-namespace.h"
+
+// Scheme bytecode.
+typedef struct scheme_bytecode scheme_bytecode;
+
+// Opcodes, along with their operands.
+enum scheme_bytecode_opcode {
+    // <constant>: Push a constant.
+    SCHEME_OP_CONSTANT,
+    // <constant>: Push the variable a variable reference refers to.
+    SCHEME_OP_LOCAL,
+    // <constant>: Push the variable a symbol refers to, looking it up by
+    // name from the active namespace.
+    SCHEME_OP_GLOBAL,
+    // <constant> <cache>: Same as SCHEME_OP_GLOBAL, for the procedure of a
+    // call, remembering the variable in an inline cache.
+    SCHEME_OP_CALLEE,
+    // <constant>: Associate a symbol with the value on top of the stack in
+    // the active namespace, leaving the value on the stack.
+    SCHEME_OP_DEFINE,
+    // Pop a value.
+    SCHEME_OP_POP,
+    // <target>: Continue at the given position.
+    SCHEME_OP_JUMP,
+    // <target>: Pop a value, and continue at the given position if it is
+    // equal to #f, like an empty list.
+    SCHEME_OP_JUMP_IF_FALSE,
+    // <target>: Continue at the given position if the value on top of the
+    // stack is not equal to #f, leaving it on the stack. Otherwise, pop it.
+    SCHEME_OP_JUMP_IF_TRUE_OR_POP,
+    // <target>: Same as SCHEME_OP_JUMP_IF_FALSE, but only #f itself is
+    // false, as in "cond".
+    SCHEME_OP_JUMP_IF_IS_FALSE,
+    // <target>: Same as SCHEME_OP_JUMP_IF_TRUE_OR_POP, but only #f itself
+    // is false, as in "cond".
+    SCHEME_OP_JUMP_IF_IS_NOT_FALSE_OR_POP,
+    // <constant>: Push a lambda procedure created in the active namespace
+    // from a lambda procedure used as a template.
+    SCHEME_OP_CLOSURE,
+    // <constant> <constant>: Same as SCHEME_OP_CLOSURE, but the procedure is
+    // created in a new namespace holding only the procedure itself, under
+    // the symbol stored as the second constant.
+    SCHEME_OP_NAMED_CLOSURE,
+    // <constant> <target>: If the value on top of the stack is a procedure
+    // that receives its arguments unevaluated, pop it, apply it to the list
+    // of arguments stored as a constant, push the result and continue at
+    // the given position.
+    SCHEME_OP_SYNTAX,
+    // <count>: Pop arguments and a procedure, apply the procedure to the
+    // arguments and push the result.
+    SCHEME_OP_CALL,
+    // <count>: Same as SCHEME_OP_CALL, but a lambda procedure replaces the
+    // procedure being executed instead of returning to it.
+    SCHEME_OP_TAIL_CALL,
+    // Pop a value and return it from the procedure being executed.
+    SCHEME_OP_RETURN,
+    // <constant>: Evaluate an expression the compiler does not handle
+    // without the virtual machine and push the result.
+    SCHEME_OP_EVALUATE
+};
+
+/**
+ * Create new, empty Scheme bytecode.
+ *
+ * Returned pointer must be freed with scheme_element_free().
+ *
+ * @return Newly created bytecode, or NULL if out of memory.
+ */
+scheme_bytecode *scheme_bytecode_new();
+
+/**
+ * Append a word (an opcode or an operand) to bytecode.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ * @param  word      Word to append.
+ *
+ * @return Position of word, or -1 if out of memory.
+ */
+int scheme_bytecode_emit(scheme_bytecode *bytecode, int word);
+
+/**
+ * Replace a word already appended to bytecode, such as the target of a
+ * jump that was not known when it was appended.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ * @param  position  Position of word.
+ * @param  word      New word.
+ */
+void scheme_bytecode_patch(scheme_bytecode *bytecode, int position, int word);
+
+/**
+ * Add a constant to bytecode. The element itself is shared, not
+ * duplicated.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ * @param  element   A Scheme element, may be NULL.
+ *
+ * @return Index of constant, or -1 if out of memory.
+ */
+int scheme_bytecode_add_constant(scheme_bytecode *bytecode, scheme_element *element);
+
+/**
+ * Add an empty inline cache to bytecode.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ *
+ * @return Index of cache, or -1 if out of memory.
+ */
+int scheme_bytecode_add_cache(scheme_bytecode *bytecode);
+
+/**
+ * Get number of words in bytecode, which is also the position of the next
+ * word to be appended.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ */
+int scheme_bytecode_get_length(scheme_bytecode *bytecode);
+
+/**
+ * Get bytecode's words.
+ *
+ * The returned array is only valid until another word is appended.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ */
+const int *scheme_bytecode_get_words(scheme_bytecode *bytecode);
+
+/**
+ * Get bytecode's constants. Returned elements must not be freed.
+ *
+ * The returned array is only valid until another constant is added.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ */
+scheme_element **scheme_bytecode_get_constants(scheme_bytecode *bytecode);
+
+/**
+ * Get bytecode's inline caches.
+ *
+ * The returned array is only valid until another cache is added.
+ *
+ * @param  bytecode  A Scheme bytecode.
+ */
+scheme_namespace_cache *scheme_bytecode_get_caches(scheme_bytecode *bytecode);
+
+/**
+ * Get bytecode's type.
+ *
+ * @return Bytecode's type.
+ */
+scheme_element_type *scheme_bytecode_get_type();
+
+#endif
@@ -15,5 +15,7 @@
 #include "scheme-boolean.h"
 #include "scheme-symbol.h"
 #include "scheme-pair.h"
+#include "scheme-reference.h"
+#include "scheme-bytecode.h"
 
 #endif
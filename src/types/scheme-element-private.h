@@ -10,25 +10,32 @@
 #ifndef __SCHEME_ELEMENT_PRIVATE_H__
 #define __SCHEME_ELEMENT_PRIVATE_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "scheme-element.h"
 
 /**** Struct declarations ****/
 
-// Struct for Scheme element.
-struct scheme_element;
-
 // Struct for type of a Scheme element.
 struct scheme_element_type;
 
 // Struct for a Scheme element's virtual function table.
 struct scheme_element_vtable;
 
+/**
+ * Typedef for function pointer that receives references held by a Scheme
+ * element, used with the virtual function 'traverse'.
+ *
+ * @param Address at which the element stores the reference.
+ */
+typedef void (*scheme_element_visitor_t)(scheme_element **);
+
 /**** Struct definitions ****/
 
-// Scheme element struct definition.
-struct scheme_element {
-    struct scheme_element_vtable *vtable;
-};
+// Struct for Scheme element is defined in scheme-element.h, so that type
+// predicates can be inlined. Only code declaring a Scheme data type and the
+// garbage collector should touch its fields.
 
 // Scheme element type struct.
 struct scheme_element_type {
@@ -38,16 +45,162 @@ struct scheme_element_type {
 
 // Scheme element's virtual function table struct definition.
 // For documentation on these, check matching functions in scheme-element.h.
+//
+// The function 'free' is only called once the last reference to an element
+// has been released. It should release every resource owned by the element,
+// including references to other elements, but not the element itself.
+//
+// The function 'traverse' passes the address of every reference the element
+// holds to other elements to the given visitor. It is used by the garbage
+// collector and may be NULL if the element holds no such reference.
 struct scheme_element_vtable {
     scheme_element_type *(*get_type)();
     void (*free)(scheme_element *);
     void (*print)(scheme_element *);
-    scheme_element *(*copy)(scheme_element *);
     int (*compare)(scheme_element *, scheme_element *);
+    void (*traverse)(scheme_element *, scheme_element_visitor_t);
+};
+
+/**** Immediate elements ****/
+
+// Small integers are not allocated. Their value is stored in the pointer
+// itself, shifted left by one bit, with the lowest bit set. Since elements
+// are always aligned, no allocated element has that bit set.
+//
+// An immediate element has no struct behind it and must never be
+// dereferenced. Every function in scheme-element.c and the garbage collector
+// check for one before touching an element's fields.
+
+// The bit set in every immediate element, SCHEME_ELEMENT_FIXNUM_TAG, and
+// scheme_element_is_fixnum() are defined in scheme-element.h.
+
+// Range of values that fit in an immediate element.
+#define SCHEME_ELEMENT_FIXNUM_MIN (INTPTR_MIN >> 1)
+#define SCHEME_ELEMENT_FIXNUM_MAX (INTPTR_MAX >> 1)
+
+/**
+ * Store a small integer in an immediate element.
+ *
+ * @param  value  A value between SCHEME_ELEMENT_FIXNUM_MIN and
+ *                SCHEME_ELEMENT_FIXNUM_MAX.
+ *
+ * @return An immediate element.
+ */
+static inline scheme_element *scheme_element_fixnum_new(long value)
+{
+    return (scheme_element *)(((uintptr_t)value << 1) | SCHEME_ELEMENT_FIXNUM_TAG);
+}
+
+/**
+ * Get the value of an immediate small integer.
+ *
+ * @param  element  An immediate element.
+ *
+ * @return Its value.
+ */
+static inline long scheme_element_fixnum_get_value(const scheme_element *element)
+{
+    return (long)((intptr_t)element >> 1);
+}
+
+/**** Cells ****/
+
+// Pairs other than the empty pair are not allocated like other elements.
+// Each one is a cell of two references, with no header, allocated from
+// blocks that hold nothing but cells. Blocks are aligned on their size, so
+// the block of a cell is found by masking its address. The reference count
+// and garbage collector's flags of a cell are kept in arrays at the
+// beginning of its block, so that cells are packed together.
+//
+// A reference to a cell has SCHEME_ELEMENT_CELL_TAG set. It is not a pointer
+// to a struct scheme_element and must never be dereferenced as one. Every
+// function in scheme-element.c and the garbage collector check for one
+// before touching an element's fields.
+
+// Size of a block of cells, in bytes. Blocks are aligned on their size.
+#define SCHEME_ELEMENT_CELL_BLOCK_SIZE (64 * 1024)
+
+// Number of cells in a block.
+#define SCHEME_ELEMENT_CELL_COUNT ((SCHEME_ELEMENT_CELL_BLOCK_SIZE - 64) \
+                                   / (2 * sizeof(scheme_element *) + sizeof(int) + 1))
+
+// Block of cells.
+struct scheme_element_cell_block {
+    // Garbage collector's bookkeeping. Check scheme-gc.c for details.
+    struct scheme_element_cell_block *next;
+    int used;
+    int young;
+    // Number of references held on each cell. A cell that is not in use has
+    // a count of 0.
+    int refCounts[SCHEME_ELEMENT_CELL_COUNT];
+    unsigned char gcFlags[SCHEME_ELEMENT_CELL_COUNT];
+    // First and second element of each cell.
+    scheme_element *cells[SCHEME_ELEMENT_CELL_COUNT][2];
 };
 
+/**
+ * Get the references held by a cell.
+ *
+ * @param  cell  A reference to a cell.
+ *
+ * @return Array of the first and second element of the cell.
+ */
+static inline scheme_element **scheme_element_cell_get_fields(const scheme_element *cell)
+{
+    return (scheme_element **)((uintptr_t)cell & ~SCHEME_ELEMENT_CELL_TAG);
+}
+
+/**
+ * Get the block a cell was allocated from.
+ *
+ * @param  cell  A reference to a cell.
+ *
+ * @return Block of the cell.
+ */
+static inline struct scheme_element_cell_block *scheme_element_cell_get_block(const scheme_element *cell)
+{
+    return (struct scheme_element_cell_block *)((uintptr_t)cell & ~(uintptr_t)(SCHEME_ELEMENT_CELL_BLOCK_SIZE - 1));
+}
+
+/**
+ * Get the index of a cell in its block.
+ *
+ * @param  cell  A reference to a cell.
+ *
+ * @return Index of the cell.
+ */
+static inline int scheme_element_cell_get_index(const scheme_element *cell)
+{
+    struct scheme_element_cell_block *block = scheme_element_cell_get_block(cell);
+    return (int)((scheme_element *(*)[2])scheme_element_cell_get_fields(cell) - block->cells);
+}
+
+/**
+ * Get the virtual function table shared by every cell. Every cell is a
+ * pair, so this is implemented in scheme-pair.c.
+ *
+ * @return Virtual function table of pairs.
+ */
+struct scheme_element_vtable *scheme_pair_get_cell_vtable();
+
 /**** Public functions ****/
 
+/**
+ * Allocate a new reference-counted Scheme element.
+ *
+ * The element starts out with a single reference, owned by the caller.
+ * It is deallocated once that reference and every reference obtained
+ * afterwards with scheme_element_copy() have been released with
+ * scheme_element_free().
+ *
+ * @param  size    Size of the struct of the element's data type.
+ * @param  vtable  Element's virtual function table.
+ * @param  tag     Element's type tag.
+ *
+ * @return Newly allocated element, or NULL if out of memory.
+ */
+scheme_element *scheme_element_new(size_t size, struct scheme_element_vtable *vtable, enum scheme_element_tag tag);
+
 /**
  * Clone an existing virtual function table onto another table.
  *
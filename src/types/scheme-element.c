@@ -1,8 +1,11 @@
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "scheme-data-types.h"
 #include "scheme-element.h"
 #include "scheme-element-private.h"
+#include "scheme-gc.h"
 
 // For scheme_element struct and its virtual function table,
 // please check scheme-element-private.h.
@@ -23,6 +26,15 @@
  */
 static inline int _empty_and_false(scheme_element *first, scheme_element *second);
 
+/**
+ * Get the virtual function table of an allocated Scheme element or a cell.
+ *
+ * @param  element  A Scheme element that is not immediate.
+ *
+ * @return Element's virtual function table.
+ */
+static inline struct scheme_element_vtable *_get_vtable(scheme_element *element);
+
 /**** Private variables ****/
 
 // Global type for generic Scheme elements.
@@ -33,36 +45,81 @@ static struct scheme_element_type _scheme_element_type = {
 
 static inline int _empty_and_false(scheme_element *first, scheme_element *second)
 {
-    return scheme_element_is_type(first, scheme_pair_get_type())
+    return scheme_element_is_pair(first)
         && scheme_pair_is_empty((scheme_pair *)first)
-        && scheme_element_is_type(second, scheme_boolean_get_type())
+        && scheme_element_is_boolean(second)
         && scheme_boolean_get_value((scheme_boolean *)second) == SCHEME_BOOLEAN_VALUE_FALSE;
 }
 
+static inline struct scheme_element_vtable *_get_vtable(scheme_element *element)
+{
+    return scheme_element_is_cell(element) ? scheme_pair_get_cell_vtable() : element->vtable;
+}
+
 /**** Implementations of public functions from scheme-element.h ****/
 
 scheme_element_type *scheme_element_get_type(scheme_element *element)
 {
     if (element == NULL) return NULL;
+    if (scheme_element_is_fixnum(element)) return scheme_number_get_type();
+    if (scheme_element_is_cell(element)) return scheme_pair_get_type();
     return element->vtable->get_type();
 }
 
 void scheme_element_free(scheme_element *element)
 {
     if (element == NULL) return;
+
+    // Immediate and statically allocated elements are not reference counted.
+    if (scheme_element_is_fixnum(element)) return;
+    if (scheme_element_is_cell(element))
+    {
+        if (scheme_gc_is_sweeping()) return;
+
+        int *refCount = &scheme_element_cell_get_block(element)->refCounts[scheme_element_cell_get_index(element)];
+        if (--*refCount > 0) return;
+
+        scheme_pair_get_cell_vtable()->free(element);
+        scheme_gc_release_cell(element);
+        return;
+    }
+    if (element->refCount == 0) return;
+
+    // Unreachable elements being swept by the garbage collector are
+    // deallocated together, regardless of references between them.
+    if (scheme_gc_is_sweeping()) return;
+
+    if (--element->refCount > 0) return;
+
     element->vtable->free(element);
+    scheme_gc_release(element);
 }
 
 void scheme_element_print(scheme_element *element)
 {
     if (element == NULL) return;
-    element->vtable->print(element);
+
+    if (scheme_element_is_fixnum(element))
+    {
+        printf("%ld", scheme_element_fixnum_get_value(element));
+        return;
+    }
+
+    _get_vtable(element)->print(element);
 }
 
 scheme_element *scheme_element_copy(scheme_element *element)
 {
     if (element == NULL) return NULL;
-    return element->vtable->copy(element);
+
+    // Immediate and statically allocated elements are not reference counted.
+    if (scheme_element_is_fixnum(element)) return element;
+    if (scheme_element_is_cell(element))
+        ++scheme_element_cell_get_block(element)->refCounts[scheme_element_cell_get_index(element)];
+    else if (element->refCount > 0)
+        ++element->refCount;
+
+    return element;
 }
 
 int scheme_element_compare(scheme_element *element, scheme_element *other)
@@ -70,11 +127,16 @@ int scheme_element_compare(scheme_element *element, scheme_element *other)
     if (element == NULL) return 0;
     if (other == NULL) return 0;
 
+    // Immediate elements are equal if they hold the same value. An allocated
+    // number only holds values that do not fit in an immediate element.
+    if (scheme_element_is_fixnum(element) || scheme_element_is_fixnum(other))
+        return element == other;
+
     // Special case: If one element is #f and the other is '(), consider them equal.
     if (_empty_and_false(element, other) || _empty_and_false(other, element))
         return 1;
 
-    return element->vtable->compare(element, other);
+    return _get_vtable(element)->compare(element, other);
 }
 
 scheme_element_type *scheme_element_get_base_type()
@@ -102,11 +164,24 @@ int scheme_element_is_type(scheme_element *element, scheme_element_type *type)
 
 /**** Implementations of public functions from scheme-element-private.h ****/
 
+scheme_element *scheme_element_new(size_t size, struct scheme_element_vtable *vtable, enum scheme_element_tag tag)
+{
+    scheme_element *element;
+    if ((element = scheme_gc_allocate(size)) == NULL)
+        return NULL;
+
+    element->vtable = vtable;
+    element->refCount = 1;
+    element->tag = tag;
+
+    return element;
+}
+
 void scheme_element_vtable_clone(struct scheme_element_vtable *target, struct scheme_element_vtable *source)
 {
     target->get_type = source->get_type;
     target->free = source->free;
     target->print = source->print;
-    target->copy = source->copy;
     target->compare = source->compare;
+    target->traverse = source->traverse;
 }
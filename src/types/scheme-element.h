@@ -4,12 +4,231 @@
 #ifndef __SCHEME_ELEMENT_H__
 #define __SCHEME_ELEMENT_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
 // Typedef for Scheme element.
 typedef struct scheme_element scheme_element;
 
 // Typedef for type of a Scheme element.
 typedef struct scheme_element_type scheme_element_type;
 
+// Tags of the Scheme data types that are checked often. Every other data
+// type, such as those defined by modules, is tagged as other and must be
+// checked with scheme_element_is_type().
+enum scheme_element_tag {
+    SCHEME_ELEMENT_TAG_OTHER,
+    SCHEME_ELEMENT_TAG_NUMBER,
+    SCHEME_ELEMENT_TAG_BOOLEAN,
+    SCHEME_ELEMENT_TAG_SYMBOL,
+    SCHEME_ELEMENT_TAG_PAIR,
+    SCHEME_ELEMENT_TAG_PROCEDURE,
+    SCHEME_ELEMENT_TAG_LAMBDA,
+    SCHEME_ELEMENT_TAG_NAMESPACE,
+    SCHEME_ELEMENT_TAG_REFERENCE,
+    SCHEME_ELEMENT_TAG_BYTECODE,
+    SCHEME_ELEMENT_TAG_VOID
+};
+
+/**** Struct definitions ****/
+
+// Scheme element struct definition.
+//
+// It is only defined here so that the type predicates below can be inlined.
+// Its fields should only be used by code declaring a Scheme data type,
+// which includes scheme-element-private.h, and by the garbage collector.
+struct scheme_element {
+    struct scheme_element_vtable *vtable;
+    // Number of references held on this element. Statically allocated
+    // elements keep a count of 0 and are never freed.
+    int refCount;
+    // Tag of the element's data type, a value of enum scheme_element_tag.
+    unsigned char tag;
+    // Garbage collector's bookkeeping. Check scheme-gc.c for details.
+    unsigned char gcFlags;
+    unsigned short gcSize;
+    struct scheme_element *gcPrevious;
+    struct scheme_element *gcNext;
+};
+
+// Bit set in every immediate element. Small integers are not allocated;
+// check scheme-element-private.h for details.
+#define SCHEME_ELEMENT_FIXNUM_TAG ((uintptr_t)1)
+
+// Bit set in every reference to a cell, in which pairs other than the empty
+// pair are stored; check scheme-element-private.h for details.
+#define SCHEME_ELEMENT_CELL_TAG ((uintptr_t)2)
+
+/**** Type predicates ****/
+
+/**
+ * Check if a Scheme element is an immediate small integer.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_fixnum(const scheme_element *element)
+{
+    return ((uintptr_t)element & SCHEME_ELEMENT_FIXNUM_TAG) != 0;
+}
+
+/**
+ * Check if a Scheme element is a reference to a cell, that is a pair other
+ * than the empty pair.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_cell(const scheme_element *element)
+{
+    return ((uintptr_t)element & (SCHEME_ELEMENT_FIXNUM_TAG | SCHEME_ELEMENT_CELL_TAG)) == SCHEME_ELEMENT_CELL_TAG;
+}
+
+/**
+ * Get the tag of a Scheme element's data type.
+ *
+ * Unlike scheme_element_get_type(), this neither calls a virtual function
+ * nor follows super types. A lambda procedure is tagged as a lambda
+ * procedure only.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return Element's tag, or SCHEME_ELEMENT_TAG_OTHER if it is NULL.
+ */
+static inline enum scheme_element_tag scheme_element_get_tag(const scheme_element *element)
+{
+    if (element == NULL) return SCHEME_ELEMENT_TAG_OTHER;
+    if (scheme_element_is_fixnum(element)) return SCHEME_ELEMENT_TAG_NUMBER;
+    if (scheme_element_is_cell(element)) return SCHEME_ELEMENT_TAG_PAIR;
+    return (enum scheme_element_tag)element->tag;
+}
+
+/**
+ * Check if a Scheme element is a number.
+ *
+ * Same as scheme_element_is_number(element), but
+ * does not call any function. The following predicates are likewise.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_number(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_NUMBER;
+}
+
+/**
+ * Check if a Scheme element is a boolean symbol.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_boolean(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_BOOLEAN;
+}
+
+/**
+ * Check if a Scheme element is a symbol.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_symbol(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_SYMBOL;
+}
+
+/**
+ * Check if a Scheme element is a pair, including the empty pair.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_pair(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_PAIR;
+}
+
+/**
+ * Check if a Scheme element is a procedure, including lambda procedures.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_procedure(const scheme_element *element)
+{
+    enum scheme_element_tag tag = scheme_element_get_tag(element);
+    return tag == SCHEME_ELEMENT_TAG_PROCEDURE || tag == SCHEME_ELEMENT_TAG_LAMBDA;
+}
+
+/**
+ * Check if a Scheme element is a lambda procedure.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_lambda(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_LAMBDA;
+}
+
+/**
+ * Check if a Scheme element is a namespace.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_namespace(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_NAMESPACE;
+}
+
+/**
+ * Check if a Scheme element is a variable reference.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_reference(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_REFERENCE;
+}
+
+/**
+ * Check if a Scheme element is bytecode.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_bytecode(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_BYTECODE;
+}
+
+/**
+ * Check if a Scheme element is the void symbol.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int scheme_element_is_void(const scheme_element *element)
+{
+    return scheme_element_get_tag(element) == SCHEME_ELEMENT_TAG_VOID;
+}
+
 /**** Virtual functions ****/
 
 /**
@@ -24,11 +243,16 @@ typedef struct scheme_element_type scheme_element_type;
 scheme_element_type *scheme_element_get_type(scheme_element *element);
 
 /**
- * Free previously allocated Scheme element.
+ * Release a reference to a Scheme element.
+ *
+ * Scheme elements are reference counted. An element is deallocated once
+ * every reference to it has been released, at which point it also
+ * releases its references to other elements.
  *
  * A Scheme element is usually initialized using a Scheme data type's
- * specific initializer function. Notes on freeing such an element
- * will be found in the function's documentation.
+ * specific initializer function, which hands the caller one reference.
+ * Notes on freeing such an element will be found in the function's
+ * documentation.
  *
  * @param  element  A Scheme element.
  */
@@ -43,12 +267,18 @@ void scheme_element_print(scheme_element *element);
 
 /**
  * Copy Scheme element.
+ *
+ * Scheme elements are never modified after they have been created, so
+ * this does not duplicate the element. It acquires a new reference to
+ * the same element instead, which takes constant time regardless of the
+ * element's size.
+ *
  * Copy need to be freed with scheme_element_free() unless otherwise
  * noted in a Scheme data type's header file.
  *
  * @param  element  A Scheme element.
  *
- * @result A copy or NULL if out of memory.
+ * @result The given element.
  */
 scheme_element *scheme_element_copy(scheme_element *element);
 
@@ -78,6 +308,9 @@ scheme_element_type *scheme_element_get_base_type();
  * can be passed as a parameter to any function that expects a parameter
  * of the given type.
  *
+ * This walks the chain of super types. The built-in data types are
+ * checked faster with the type predicates above.
+ *
  * @param  element  A Scheme element.
  * @param  type     A type.
  *
@@ -0,0 +1,1208 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "scheme-gc.h"
+#include "scheme-namespace.h"
+#include "scheme-element-private.h"
+
+// Minimum number of old space allocations between two major collections.
+#define SCHEME_GC_MINIMUM_THRESHOLD 4096
+
+// Default size of the nursery, in bytes.
+#define SCHEME_GC_DEFAULT_NURSERY_SIZE (256 * 1024)
+
+// Initial capacity of the collector's arrays.
+#define SCHEME_GC_INITIAL_SIZE 64
+
+// Alignment of elements allocated in the nursery.
+#define SCHEME_GC_ALIGNMENT 8
+
+// Size of a slab, from which pools allocate, in bytes.
+#define SCHEME_GC_SLAB_SIZE (16 * 1024)
+// Difference between the sizes of two consecutive size classes, in bytes.
+#define SCHEME_GC_POOL_GRANULARITY 16
+// Number of size classes. Larger old elements are allocated with malloc().
+#define SCHEME_GC_POOL_COUNT 16
+// Largest allocation made from the permanent pool. Larger ones are made
+// with malloc().
+#define SCHEME_GC_PERMANENT_LIMIT (SCHEME_GC_SLAB_SIZE / 8)
+
+// Element lives in the nursery.
+#define SCHEME_GC_YOUNG 0x01
+// Young element was released, its memory is reclaimed by the next minor
+// collection.
+#define SCHEME_GC_RELEASED 0x02
+// Young element was promoted, gcNext points to its copy in the old space.
+// Young cells that were promoted have their first element point to their
+// copy instead.
+#define SCHEME_GC_FORWARDED 0x04
+// Old element was allocated since the last minor collection and may refer to
+// young elements.
+#define SCHEME_GC_RECENT 0x08
+// Old element is in the remembered set.
+#define SCHEME_GC_REMEMBERED 0x10
+// Old element is reachable from a root.
+#define SCHEME_GC_MARKED 0x20
+
+/*
+ * Memory is split into two spaces:
+ *
+ *   - The nursery, a single block from which elements are allocated by
+ *     bumping a pointer. Released young elements are not deallocated
+ *     individually: a minor collection copies the young elements reachable
+ *     from a root into the old space, rewrites references to them, and
+ *     resets the nursery.
+ *   - The old space, where each element is allocated with malloc() and kept
+ *     in a doubly linked list. Elements that do not fit in the nursery are
+ *     allocated here directly. A major collection marks every old element
+ *     reachable from a root and deallocates the others.
+ *
+ * Old elements of up to SCHEME_GC_POOL_COUNT * SCHEME_GC_POOL_GRANULARITY
+ * bytes are allocated from a pool per size class rather than with malloc().
+ * A pool carves elements of its size out of slabs, and keeps deallocated
+ * elements on a free list, linked through their first word, from which it
+ * allocates first. Slabs are never returned to the system.
+ *
+ * Pairs are stored in cells instead, allocated from blocks of cells kept in
+ * a list. Cells are never moved. A released cell is put on a free list, from
+ * which new cells are taken before the last block is extended. A major
+ * collection marks cells like old elements, puts unreachable cells on the
+ * free list and deallocates blocks left without any cell in use.
+ *
+ * In arena mode, set with scheme_gc_set_arena(), cells are allocated from
+ * blocks of young cells instead, which act as a second nursery: a minor
+ * collection copies the young cells reachable from a root into old blocks,
+ * then resets the young blocks at once, whether their cells were released
+ * or not. Only the block being extended is kept.
+ *
+ * Young elements can only be moved when no C variable outside of the roots
+ * and handles refers to them, which is why collections never happen on their
+ * own. Once the nursery is full, allocations fall back to the old space until
+ * the next minor collection.
+ *
+ * Old elements that refer to young elements are found through:
+ *
+ *   - The SCHEME_GC_RECENT flag, set on old elements allocated since the last
+ *     minor collection. These sit at the front of the list of old elements.
+ *   - The remembered set, which receives older elements that are made to
+ *     refer to young elements through scheme_gc_write_barrier().
+ *   - The remembered cells, which receive cells that refer to young elements
+ *     when they are allocated. Cells are never modified afterwards.
+ */
+
+/**** Private variables ****/
+
+// Nursery.
+static char *_nursery = NULL;
+static size_t _nurserySize = SCHEME_GC_DEFAULT_NURSERY_SIZE;
+static size_t _nurseryUsed = 0;
+
+// Pool of memory blocks of the same size.
+struct _pool {
+    // Size of a block, in bytes.
+    size_t size;
+    // Deallocated blocks, linked through their first word.
+    void *freeList;
+    // Unused memory left in the last slab.
+    char *next;
+    char *end;
+    // Statistics.
+    int slabCount;
+    int useCount;
+    int maxUseCount;
+};
+
+// Pools of old elements, one per size class.
+static struct _pool _pools[SCHEME_GC_POOL_COUNT];
+
+// Old elements too large for any pool.
+static int _largeCount = 0;
+
+// Pool of memory that is never deallocated. Its blocks have various sizes,
+// so it never uses its free list.
+static struct _pool _permanentPool;
+
+// List of every element in the old space.
+static scheme_element *_elements = NULL;
+// Number of elements in list.
+static int _elementCount = 0;
+
+// Number of elements allocated in the old space since the last major
+// collection.
+static int _allocationCount = 0;
+// Number of allocations that triggers a major collection.
+static int _threshold = SCHEME_GC_MINIMUM_THRESHOLD;
+
+// Number of elements allocated in the old space because the nursery was full,
+// since the last minor collection.
+static int _overflowCount = 0;
+
+// Variables registered as roots.
+static scheme_element ***_roots = NULL;
+static int _rootCount = 0;
+static int _rootSize = 0;
+
+// Variables registered as handles.
+static scheme_element ***_handles = NULL;
+static int _handleCount = 0;
+static int _handleSize = 0;
+
+// Old elements that may refer to young elements.
+static scheme_element **_remembered = NULL;
+static int _rememberedCount = 0;
+static int _rememberedSize = 0;
+
+// Blocks of cells, the one being extended first.
+static struct scheme_element_cell_block *_blocks = NULL;
+static int _blockCount = 0;
+// Released cells, linked through their first element.
+static scheme_element **_freeCells = NULL;
+// Number of cells in use.
+static int _cellCount = 0;
+
+// Blocks of young cells, allocated in arena mode, the one being extended
+// first.
+static struct scheme_element_cell_block *_youngBlocks = NULL;
+static int _youngBlockCount = 0;
+// Released young cells, linked through their first element.
+static scheme_element **_freeYoungCells = NULL;
+// Number of young cells allocated since the last minor collection.
+static int _youngCellCount = 0;
+
+// Set if cells are allocated as young cells.
+static int _arena = 0;
+
+// Cells that may refer to young elements.
+static scheme_element **_rememberedCells = NULL;
+static int _rememberedCellCount = 0;
+static int _rememberedCellSize = 0;
+
+// Elements whose references have not been visited yet.
+static scheme_element **_markStack = NULL;
+static int _markCount = 0;
+static int _markSize = 0;
+
+// Set while unreachable elements are being deallocated.
+static int _sweeping = 0;
+
+// Statistics.
+static struct {
+    long minorCount;
+    long minorTime;
+    long minorMaxTime;
+    long promotedCount;
+    long majorCount;
+    long majorTime;
+    long majorMaxTime;
+    long sweptCount;
+    long youngCount;
+    long overflowCount;
+    int maxCellCount;
+    int maxBlockCount;
+    long youngCellCount;
+    long promotedCellCount;
+    int maxYoungBlockCount;
+} _stats;
+
+/**** Private function declarations ****/
+
+/**
+ * Ensure that a growable array can hold at least the given number of items.
+ *
+ * @param  array     Address of array.
+ * @param  size      Address of array's capacity.
+ * @param  count     Number of items array has to hold.
+ * @param  itemSize  Size of an item.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _reserve(void **array, int *size, int count, size_t itemSize);
+
+/**
+ * Get time elapsed since an arbitrary point, in microseconds.
+ *
+ * @return Time in microseconds.
+ */
+static long _now();
+
+/**
+ * Take memory for a block from a pool, adding a slab to the pool if needed.
+ *
+ * @param  pool  A pool.
+ * @param  size  Size of block, the pool's block size unless the pool is the
+ *               permanent pool.
+ *
+ * @return Memory for the block, or NULL if out of memory.
+ */
+static void *_pool_take(struct _pool *pool, size_t size);
+
+/**
+ * Allocate memory for an old element, from the pool of its size class if
+ * there is one.
+ *
+ * @param  size  Size of element.
+ *
+ * @return Memory for the element, or NULL if out of memory.
+ */
+static void *_old_malloc(size_t size);
+
+/**
+ * Deallocate memory of an old element allocated by _old_malloc().
+ *
+ * @param  element  An old element, whose gcSize field is still set.
+ */
+static void _old_free(scheme_element *element);
+
+/**
+ * Allocate memory for an element in the old space and start tracking it.
+ *
+ * @param  size  Size of element.
+ *
+ * @return An element with only its garbage collector fields set,
+ *         or NULL if out of memory.
+ */
+static scheme_element *_allocate_old(size_t size);
+
+/**
+ * Stop tracking an old element that is about to be deallocated.
+ *
+ * @param  element  An old element.
+ */
+static void _untrack(scheme_element *element);
+
+/**
+ * Check if an element lives in the nursery.
+ *
+ * @param  element  A Scheme element.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+static inline int _is_young(scheme_element *element);
+
+/**
+ * Take an unused cell, from the free list or by extending the first block.
+ *
+ * @param  young  1 to take a young cell, 0 to take an old cell.
+ *
+ * @return First and second element of the cell, or NULL if out of memory.
+ */
+static scheme_element **_take_cell(int young);
+
+/**
+ * Promote a young cell, if it has not been promoted yet, and rewrite a
+ * reference to it. Its fields are scanned later.
+ *
+ * @param  reference  Address of a reference to a young cell.
+ */
+static void _evacuate_cell(scheme_element **reference);
+
+/**
+ * Reset the blocks of young cells, deallocating all but the block being
+ * extended.
+ */
+static void _reset_young_cells();
+
+/**
+ * Pass references held by an element or a cell to a visitor.
+ *
+ * @param  element  A Scheme element that is not immediate.
+ * @param  visit    A visitor.
+ */
+static void _traverse(scheme_element *element, scheme_element_visitor_t visit);
+
+/**
+ * Queue an element so that its references are visited by _scan_pending().
+ *
+ * @param  element  A Scheme element.
+ * @param  visit    Visitor to call directly if the queue cannot grow.
+ */
+static void _push_pending(scheme_element *element, scheme_element_visitor_t visit);
+
+/**
+ * Visit references held by every queued element until none is left.
+ *
+ * @param  visit  A visitor.
+ */
+static void _scan_pending(scheme_element_visitor_t visit);
+
+/**
+ * Move a young element referred to by a reference into the old space and
+ * update the reference.
+ * Used as visitor for the virtual function 'traverse'.
+ *
+ * @param  reference  Address of a reference.
+ */
+static void _evacuate(scheme_element **reference);
+
+/**
+ * Move every young element reachable from a root into the old space, then
+ * reset the nursery.
+ */
+static void _collect_minor();
+
+/**
+ * Release resources owned by young elements that are neither released nor
+ * promoted.
+ *
+ * @return Number of such elements.
+ */
+static int _finalize_nursery();
+
+/**
+ * Mark an old element as reachable, if it has not been marked yet.
+ *
+ * @param  element  A Scheme element.
+ */
+static void _mark(scheme_element *element);
+
+/**
+ * Mark element referred to by a reference.
+ * Used as visitor for the virtual function 'traverse'.
+ *
+ * @param  reference  Address of a reference.
+ */
+static void _visit(scheme_element **reference);
+
+/**
+ * Deallocate every old element that cannot be reached from a root.
+ * The nursery must be empty.
+ *
+ * @return Number of deallocated elements.
+ */
+static int _collect_major();
+
+/**
+ * Deallocate every unmarked old element and clear marks on the others.
+ *
+ * @return Number of deallocated elements.
+ */
+static int _sweep();
+
+/**
+ * Release every unmarked cell and clear marks on the others, rebuild the
+ * free list, and deallocate blocks whose cells are all released.
+ *
+ * @return Number of released cells.
+ */
+static int _sweep_cells();
+
+/**** Private function implementations ****/
+
+static int _reserve(void **array, int *size, int count, size_t itemSize)
+{
+    if (count <= *size) return 1;
+
+    int newSize = *size > 0 ? *size : SCHEME_GC_INITIAL_SIZE;
+    while (newSize < count)
+        newSize *= 2;
+
+    void *newArray = realloc(*array, itemSize * newSize);
+    if (newArray == NULL) return 0;
+
+    *array = newArray;
+    *size = newSize;
+    return 1;
+}
+
+static long _now()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1000000L + time.tv_nsec / 1000L;
+}
+
+static void *_pool_take(struct _pool *pool, size_t size)
+{
+    void *block;
+    if (pool->freeList != NULL)
+    {
+        block = pool->freeList;
+        pool->freeList = *(void **)block;
+    }
+    else
+    {
+        if (pool->next == NULL || (size_t)(pool->end - pool->next) < size)
+        {
+            // The rest of the last slab is wasted, which is less than a
+            // block of the pool.
+            char *slab;
+            if ((slab = malloc(SCHEME_GC_SLAB_SIZE)) == NULL)
+                return NULL;
+
+            pool->next = slab;
+            pool->end = slab + SCHEME_GC_SLAB_SIZE;
+            ++pool->slabCount;
+        }
+
+        block = pool->next;
+        pool->next += size;
+    }
+
+    if (++pool->useCount > pool->maxUseCount)
+        pool->maxUseCount = pool->useCount;
+
+    return block;
+}
+
+static void *_old_malloc(size_t size)
+{
+    if (size > SCHEME_GC_POOL_COUNT * SCHEME_GC_POOL_GRANULARITY)
+    {
+        void *block;
+        if ((block = malloc(size)) != NULL)
+            ++_largeCount;
+
+        return block;
+    }
+
+    struct _pool *pool = &_pools[(size - 1) / SCHEME_GC_POOL_GRANULARITY];
+    if (pool->size == 0)
+        pool->size = ((size - 1) / SCHEME_GC_POOL_GRANULARITY + 1) * SCHEME_GC_POOL_GRANULARITY;
+
+    return _pool_take(pool, pool->size);
+}
+
+static void _old_free(scheme_element *element)
+{
+    size_t size = element->gcSize;
+    if (size > SCHEME_GC_POOL_COUNT * SCHEME_GC_POOL_GRANULARITY)
+    {
+        free(element);
+        --_largeCount;
+        return;
+    }
+
+    struct _pool *pool = &_pools[(size - 1) / SCHEME_GC_POOL_GRANULARITY];
+    *(void **)element = pool->freeList;
+    pool->freeList = element;
+    --pool->useCount;
+}
+
+static scheme_element *_allocate_old(size_t size)
+{
+    scheme_element *element;
+    if ((element = _old_malloc(size)) == NULL)
+        return NULL;
+
+    element->gcFlags = 0;
+    element->gcSize = size;
+    element->gcPrevious = NULL;
+    element->gcNext = _elements;
+
+    if (_elements != NULL)
+        _elements->gcPrevious = element;
+    _elements = element;
+
+    ++_elementCount;
+    ++_allocationCount;
+
+    return element;
+}
+
+static void _untrack(scheme_element *element)
+{
+    if (element->gcPrevious != NULL)
+        element->gcPrevious->gcNext = element->gcNext;
+    else
+        _elements = element->gcNext;
+
+    if (element->gcNext != NULL)
+        element->gcNext->gcPrevious = element->gcPrevious;
+
+    --_elementCount;
+}
+
+static inline int _is_young(scheme_element *element)
+{
+    if (element == NULL || scheme_element_is_fixnum(element)) return 0;
+    if (scheme_element_is_cell(element)) return scheme_element_cell_get_block(element)->young;
+    return (element->gcFlags & SCHEME_GC_YOUNG) != 0;
+}
+
+static scheme_element **_take_cell(int young)
+{
+    struct scheme_element_cell_block **blocks = young ? &_youngBlocks : &_blocks;
+    scheme_element ***freeCells = young ? &_freeYoungCells : &_freeCells;
+
+    scheme_element **fields;
+    if (*freeCells != NULL)
+    {
+        fields = *freeCells;
+        *freeCells = (scheme_element **)fields[0];
+        return fields;
+    }
+
+    if (*blocks == NULL || (*blocks)->used == (int)SCHEME_ELEMENT_CELL_COUNT)
+    {
+        struct scheme_element_cell_block *block;
+        if (posix_memalign((void **)&block, SCHEME_ELEMENT_CELL_BLOCK_SIZE, sizeof(struct scheme_element_cell_block)) != 0)
+            return NULL;
+
+        block->next = *blocks;
+        block->used = 0;
+        block->young = young;
+        *blocks = block;
+
+        if (young)
+        {
+            if (++_youngBlockCount > _stats.maxYoungBlockCount)
+                _stats.maxYoungBlockCount = _youngBlockCount;
+        }
+        else
+        {
+            if (++_blockCount > _stats.maxBlockCount)
+                _stats.maxBlockCount = _blockCount;
+        }
+    }
+
+    fields = (*blocks)->cells[(*blocks)->used++];
+    if (!young)
+        ++_allocationCount;
+
+    return fields;
+}
+
+static void _evacuate_cell(scheme_element **reference)
+{
+    scheme_element *cell = *reference;
+    struct scheme_element_cell_block *block = scheme_element_cell_get_block(cell);
+    int index = scheme_element_cell_get_index(cell);
+    scheme_element **fields = scheme_element_cell_get_fields(cell);
+
+    if (block->gcFlags[index] & SCHEME_GC_FORWARDED)
+    {
+        *reference = fields[0];
+        return;
+    }
+
+    // Released cells have nothing left to promote, as with young elements.
+    if (block->refCounts[index] == 0) return;
+
+    scheme_element **copyFields;
+    if ((copyFields = _take_cell(0)) == NULL)
+    {
+        fprintf(stderr, "Out of memory while promoting young elements.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    copyFields[0] = fields[0];
+    copyFields[1] = fields[1];
+
+    scheme_element *copy = (scheme_element *)((uintptr_t)copyFields | SCHEME_ELEMENT_CELL_TAG);
+    struct scheme_element_cell_block *copyBlock = scheme_element_cell_get_block(copy);
+    int copyIndex = scheme_element_cell_get_index(copy);
+    copyBlock->refCounts[copyIndex] = block->refCounts[index];
+    copyBlock->gcFlags[copyIndex] = 0;
+    if (++_cellCount > _stats.maxCellCount)
+        _stats.maxCellCount = _cellCount;
+
+    block->gcFlags[index] |= SCHEME_GC_FORWARDED;
+    fields[0] = copy;
+    *reference = copy;
+
+    ++_stats.promotedCellCount;
+
+    _push_pending(copy, _evacuate);
+}
+
+static void _reset_young_cells()
+{
+    while (_youngBlocks != NULL && _youngBlocks->next != NULL)
+    {
+        struct scheme_element_cell_block *block = _youngBlocks->next;
+        _youngBlocks->next = block->next;
+        free(block);
+        --_youngBlockCount;
+    }
+
+    if (_youngBlocks != NULL)
+        _youngBlocks->used = 0;
+
+    _freeYoungCells = NULL;
+    _stats.youngCellCount += _youngCellCount;
+    _youngCellCount = 0;
+}
+
+static void _traverse(scheme_element *element, scheme_element_visitor_t visit)
+{
+    if (scheme_element_is_cell(element))
+    {
+        scheme_element **fields = scheme_element_cell_get_fields(element);
+        visit(&fields[0]);
+        visit(&fields[1]);
+    }
+    else
+    {
+        element->vtable->traverse(element, visit);
+    }
+}
+
+static void _push_pending(scheme_element *element, scheme_element_visitor_t visit)
+{
+    if (!scheme_element_is_cell(element) && element->vtable->traverse == NULL) return;
+
+    if (_reserve((void **)&_markStack, &_markSize, _markCount + 1, sizeof(scheme_element *)))
+    {
+        _markStack[_markCount++] = element;
+    }
+    else
+    {
+        // Out of memory, fall back to recursion.
+        _traverse(element, visit);
+    }
+}
+
+static void _scan_pending(scheme_element_visitor_t visit)
+{
+    while (_markCount > 0)
+    {
+        scheme_element *element = _markStack[--_markCount];
+        _traverse(element, visit);
+    }
+}
+
+static void _evacuate(scheme_element **reference)
+{
+    scheme_element *element = *reference;
+    if (!_is_young(element)) return;
+
+    if (scheme_element_is_cell(element))
+    {
+        _evacuate_cell(reference);
+        return;
+    }
+
+    if (element->gcFlags & SCHEME_GC_FORWARDED)
+    {
+        *reference = element->gcNext;
+        return;
+    }
+
+    // A released element cannot be reachable unless a reference was kept
+    // without being counted. There is nothing left to promote.
+    if (element->gcFlags & SCHEME_GC_RELEASED) return;
+
+    scheme_element *copy;
+    if ((copy = _allocate_old(element->gcSize)) == NULL)
+    {
+        fprintf(stderr, "Out of memory while promoting young elements.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy everything but the garbage collector fields.
+    size_t headerSize = offsetof(struct scheme_element, gcFlags);
+    memcpy(copy, element, headerSize);
+    memcpy((char *)copy + sizeof(struct scheme_element),
+           (char *)element + sizeof(struct scheme_element),
+           element->gcSize - sizeof(struct scheme_element));
+
+    element->gcFlags |= SCHEME_GC_FORWARDED;
+    element->gcNext = copy;
+    *reference = copy;
+
+    ++_stats.promotedCount;
+
+    _push_pending(copy, _evacuate);
+}
+
+static void _collect_minor()
+{
+    long start = _now();
+
+    // Old elements allocated since the last minor collection are at the
+    // front of the list, ahead of the copies made below.
+    scheme_element *element;
+    for (element = _elements; element != NULL && (element->gcFlags & SCHEME_GC_RECENT); element = element->gcNext)
+    {
+        element->gcFlags &= ~SCHEME_GC_RECENT;
+        _push_pending(element, _evacuate);
+    }
+
+    for (int i = 0; i < _rememberedCount; ++i)
+    {
+        _remembered[i]->gcFlags &= ~SCHEME_GC_REMEMBERED;
+        _push_pending(_remembered[i], _evacuate);
+    }
+    _rememberedCount = 0;
+
+    // Remembered cells may have been released since, and even reused.
+    for (int i = 0; i < _rememberedCellCount; ++i)
+    {
+        scheme_element *cell = _rememberedCells[i];
+        if (scheme_element_cell_get_block(cell)->refCounts[scheme_element_cell_get_index(cell)] > 0)
+            _push_pending(cell, _evacuate);
+    }
+    _rememberedCellCount = 0;
+
+    for (int i = 0; i < _rootCount; ++i)
+        _evacuate(_roots[i]);
+
+    for (int i = 0; i < _handleCount; ++i)
+        _evacuate(_handles[i]);
+
+    _scan_pending(_evacuate);
+
+    _stats.youngCount += _finalize_nursery();
+    _nurseryUsed = 0;
+    _overflowCount = 0;
+
+    if (_youngCellCount > 0)
+        _reset_young_cells();
+
+    // Inline caches may refer to elements that were moved.
+    scheme_namespace_invalidate_caches();
+
+    long time = _now() - start;
+    ++_stats.minorCount;
+    _stats.minorTime += time;
+    if (time > _stats.minorMaxTime)
+        _stats.minorMaxTime = time;
+}
+
+static int _finalize_nursery()
+{
+    int count = 0;
+
+    _sweeping = 1;
+    size_t offset = 0;
+    while (offset < _nurseryUsed)
+    {
+        scheme_element *element = (scheme_element *)(_nursery + offset);
+        if (!(element->gcFlags & (SCHEME_GC_RELEASED | SCHEME_GC_FORWARDED)))
+            element->vtable->free(element);
+
+        if (!(element->gcFlags & SCHEME_GC_FORWARDED))
+            ++count;
+
+        offset += (element->gcSize + SCHEME_GC_ALIGNMENT - 1) & ~(size_t)(SCHEME_GC_ALIGNMENT - 1);
+    }
+    _sweeping = 0;
+
+    return count;
+}
+
+static void _mark(scheme_element *element)
+{
+    // Immediate and statically allocated elements are never collected.
+    if (element == NULL || scheme_element_is_fixnum(element)) return;
+    if (scheme_element_is_cell(element))
+    {
+        struct scheme_element_cell_block *block = scheme_element_cell_get_block(element);
+        int index = scheme_element_cell_get_index(element);
+        if (block->gcFlags[index] & SCHEME_GC_MARKED) return;
+
+        block->gcFlags[index] |= SCHEME_GC_MARKED;
+        _push_pending(element, _visit);
+        return;
+    }
+    if (element->refCount == 0) return;
+    if (element->gcFlags & SCHEME_GC_MARKED) return;
+
+    element->gcFlags |= SCHEME_GC_MARKED;
+    _push_pending(element, _visit);
+}
+
+static void _visit(scheme_element **reference)
+{
+    _mark(*reference);
+}
+
+static int _collect_major()
+{
+    long start = _now();
+
+    // Mark every element reachable from a root.
+    for (int i = 0; i < _rootCount; ++i)
+    {
+        _mark(*_roots[i]);
+        _scan_pending(_visit);
+    }
+
+    for (int i = 0; i < _handleCount; ++i)
+    {
+        _mark(*_handles[i]);
+        _scan_pending(_visit);
+    }
+
+    int count = _sweep();
+    if (count > 0)
+        scheme_namespace_invalidate_caches();
+    count += _sweep_cells();
+
+    // Schedule next collection.
+    int liveCount = _elementCount + _cellCount;
+    _allocationCount = 0;
+    _threshold = liveCount > SCHEME_GC_MINIMUM_THRESHOLD ? liveCount : SCHEME_GC_MINIMUM_THRESHOLD;
+
+    long time = _now() - start;
+    ++_stats.majorCount;
+    _stats.majorTime += time;
+    if (time > _stats.majorMaxTime)
+        _stats.majorMaxTime = time;
+    _stats.sweptCount += count;
+
+    return count;
+}
+
+static int _sweep()
+{
+    // Unlink unreachable elements.
+    scheme_element *unreachable = NULL;
+    scheme_element *element = _elements;
+    while (element != NULL)
+    {
+        scheme_element *next = element->gcNext;
+
+        if (element->gcFlags & SCHEME_GC_MARKED)
+        {
+            element->gcFlags &= ~SCHEME_GC_MARKED;
+        }
+        else
+        {
+            _untrack(element);
+            element->gcNext = unreachable;
+            unreachable = element;
+        }
+
+        element = next;
+    }
+
+    // Release resources owned by unreachable elements. References between
+    // them are ignored while sweeping, so every one of them must still be
+    // allocated at this point.
+    _sweeping = 1;
+    for (element = unreachable; element != NULL; element = element->gcNext)
+    {
+        element->vtable->free(element);
+    }
+    _sweeping = 0;
+
+    // Deallocate them.
+    int count = 0;
+    while (unreachable != NULL)
+    {
+        scheme_element *next = unreachable->gcNext;
+        _old_free(unreachable);
+        unreachable = next;
+        ++count;
+    }
+
+    return count;
+}
+
+static int _sweep_cells()
+{
+    int count = 0;
+
+    _freeCells = NULL;
+    struct scheme_element_cell_block **link = &_blocks;
+    while (*link != NULL)
+    {
+        struct scheme_element_cell_block *block = *link;
+        scheme_element **freeCells = _freeCells;
+        int used = 0;
+
+        // Walk backwards so that cells are reused in the order they are laid
+        // out.
+        for (int i = block->used - 1; i >= 0; --i)
+        {
+            if (block->refCounts[i] > 0 && !(block->gcFlags[i] & SCHEME_GC_MARKED))
+            {
+                block->refCounts[i] = 0;
+                --_cellCount;
+                ++count;
+            }
+
+            block->gcFlags[i] = 0;
+            if (block->refCounts[i] > 0)
+            {
+                ++used;
+            }
+            else
+            {
+                block->cells[i][0] = (scheme_element *)freeCells;
+                freeCells = block->cells[i];
+            }
+        }
+
+        // The block being extended is kept even if it is empty.
+        if (used == 0 && block != _blocks)
+        {
+            *link = block->next;
+            free(block);
+            --_blockCount;
+            continue;
+        }
+
+        _freeCells = freeCells;
+        link = &block->next;
+    }
+
+    return count;
+}
+
+/**** Public function implementations ****/
+
+void scheme_gc_add_root(scheme_element **root)
+{
+    if (!_reserve((void **)&_roots, &_rootSize, _rootCount + 1, sizeof(scheme_element **)))
+        return;
+
+    _roots[_rootCount++] = root;
+}
+
+void scheme_gc_remove_root(scheme_element **root)
+{
+    for (int i = _rootCount - 1; i >= 0; --i)
+    {
+        if (_roots[i] == root)
+        {
+            _roots[i] = _roots[--_rootCount];
+            return;
+        }
+    }
+}
+
+void scheme_gc_push_handle(scheme_element **handle)
+{
+    if (!_reserve((void **)&_handles, &_handleSize, _handleCount + 1, sizeof(scheme_element **)))
+        return;
+
+    _handles[_handleCount++] = handle;
+}
+
+void scheme_gc_pop_handles(int count)
+{
+    _handleCount -= count;
+    if (_handleCount < 0)
+        _handleCount = 0;
+}
+
+int scheme_gc_collect()
+{
+    if (_nurseryUsed > 0 || _youngCellCount > 0 || _rememberedCount > 0 || _rememberedCellCount > 0)
+        _collect_minor();
+
+    return _collect_major();
+}
+
+int scheme_gc_collect_if_needed()
+{
+    if (_nurseryUsed > 0 && (_nurseryUsed >= _nurserySize / 2 || _overflowCount > 0))
+        _collect_minor();
+
+    if (_allocationCount < _threshold)
+        return 0;
+
+    if (_nurseryUsed > 0 || _youngCellCount > 0)
+        _collect_minor();
+
+    return _collect_major();
+}
+
+int scheme_gc_end_form()
+{
+    _collect_minor();
+
+    if (_allocationCount < _threshold)
+        return 0;
+
+    return _collect_major();
+}
+
+void scheme_gc_write_barrier(scheme_element *container, scheme_element *element)
+{
+    if (!_is_young(element)) return;
+
+    // Young, static, recent and already remembered elements are scanned
+    // anyway.
+    if (container->refCount == 0) return;
+    if (container->gcFlags & (SCHEME_GC_YOUNG | SCHEME_GC_RECENT | SCHEME_GC_REMEMBERED)) return;
+
+    if (!_reserve((void **)&_remembered, &_rememberedSize, _rememberedCount + 1, sizeof(scheme_element *)))
+        return;
+
+    container->gcFlags |= SCHEME_GC_REMEMBERED;
+    _remembered[_rememberedCount++] = container;
+}
+
+void scheme_gc_set_arena(int enabled)
+{
+    _arena = enabled;
+}
+
+void scheme_gc_set_nursery_size(size_t size)
+{
+    if (_nurseryUsed > 0) return;
+
+    free(_nursery);
+    _nursery = NULL;
+    _nurserySize = size;
+}
+
+void scheme_gc_print_stats()
+{
+    fprintf(stderr, "Nursery size: %lu bytes\n", (unsigned long)_nurserySize);
+    fprintf(stderr, "Minor collections: %ld (total %ld us, max %ld us)\n",
+            _stats.minorCount, _stats.minorTime, _stats.minorMaxTime);
+    fprintf(stderr, "  Elements promoted: %ld\n", _stats.promotedCount);
+    fprintf(stderr, "  Elements reclaimed: %ld\n", _stats.youngCount);
+    fprintf(stderr, "  Allocations past a full nursery: %ld\n", _stats.overflowCount);
+    fprintf(stderr, "Major collections: %ld (total %ld us, max %ld us)\n",
+            _stats.majorCount, _stats.majorTime, _stats.majorMaxTime);
+    fprintf(stderr, "  Elements deallocated: %ld\n", _stats.sweptCount);
+    fprintf(stderr, "Pair cells: %d in use (max %d), %lu bytes per cell\n",
+            _cellCount, _stats.maxCellCount,
+            (unsigned long)(SCHEME_ELEMENT_CELL_BLOCK_SIZE / SCHEME_ELEMENT_CELL_COUNT));
+    fprintf(stderr, "  Blocks of %d cells: %d (max %d)\n",
+            (int)SCHEME_ELEMENT_CELL_COUNT, _blockCount, _stats.maxBlockCount);
+    if (_stats.maxYoungBlockCount > 0)
+    {
+        fprintf(stderr, "Young pair cells: %ld allocated, %ld promoted\n",
+                _stats.youngCellCount + _youngCellCount, _stats.promotedCellCount);
+        fprintf(stderr, "  Blocks of young cells: %d (max %d)\n", _youngBlockCount, _stats.maxYoungBlockCount);
+    }
+    fprintf(stderr, "Pools of old elements, in slabs of %d bytes:\n", SCHEME_GC_SLAB_SIZE);
+    for (int i = 0; i < SCHEME_GC_POOL_COUNT; ++i)
+    {
+        struct _pool *pool = &_pools[i];
+        if (pool->slabCount == 0) continue;
+
+        fprintf(stderr, "  %3lu bytes: %d in use (max %d), %d slabs, %.0f%% occupied\n",
+                (unsigned long)pool->size, pool->useCount, pool->maxUseCount, pool->slabCount,
+                100.0 * pool->useCount * pool->size / ((double)pool->slabCount * SCHEME_GC_SLAB_SIZE));
+    }
+    fprintf(stderr, "  Larger elements: %d in use\n", _largeCount);
+    fprintf(stderr, "Permanent pool: %d blocks, %d slabs\n", _permanentPool.useCount, _permanentPool.slabCount);
+}
+
+void *scheme_gc_allocate(size_t size)
+{
+    size_t alignedSize = (size + SCHEME_GC_ALIGNMENT - 1) & ~(size_t)(SCHEME_GC_ALIGNMENT - 1);
+
+    if (_nursery == NULL && _nurserySize > 0)
+    {
+        if ((_nursery = malloc(_nurserySize)) == NULL)
+            _nurserySize = 0;
+    }
+
+    if (_nurseryUsed + alignedSize <= _nurserySize)
+    {
+        scheme_element *element = (scheme_element *)(_nursery + _nurseryUsed);
+        _nurseryUsed += alignedSize;
+
+        element->gcFlags = SCHEME_GC_YOUNG;
+        element->gcSize = size;
+        return element;
+    }
+
+    scheme_element *element;
+    if ((element = _allocate_old(size)) == NULL)
+        return NULL;
+
+    // Element might be made to refer to young elements.
+    if (_nurseryUsed > 0 || _youngCellCount > 0)
+    {
+        element->gcFlags |= SCHEME_GC_RECENT;
+        ++_overflowCount;
+        ++_stats.overflowCount;
+    }
+
+    return element;
+}
+
+void scheme_gc_release(scheme_element *element)
+{
+    if (element->gcFlags & SCHEME_GC_YOUNG)
+    {
+        element->gcFlags |= SCHEME_GC_RELEASED;
+        return;
+    }
+
+    if (element->gcFlags & SCHEME_GC_REMEMBERED)
+    {
+        for (int i = _rememberedCount - 1; i >= 0; --i)
+        {
+            if (_remembered[i] == element)
+            {
+                _remembered[i] = _remembered[--_rememberedCount];
+                break;
+            }
+        }
+    }
+
+    _untrack(element);
+    _old_free(element);
+}
+
+void *scheme_gc_allocate_permanent(size_t size)
+{
+    if (size > SCHEME_GC_PERMANENT_LIMIT)
+        return malloc(size);
+
+    size_t alignedSize = (size + SCHEME_GC_ALIGNMENT - 1) & ~(size_t)(SCHEME_GC_ALIGNMENT - 1);
+    return _pool_take(&_permanentPool, alignedSize);
+}
+
+scheme_element *scheme_gc_allocate_cell(scheme_element *first, scheme_element *second)
+{
+    // Make room to remember the cell first, so that failing to do so leaves
+    // nothing to undo. Young cells are scanned anyway.
+    int young = !_arena && (_is_young(first) || _is_young(second));
+    if (young && !_reserve((void **)&_rememberedCells, &_rememberedCellSize, _rememberedCellCount + 1, sizeof(scheme_element *)))
+        return NULL;
+
+    scheme_element **fields;
+    if ((fields = _take_cell(_arena)) == NULL)
+        return NULL;
+
+    fields[0] = first;
+    fields[1] = second;
+
+    scheme_element *cell = (scheme_element *)((uintptr_t)fields | SCHEME_ELEMENT_CELL_TAG);
+    struct scheme_element_cell_block *block = scheme_element_cell_get_block(cell);
+    int index = scheme_element_cell_get_index(cell);
+    block->refCounts[index] = 1;
+    block->gcFlags[index] = 0;
+    if (_arena)
+    {
+        ++_youngCellCount;
+    }
+    else
+    {
+        if (++_cellCount > _stats.maxCellCount)
+            _stats.maxCellCount = _cellCount;
+    }
+
+    if (young)
+        _rememberedCells[_rememberedCellCount++] = cell;
+
+    return cell;
+}
+
+void scheme_gc_release_cell(scheme_element *cell)
+{
+    scheme_element **fields = scheme_element_cell_get_fields(cell);
+    fields[1] = NULL;
+
+    if (scheme_element_cell_get_block(cell)->young)
+    {
+        fields[0] = (scheme_element *)_freeYoungCells;
+        _freeYoungCells = fields;
+        return;
+    }
+
+    fields[0] = (scheme_element *)_freeCells;
+    _freeCells = fields;
+
+    --_cellCount;
+}
+
+int scheme_gc_is_sweeping()
+{
+    return _sweeping;
+}
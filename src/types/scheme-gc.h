@@ -0,0 +1,202 @@
+/**
+ * Garbage collector for Scheme elements.
+ *
+ * Reference counting deallocates most Scheme elements as soon as their last
+ * reference is released with scheme_element_free(). The garbage collector
+ * reclaims the rest: elements whose references were dropped without being
+ * released, and elements that refer to each other.
+ *
+ * The collector is generational. New elements are allocated from a nursery
+ * by bumping a pointer. A minor collection moves the young elements that are
+ * still reachable into the old space and empties the nursery; a major
+ * collection uses mark and sweep on the old space. An element survives a
+ * collection if it can be reached from a root, no matter what its reference
+ * count is. Roots are:
+ *
+ *   - C variables registered with scheme_gc_add_root(), such as the one
+ *     holding the base namespace.
+ *   - C variables registered with scheme_gc_push_handle(), such as
+ *     temporaries on the C stack and the local namespaces of lambda
+ *     procedures being applied.
+ *
+ * Since young elements move, a minor collection rewrites the variables
+ * registered as roots and handles. Any other C variable referring to a
+ * dynamically allocated element is left dangling, except for inline
+ * caches of namespace lookups, which every collection empties.
+ *
+ * Collections only happen when scheme_gc_collect() or
+ * scheme_gc_collect_if_needed() is called. Code that does not hold an
+ * element across one of those calls is free to drop its references without
+ * releasing them.
+ */
+
+#ifndef __SCHEME_GC_H__
+#define __SCHEME_GC_H__
+
+#include <stddef.h>
+
+#include "scheme-element.h"
+
+/**
+ * Register a long-lived C variable holding a Scheme element as a root.
+ *
+ * Whatever element the variable holds when a collection happens survives
+ * the collection, until the variable is unregistered with
+ * scheme_gc_remove_root(). The variable may hold NULL.
+ *
+ * @param  root  Address of a variable holding a Scheme element.
+ */
+void scheme_gc_add_root(scheme_element **root);
+
+/**
+ * Unregister a variable previously registered with scheme_gc_add_root().
+ *
+ * @param  root  Address of a variable holding a Scheme element.
+ */
+void scheme_gc_remove_root(scheme_element **root);
+
+/**
+ * Register a C variable holding a Scheme element as a root.
+ *
+ * Whatever element the variable holds when a collection happens survives
+ * the collection. The variable may hold NULL.
+ *
+ * Handles form a stack and must be unregistered in reverse order with
+ * scheme_gc_pop_handles(), before the variable goes out of scope.
+ *
+ * @param  handle  Address of a variable holding a Scheme element.
+ */
+void scheme_gc_push_handle(scheme_element **handle);
+
+/**
+ * Unregister the most recently registered handles.
+ *
+ * @param  count  Number of handles to unregister.
+ */
+void scheme_gc_pop_handles(int count);
+
+/**
+ * Run a minor collection, then deallocate every old element that cannot be
+ * reached from a root.
+ *
+ * @return Number of deallocated old elements.
+ */
+int scheme_gc_collect();
+
+/**
+ * Run a minor collection if the nursery is at least half full, and a major
+ * collection if enough elements have been allocated in the old space since
+ * the last one.
+ *
+ * Major collections are scheduled so that their cost stays proportional to
+ * the number of allocated elements.
+ *
+ * @return Number of deallocated old elements.
+ */
+int scheme_gc_collect_if_needed();
+
+/**
+ * End a top-level form in arena mode: run a minor collection, which resets
+ * the nursery and the blocks of young cells at once, and a major collection
+ * if enough elements have been allocated in the old space since the last
+ * one.
+ *
+ * Elements created for the form, such as the parsed expression and its
+ * result, do not need to be released beforehand. References they hold are
+ * dropped without being counted, so old elements they refer to are only
+ * deallocated by a major collection.
+ *
+ * @return Number of deallocated old elements.
+ */
+int scheme_gc_end_form();
+
+/**
+ * Record that an element was made to refer to another element after it was
+ * created, so that minor collections find the reference.
+ *
+ * Must be called by every operation that modifies an existing element.
+ *
+ * @param  container  Modified element.
+ * @param  element    Element it now refers to.
+ */
+void scheme_gc_write_barrier(scheme_element *container, scheme_element *element);
+
+/**
+ * Set the size of the nursery. Has no effect unless the nursery is empty,
+ * such as before the first allocation.
+ *
+ * @param  size  Size in bytes. 0 disables the nursery.
+ */
+void scheme_gc_set_nursery_size(size_t size);
+
+/**
+ * Set whether pairs are allocated as young cells, which minor collections
+ * either promote or reclaim at once, instead of old cells.
+ *
+ * @param  enabled  1 to enable arena mode, 0 to disable it.
+ */
+void scheme_gc_set_arena(int enabled);
+
+/**
+ * Print the number of collections, their pause times and how many elements
+ * they processed to stderr.
+ */
+void scheme_gc_print_stats();
+
+/**** Functions used by scheme-element.c ****/
+
+/**
+ * Allocate memory for a new element.
+ *
+ * @param  size  Size of element.
+ *
+ * @return An element with only its garbage collector fields set,
+ *         or NULL if out of memory.
+ */
+void *scheme_gc_allocate(size_t size);
+
+/**
+ * Reclaim memory of an element whose resources have been released.
+ *
+ * @param  element  A Scheme element.
+ */
+void scheme_gc_release(scheme_element *element);
+
+/**
+ * Allocate memory that is never deallocated, such as interned symbols.
+ *
+ * Such memory is allocated from a pool of its own, which is faster and
+ * wastes less memory than malloc() for small sizes.
+ *
+ * @param  size  Size of memory.
+ *
+ * @return Memory aligned for any element, or NULL if out of memory.
+ */
+void *scheme_gc_allocate_permanent(size_t size);
+
+/**
+ * Allocate a new cell, holding a single reference.
+ *
+ * @param  first   First element of the cell, whose reference is taken over.
+ * @param  second  Second element of the cell, whose reference is taken
+ *                 over.
+ *
+ * @return A reference to the cell, or NULL if out of memory.
+ */
+scheme_element *scheme_gc_allocate_cell(scheme_element *first, scheme_element *second);
+
+/**
+ * Reclaim a cell whose references have been released.
+ *
+ * @param  cell  A reference to a cell.
+ */
+void scheme_gc_release_cell(scheme_element *cell);
+
+/**
+ * Check if a collection is deallocating unreachable elements.
+ *
+ * @return 1 if so, 0 otherwise.
+ */
+int scheme_gc_is_sweeping();
+
+#endif
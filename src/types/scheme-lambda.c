@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include "eval.h"
+#include "scheme-gc.h"
 #include "scheme-lambda.h"
 #include "utils.h"
 #include "scheme-procedure-init.h"
@@ -12,8 +13,15 @@
 struct scheme_lambda {
     struct scheme_procedure super;
     struct scheme_lambda_argument *arguments;
+    // Interned symbols for argument identifiers and rest ID.
+    scheme_symbol **argumentSymbols;
     scheme_element **expressions;
+    // Namespace the procedure was created in, or NULL.
+    scheme_namespace *environment;
+    // Compiled expressions, or NULL.
+    scheme_element *code;
     char *restID;
+    scheme_symbol *restSymbol;
     int argumentCount;
     int expressionCount;
 };
@@ -27,15 +35,6 @@ struct scheme_lambda {
  */
 static void _vtable_free(scheme_element *element);
 
-/**
- * Copy a lambda procedure.
- *
- * @param  element  Should be a lambda procedure.
- *
- * @return Copy or NULL if out of memory.
- */
-static scheme_element *_vtable_copy(scheme_element *element);
-
 /**
  * Print lambda procedure to stdout.
  *
@@ -54,6 +53,14 @@ static void _vtable_print(scheme_element *element);
  */
 static int _vtable_compare(scheme_element *element, scheme_element *other);
 
+/**
+ * Pass references held by a lambda procedure to a visitor.
+ *
+ * @param  element  Should be a lambda procedure.
+ * @param  visit    A visitor.
+ */
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit);
+
 /**
  * Evaluate expressions stored in lambda procedure with given arguments.
  *
@@ -74,6 +81,29 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
                                         scheme_element *element,
                                         scheme_namespace *namespace);
 
+/**
+ * Bind arguments of a lambda procedure call in the procedure's local
+ * namespace.
+ *
+ * Arguments are evaluated in the active namespace. Arguments that have
+ * not been supplied are bound to their default values.
+ *
+ * The argument list must already have been verified to match the
+ * procedure's argument identifiers.
+ *
+ * @param  lambda          A lambda procedure.
+ * @param  element         Scheme element that is the argument of the
+ *                         procedure call.
+ * @param  namespace       Active namespace.
+ * @param  localNamespace  Procedure's local namespace.
+ *
+ * @return 1 on success, 0 if an argument could not be evaluated.
+ */
+static int _bind_arguments(scheme_lambda *lambda,
+                           scheme_element *element,
+                           scheme_namespace *namespace,
+                           scheme_namespace *localNamespace);
+
 /**** Private variables ****/
 
 // Global virtual function table.
@@ -81,8 +111,8 @@ static struct scheme_element_vtable _scheme_lambda_vtable = {
     .get_type = scheme_lambda_get_type,
     .free = _vtable_free,
     .print = _vtable_print,
-    .copy = _vtable_copy,
-    .compare = _vtable_compare
+    .compare = _vtable_compare,
+    .traverse = _vtable_traverse
 };
 
 // scheme_procedure virtual function table.
@@ -117,6 +147,8 @@ static void _vtable_free(scheme_element *element)
         free(procedure->arguments);
     }
 
+    free(procedure->argumentSymbols);
+
     if (procedure->restID != NULL)
         free(procedure->restID);
 
@@ -127,19 +159,10 @@ static void _vtable_free(scheme_element *element)
     }
     free(procedure->expressions);
 
-    _scheme_procedure_vtable.free(element);
-}
+    scheme_element_free((scheme_element *)procedure->environment);
+    scheme_element_free(procedure->code);
 
-static scheme_element *_vtable_copy(scheme_element *element)
-{
-    scheme_lambda *procedure = (scheme_lambda *)element;
-
-    return (scheme_element *)scheme_lambda_new(procedure->super.name,
-                                               procedure->arguments,
-                                               procedure->argumentCount,
-                                               procedure->restID,
-                                               procedure->expressions,
-                                               procedure->expressionCount);
+    _scheme_procedure_vtable.free(element);
 }
 
 static void _vtable_print(scheme_element *element)
@@ -149,7 +172,7 @@ static void _vtable_print(scheme_element *element)
 
 static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    if (!scheme_element_is_type(other, &_scheme_lambda_type)) return 0;
+    if (!scheme_element_is_lambda(other)) return 0;
 
     scheme_lambda *this = (scheme_lambda *)element;
     scheme_lambda *that = (scheme_lambda *)other;
@@ -157,6 +180,10 @@ static int _vtable_compare(scheme_element *element, scheme_element *other)
     // Use scheme_procedure's comparison.
     if (!_scheme_procedure_vtable.compare(element, other)) return 0;
 
+    // Procedures created in different namespaces may refer to different
+    // variables.
+    if (this->environment != that->environment) return 0;
+
     // Compare rest IDs.
     if (this->restID != NULL || that->restID != NULL)
     {
@@ -197,6 +224,27 @@ static int _vtable_compare(scheme_element *element, scheme_element *other)
     return 1;
 }
 
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit)
+{
+    scheme_lambda *procedure = (scheme_lambda *)element;
+
+    for (int i = 0; i < procedure->argumentCount; ++i)
+    {
+        if (procedure->arguments[i].defaultValue != NULL)
+            visit(&procedure->arguments[i].defaultValue);
+    }
+
+    for (int i = 0; i < procedure->expressionCount; ++i)
+    {
+        visit(&procedure->expressions[i]);
+    }
+
+    visit((scheme_element **)&procedure->environment);
+
+    if (procedure->code != NULL)
+        visit(&procedure->code);
+}
+
 static scheme_element *_lambda_function(scheme_procedure *procedure,
                                         scheme_element *element,
                                         scheme_namespace *namespace)
@@ -208,7 +256,7 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
     if (lambda->argumentCount == 0 && lambda->restID == NULL)
     {
         // Lambda procedure expects no argument.
-        if (!scheme_element_is_type(argumentList, scheme_pair_get_type()) || !scheme_pair_is_empty((scheme_pair *)argumentList))
+        if (!scheme_element_is_pair(argumentList) || !scheme_pair_is_empty((scheme_pair *)argumentList))
         {
             return NULL;
         }
@@ -223,7 +271,7 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
                 break;
 
             // Stop if argument list is not a proper list.
-            if (!scheme_element_is_type(argumentList, scheme_pair_get_type()))
+            if (!scheme_element_is_pair(argumentList))
                 return NULL;
 
             argumentList = scheme_pair_get_second((scheme_pair *)argumentList);
@@ -235,7 +283,7 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
             for (int i = argIndex; i < lambda->argumentCount; ++i)
             {
                 // Stop if argument list is not a pair (signifying that it was invalidly formatted).
-                if (!scheme_element_is_type(argumentList, scheme_pair_get_type()))
+                if (!scheme_element_is_pair(argumentList))
                     return NULL;
 
                 // Break if argument list is empty.
@@ -246,7 +294,7 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
             }
 
             // After the loop, argument list should have been fully exhausted.
-            if (!scheme_element_is_type(argumentList, scheme_pair_get_type()))
+            if (!scheme_element_is_pair(argumentList))
                 return NULL;
             if (!scheme_pair_is_empty((scheme_pair *)argumentList))
                 return NULL;
@@ -257,15 +305,55 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
     if (!scheme_pair_is_list((scheme_pair *)argumentList))
         return NULL;
 
-    // Set up local namespace.
-    scheme_namespace *localNamespace = scheme_namespace_new(namespace);
+    // Set up local namespace, sized for the arguments, inside the namespace
+    // the procedure was created in. Arguments are still evaluated in the
+    // active namespace. It remains a root for as long as the procedure is
+    // being applied.
+    scheme_namespace *environment = lambda->environment != NULL ? lambda->environment : namespace;
+    int frameSize = lambda->argumentCount + (lambda->restSymbol != NULL ? 1 : 0);
+    scheme_namespace *localNamespace = scheme_namespace_new_frame(environment, frameSize);
+    if (localNamespace == NULL) return NULL;
+    scheme_gc_push_handle((scheme_element **)&localNamespace);
+
+    // Callers may only hold a borrowed reference to this procedure, which
+    // the arguments or body could release by redefining its identifier.
+    scheme_element_copy((scheme_element *)lambda);
+
+    // Evaluate expressions. A call made by the last one is deferred to the
+    // caller, which keeps the local namespace alive until it is applied.
+    scheme_element *result = NULL;
+    if (_bind_arguments(lambda, element, namespace, localNamespace))
+    {
+        for (int i = 0; i < lambda->expressionCount - 1; ++i)
+        {
+            scheme_element_free(result);
+            result = scheme_evaluate(lambda->expressions[i], localNamespace);
+        }
+
+        if (lambda->expressionCount > 0)
+        {
+            scheme_element_free(result);
+            result = scheme_evaluate_tail(lambda->expressions[lambda->expressionCount - 1], localNamespace);
+        }
+    }
+
+    scheme_gc_pop_handles(1);
+    scheme_element_free((scheme_element *)localNamespace);
+    scheme_element_free((scheme_element *)lambda);
 
-    // Populate local namespace with arguments.
+    return result;
+}
+
+static int _bind_arguments(scheme_lambda *lambda,
+                           scheme_element *element,
+                           scheme_namespace *namespace,
+                           scheme_namespace *localNamespace)
+{
     // Enumerate through arguments and add them to namespace.
-    argumentList = element;
+    scheme_element *argumentList = element;
     for (int i = 0; i < lambda->argumentCount; ++i)
     {
-        char *id = lambda->arguments[i].id;
+        scheme_symbol *id = lambda->argumentSymbols[i];
 
         scheme_element *argument;
         if (!scheme_pair_is_empty((scheme_pair *)argumentList))
@@ -274,10 +362,7 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
 
             argument = scheme_evaluate(argument, namespace);
             if (argument == NULL)
-            {
-                scheme_element_free((scheme_element *)localNamespace);
-                return NULL;
-            }
+                return 0;
 
             argumentList = scheme_pair_get_second((scheme_pair *)argumentList);
         }
@@ -286,7 +371,7 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
             argument = scheme_element_copy(lambda->arguments[i].defaultValue);
         }
 
-        scheme_namespace_set(localNamespace, id, argument);
+        scheme_namespace_bind_symbol(localNamespace, id, argument);
         scheme_element_free(argument);
     }
 
@@ -296,37 +381,25 @@ static scheme_element *_lambda_function(scheme_procedure *procedure,
         // Construct list with every element already evaluated.
         scheme_pair *evaluatedArgumentList = scheme_list_evaluated((scheme_pair *)argumentList, namespace);
         if (evaluatedArgumentList == NULL)
-        {
-            scheme_element_free((scheme_element *)localNamespace);
-            return NULL;
-        }
+            return 0;
 
-        scheme_namespace_set(localNamespace, lambda->restID, (scheme_element *)evaluatedArgumentList);
+        scheme_namespace_bind_symbol(localNamespace, lambda->restSymbol, (scheme_element *)evaluatedArgumentList);
 
         scheme_element_free((scheme_element *)evaluatedArgumentList);
     }
 
-    // Evaluate expressions.
-    scheme_element *result = NULL;
-    for (int i = 0; i < lambda->expressionCount; ++i)
-    {
-        scheme_element_free(result);
-        result = scheme_evaluate(lambda->expressions[i], localNamespace);
-    }
-
-    scheme_element_free((scheme_element *)localNamespace);
-
-    return result;
+    return 1;
 }
 
 /**** Public function implementations ****/
 
-scheme_lambda *scheme_lambda_new(char *name,
+scheme_lambda *scheme_lambda_new(const char *name,
                                  struct scheme_lambda_argument *arguments,
                                  int argumentCount,
                                  char *restID,
                                  scheme_element **expressions,
-                                 int expressionCount)
+                                 int expressionCount,
+                                 scheme_namespace *environment)
 {
     // Verify argument ID array is valid.
     if (arguments != NULL)
@@ -350,7 +423,7 @@ scheme_lambda *scheme_lambda_new(char *name,
     if (expressions == NULL || expressionCount == 0)
         return NULL;
 
-    scheme_lambda *procedure = malloc(sizeof(scheme_lambda));
+    scheme_lambda *procedure = (scheme_lambda *)scheme_element_new(sizeof(scheme_lambda), &_scheme_lambda_vtable, SCHEME_ELEMENT_TAG_LAMBDA);
     if (procedure == NULL) return NULL;
 
     // Call scheme_procedure's initializer.
@@ -364,62 +437,98 @@ scheme_lambda *scheme_lambda_new(char *name,
         _scheme_procedure_vtable_initialized = 1;
     }
 
-    // Set up our own virtual function table.
+    // Set up our own virtual function table and tag.
     ((scheme_element *)procedure)->vtable = &_scheme_lambda_vtable;
+    ((scheme_element *)procedure)->tag = SCHEME_ELEMENT_TAG_LAMBDA;
+
+    // Until everything has been copied, procedure holds nothing, so that
+    // it can be freed at any point.
+    procedure->arguments = NULL;
+    procedure->argumentSymbols = NULL;
+    procedure->argumentCount = 0;
+    procedure->restID = NULL;
+    procedure->restSymbol = NULL;
+    procedure->expressions = NULL;
+    procedure->expressionCount = 0;
+    procedure->environment = (scheme_namespace *)scheme_element_copy((scheme_element *)environment);
+    procedure->code = NULL;
 
     // Copy argument IDs.
     if (arguments != NULL)
     {
         procedure->arguments = malloc(sizeof(struct scheme_lambda_argument) * argumentCount);
-        if (procedure->arguments == NULL) return NULL;
+        procedure->argumentSymbols = malloc(sizeof(scheme_symbol *) * argumentCount);
+        if (procedure->arguments == NULL || procedure->argumentSymbols == NULL)
+        {
+            scheme_element_free((scheme_element *)procedure);
+            return NULL;
+        }
 
         for (int i = 0; i < argumentCount; ++i)
         {
             int lengthID = strlen(arguments[i].id) + 1;
-            if ((procedure->arguments[i].id = malloc(sizeof(char) * lengthID)) == NULL) return NULL;
+            if ((procedure->arguments[i].id = malloc(sizeof(char) * lengthID)) == NULL)
+            {
+                scheme_element_free((scheme_element *)procedure);
+                return NULL;
+            }
             strcpy(procedure->arguments[i].id, arguments[i].id);
 
+            if ((procedure->argumentSymbols[i] = scheme_symbol_new(arguments[i].id)) == NULL)
+            {
+                free(procedure->arguments[i].id);
+                scheme_element_free((scheme_element *)procedure);
+                return NULL;
+            }
+
             if (arguments[i].defaultValue != NULL)
                 procedure->arguments[i].defaultValue = scheme_element_copy(arguments[i].defaultValue);
             else
                 procedure->arguments[i].defaultValue = NULL;
-        }
 
-        procedure->argumentCount = argumentCount;
-    }
-    else
-    {
-        procedure->arguments = NULL;
-        procedure->argumentCount = 0;
+            procedure->argumentCount = i + 1;
+        }
     }
 
     // Copy rest ID.
     if (restID != NULL)
     {
         int lengthID = strlen(restID) + 1;
-        if ((procedure->restID = malloc(sizeof(char) * lengthID)) == NULL) return NULL;
+        if ((procedure->restID = malloc(sizeof(char) * lengthID)) == NULL)
+        {
+            scheme_element_free((scheme_element *)procedure);
+            return NULL;
+        }
         strcpy(procedure->restID, restID);
+
+        if ((procedure->restSymbol = scheme_symbol_new(restID)) == NULL)
+        {
+            scheme_element_free((scheme_element *)procedure);
+            return NULL;
+        }
     }
-    else
-        procedure->restID = NULL;
 
     // Copy expressions.
     procedure->expressions = malloc(sizeof(scheme_element *) * expressionCount);
-    if (procedure->expressions == NULL) return NULL;
+    if (procedure->expressions == NULL)
+    {
+        scheme_element_free((scheme_element *)procedure);
+        return NULL;
+    }
 
-    procedure->expressionCount = expressionCount;
     for (int i = 0; i < expressionCount; ++i)
     {
         procedure->expressions[i] = scheme_element_copy(expressions[i]);
-        if (procedure->expressions[i] == NULL) return NULL;
+        procedure->expressionCount = i + 1;
     }
 
     return procedure;
 }
 
-scheme_lambda *scheme_lambda_new_from_elements(char *name,
+scheme_lambda *scheme_lambda_new_from_elements(const char *name,
                                                scheme_element *arguments,
-                                               scheme_element *expressions)
+                                               scheme_element *expressions,
+                                               scheme_namespace *environment)
 {
     struct scheme_lambda_argument *arguments_arr;
     int argumentCount;
@@ -428,14 +537,14 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
     int expressionCount;
 
     // Arguments could be a symbol or a pair.
-    if ( !(scheme_element_is_type(arguments, scheme_symbol_get_type()) || scheme_element_is_type(arguments, scheme_pair_get_type())) )
+    if ( !(scheme_element_is_symbol(arguments) || scheme_element_is_pair(arguments)) )
         return NULL;
 
     // Expressions must be a list.
-    if ( !(scheme_element_is_type(expressions, scheme_pair_get_type()) && scheme_pair_is_list((scheme_pair *)expressions)) )
+    if ( !(scheme_element_is_pair(expressions) && scheme_pair_is_list((scheme_pair *)expressions)) )
         return NULL;
 
-    if (scheme_element_is_type(arguments, scheme_symbol_get_type()))
+    if (scheme_element_is_symbol(arguments))
     {
         // If arguments is a symbol, procedure only has a rest ID.
         restID = scheme_symbol_get_value((scheme_symbol *)arguments);
@@ -452,7 +561,7 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
         while (1)
         {
             // Break if argument list is not a pair or the empty pair.
-            if (!scheme_element_is_type(argumentList, scheme_pair_get_type()))
+            if (!scheme_element_is_pair(argumentList))
                 break;
             if (scheme_pair_is_empty((scheme_pair *)argumentList))
                 break;
@@ -460,10 +569,10 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
             scheme_element *argument = scheme_pair_get_first((scheme_pair *)argumentList);
 
             // Argument in list must be a symbol or a pair.
-            if (!(scheme_element_is_type(argument, scheme_symbol_get_type()) || scheme_element_is_type(argument, scheme_pair_get_type())))
+            if (!(scheme_element_is_symbol(argument) || scheme_element_is_pair(argument)))
                 return NULL;
 
-            if (scheme_element_is_type(argument, scheme_pair_get_type()))
+            if (scheme_element_is_pair(argument))
             {
                 // If argument is a pair (ie. there is a default value), it must be a list of exactly 2 elements.
                 int count;
@@ -478,7 +587,7 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
                 // First element must be a symbol.
                 scheme_element *first = argument_arr[0];
                 free(argument_arr);
-                if (!scheme_element_is_type(first, scheme_symbol_get_type()))
+                if (!scheme_element_is_symbol(first))
                 {
                     return NULL;
                 }
@@ -490,8 +599,8 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
         }
 
         // Remainder of argument list must be a pair (ie. the empty pair) or a symbol.
-        if ( !(   scheme_element_is_type(argumentList, scheme_pair_get_type())
-               || scheme_element_is_type(argumentList, scheme_symbol_get_type())) )
+        if ( !(   scheme_element_is_pair(argumentList)
+               || scheme_element_is_symbol(argumentList)) )
             return NULL;
 
         if (argumentCount > 0)
@@ -505,12 +614,12 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
             {
                 scheme_element *argument = scheme_pair_get_first((scheme_pair *)argumentList);
 
-                if (scheme_element_is_type(argument, scheme_symbol_get_type()))
+                if (scheme_element_is_symbol(argument))
                 {
                     arguments_arr[i].id = scheme_symbol_get_value((scheme_symbol *)argument);
                     arguments_arr[i].defaultValue = NULL;
                 }
-                else if (scheme_element_is_type(argument, scheme_pair_get_type()))
+                else if (scheme_element_is_pair(argument))
                 {
                     scheme_element **argument_arr = scheme_list_to_array((scheme_pair *)argument, NULL);
                     arguments_arr[i].id = scheme_symbol_get_value((scheme_symbol *)argument_arr[0]);
@@ -522,7 +631,7 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
             }
 
             // The remainder can only be the empty pair or a symbol since argument list has been verified above.
-            if (scheme_element_is_type(argumentList, scheme_symbol_get_type()))
+            if (scheme_element_is_symbol(argumentList))
             {
                 restID = scheme_symbol_get_value((scheme_symbol *)argumentList);
             }
@@ -542,7 +651,7 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
     // Get list of expressions.
     expressions_arr = scheme_list_to_array((scheme_pair *)expressions, &expressionCount);
 
-    scheme_lambda *procedure = scheme_lambda_new(name, arguments_arr, argumentCount, restID, expressions_arr, expressionCount);
+    scheme_lambda *procedure = scheme_lambda_new(name, arguments_arr, argumentCount, restID, expressions_arr, expressionCount, environment);
 
     free(expressions_arr);
     free(restID);
@@ -556,6 +665,116 @@ scheme_lambda *scheme_lambda_new_from_elements(char *name,
     return procedure;
 }
 
+scheme_lambda *scheme_lambda_new_closure(scheme_lambda *lambda, scheme_namespace *environment)
+{
+    scheme_lambda *procedure = scheme_lambda_new(((scheme_procedure *)lambda)->name,
+                                                 lambda->arguments,
+                                                 lambda->argumentCount,
+                                                 lambda->restID,
+                                                 lambda->expressions,
+                                                 lambda->expressionCount,
+                                                 environment);
+    if (procedure == NULL) return NULL;
+
+    procedure->code = scheme_element_copy(lambda->code);
+
+    return procedure;
+}
+
+scheme_element **scheme_lambda_get_expressions(scheme_lambda *lambda, int *count)
+{
+    *count = lambda->expressionCount;
+    return lambda->expressions;
+}
+
+int scheme_lambda_get_fixed_argument_count(scheme_lambda *lambda)
+{
+    if (lambda->restSymbol != NULL) return -1;
+
+    for (int i = 0; i < lambda->argumentCount; ++i)
+    {
+        if (lambda->arguments[i].defaultValue != NULL)
+            return -1;
+
+        // A repeated identifier is bound to the last of its arguments.
+        for (int j = 0; j < i; ++j)
+        {
+            if (strcmp(lambda->arguments[i].id, lambda->arguments[j].id) == 0)
+                return -1;
+        }
+    }
+
+    return lambda->argumentCount;
+}
+
+scheme_namespace *scheme_lambda_get_environment(scheme_lambda *lambda)
+{
+    return lambda->environment;
+}
+
+scheme_element *scheme_lambda_get_code(scheme_lambda *lambda)
+{
+    return lambda->code;
+}
+
+void scheme_lambda_set_code(scheme_lambda *lambda, scheme_element *code)
+{
+    scheme_element_free(lambda->code);
+    lambda->code = scheme_element_copy(code);
+    scheme_gc_write_barrier((scheme_element *)lambda, code);
+}
+
+scheme_namespace *scheme_lambda_bind(scheme_lambda *lambda,
+                                     scheme_element **arguments,
+                                     int argumentCount,
+                                     scheme_namespace *namespace)
+{
+    // Verify that we are given enough arguments, but not too many.
+    int requiredCount = 0;
+    while (requiredCount < lambda->argumentCount && lambda->arguments[requiredCount].defaultValue == NULL)
+        ++requiredCount;
+
+    if (argumentCount < requiredCount) return NULL;
+    if (lambda->restSymbol == NULL && argumentCount > lambda->argumentCount) return NULL;
+
+    // Set up local namespace, sized for the arguments, inside the namespace
+    // the procedure was created in.
+    scheme_namespace *environment = lambda->environment != NULL ? lambda->environment : namespace;
+    int frameSize = lambda->argumentCount + (lambda->restSymbol != NULL ? 1 : 0);
+    scheme_namespace *localNamespace = scheme_namespace_new_frame(environment, frameSize);
+    if (localNamespace == NULL) return NULL;
+
+    // Bind arguments, using default values for missing ones.
+    for (int i = 0; i < lambda->argumentCount; ++i)
+    {
+        scheme_element *argument = i < argumentCount ? arguments[i] : lambda->arguments[i].defaultValue;
+        scheme_namespace_bind_symbol(localNamespace, lambda->argumentSymbols[i], argument);
+    }
+
+    // Add the remaining arguments as a list under rest argument if one exists.
+    if (lambda->restSymbol != NULL)
+    {
+        scheme_element *rest = scheme_element_copy((scheme_element *)scheme_pair_get_empty());
+        for (int i = argumentCount - 1; i >= lambda->argumentCount; --i)
+        {
+            scheme_element *pair = (scheme_element *)scheme_pair_new(arguments[i], rest);
+            scheme_element_free(rest);
+            if (pair == NULL)
+            {
+                scheme_element_free((scheme_element *)localNamespace);
+                return NULL;
+            }
+
+            rest = pair;
+        }
+
+        scheme_namespace_bind_symbol(localNamespace, lambda->restSymbol, rest);
+        scheme_element_free(rest);
+    }
+
+    return localNamespace;
+}
+
 scheme_element_type *scheme_lambda_get_type()
 {
     if (!_scheme_lambda_type_initd)
@@ -12,6 +12,7 @@
 #define __SCHEME_LAMBDA_H__
 
 #include "scheme-element.h"
+#include "scheme-namespace.h"
 
 // Scheme lambda procedure type.
 typedef struct scheme_lambda scheme_lambda;
@@ -35,15 +36,21 @@ struct scheme_lambda_argument {
  * @param  expressions      Array of Scheme elements to be treated as
  *                          expressions when invoking procedure.
  * @param  expressionCount  Count of expressions.
+ * @param  environment      Namespace the procedure is created in. Its
+ *                          expressions are evaluated in a namespace whose
+ *                          superset is this one, no matter where the
+ *                          procedure is applied. Pass NULL to use the
+ *                          namespace it is applied in instead.
  *
  * @return Lambda procedure or NULL if out of memory.
  */
-scheme_lambda *scheme_lambda_new(char *name,
+scheme_lambda *scheme_lambda_new(const char *name,
                                  struct scheme_lambda_argument *arguments,
                                  int argumentCount,
                                  char *restID,
                                  scheme_element **expressions,
-                                 int expressionCount);
+                                 int expressionCount,
+                                 scheme_namespace *environment);
 
 /**
  * Create a new Scheme lambda procedure from Scheme elements.
@@ -54,12 +61,102 @@ scheme_lambda *scheme_lambda_new(char *name,
  *                      for the procedure.
  * @param  expressions  A Scheme list of expressions to be evaluated
  *                      when procedure is invoked.
+ * @param  environment  Namespace the procedure is created in, see
+ *                      scheme_lambda_new().
  *
  * @return Lambda procedure or NULL if out of memory.
  */
-scheme_lambda *scheme_lambda_new_from_elements(char *name,
+scheme_lambda *scheme_lambda_new_from_elements(const char *name,
                                                scheme_element *arguments,
-                                               scheme_element *expressions);
+                                               scheme_element *expressions,
+                                               scheme_namespace *environment);
+
+/**
+ * Create a new Scheme lambda procedure with the same name, arguments,
+ * expressions and code as an existing one, in another namespace.
+ *
+ * @param  lambda       A lambda procedure used as a template.
+ * @param  environment  Namespace the procedure is created in, see
+ *                      scheme_lambda_new().
+ *
+ * @return Lambda procedure or NULL if out of memory.
+ */
+scheme_lambda *scheme_lambda_new_closure(scheme_lambda *lambda, scheme_namespace *environment);
+
+/**
+ * Get the expressions evaluated when a lambda procedure is applied.
+ *
+ * The returned array belongs to the procedure and must not be freed.
+ *
+ * @param  lambda  A lambda procedure.
+ * @param  count   Set to the number of expressions.
+ *
+ * @return Array of expressions.
+ */
+scheme_element **scheme_lambda_get_expressions(scheme_lambda *lambda, int *count);
+
+/**
+ * Get the number of arguments of a lambda procedure that must be applied to
+ * exactly that many arguments, each bound to its own identifier, i.e. that
+ * has neither arguments with default values, a rest argument nor repeated
+ * identifiers.
+ *
+ * @param  lambda  A lambda procedure.
+ *
+ * @return Number of arguments, or -1 if the procedure accepts a varying
+ *         number of arguments or repeats an identifier.
+ */
+int scheme_lambda_get_fixed_argument_count(scheme_lambda *lambda);
+
+/**
+ * Get the namespace a lambda procedure was created in. The returned
+ * namespace must not be freed.
+ *
+ * @param  lambda  A lambda procedure.
+ *
+ * @return Namespace, or NULL if the procedure's expressions are evaluated
+ *         in a namespace inside the one it is applied in.
+ */
+scheme_namespace *scheme_lambda_get_environment(scheme_lambda *lambda);
+
+/**
+ * Get the compiled form of a lambda procedure's expressions, as set with
+ * scheme_lambda_set_code(). The returned element must not be freed.
+ *
+ * @param  lambda  A lambda procedure.
+ *
+ * @return Compiled code, or NULL if the procedure has not been compiled.
+ */
+scheme_element *scheme_lambda_get_code(scheme_lambda *lambda);
+
+/**
+ * Store the compiled form of a lambda procedure's expressions. The element
+ * itself is shared, not duplicated.
+ *
+ * @param  lambda  A lambda procedure.
+ * @param  code    Compiled code.
+ */
+void scheme_lambda_set_code(scheme_lambda *lambda, scheme_element *code);
+
+/**
+ * Set up the local namespace a lambda procedure's expressions are evaluated
+ * in, given its already evaluated arguments.
+ *
+ * Returned pointer must be freed with scheme_element_free().
+ *
+ * @param  lambda          A lambda procedure.
+ * @param  arguments       Array of evaluated arguments.
+ * @param  argumentCount   Number of arguments.
+ * @param  namespace       Active namespace, used as the superset if the
+ *                         procedure was not created in a namespace.
+ *
+ * @return Local namespace, or NULL if the procedure does not accept that
+ *         number of arguments or out of memory.
+ */
+scheme_namespace *scheme_lambda_bind(scheme_lambda *lambda,
+                                     scheme_element **arguments,
+                                     int argumentCount,
+                                     scheme_namespace *namespace);
 
 /**
  * Get lambda procedure's type.
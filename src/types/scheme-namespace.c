@@ -3,23 +3,46 @@
 #include <string.h>
 
 #include "scheme-namespace.h"
+#include "scheme-symbol.h"
 #include "scheme-element-private.h"
+#include "scheme-gc.h"
 
-#define SCHEME_NAMESPACE_INITIAL_SIZE 32
+// Initial capacity of a namespace's items.
+#define SCHEME_NAMESPACE_INITIAL_SIZE 8
+
+// Namespaces with at most this many items are searched linearly, without an
+// index.
+#define SCHEME_NAMESPACE_LINEAR_LIMIT 8
+
+// Item arrays with at most this many items are kept in the frame pool when
+// their namespace is freed, and at most this many of each size are kept.
+#define SCHEME_NAMESPACE_POOL_LIMIT 8
+#define SCHEME_NAMESPACE_POOL_DEPTH 256
 
 // Struct for an element stored in namespace.
 struct _namespace_item {
-    char *identifier;
+    scheme_symbol *identifier;
     scheme_element *element;
 };
 
 // Scheme namespace.
+//
+// Items are stored in the order they were first defined, so that an item
+// keeps the same slot for as long as the namespace exists. Larger
+// namespaces also have an index: an open addressing hash table keyed on
+// interned symbols, holding slots plus one so that 0 marks an unused entry.
+// Its size is always a power of 2.
+//
+// Item arrays are sized exactly for frames, and come from the frame pool
+// if they are small enough.
 struct scheme_namespace {
     struct scheme_element super;
     struct scheme_namespace *superset;
     struct _namespace_item *items;
     int itemCount;
     int itemSize;
+    int *index;
+    int indexSize;
 };
 
 /**** Private function declarations ****/
@@ -39,59 +62,114 @@ static void _vtable_free(scheme_element *element);
 static void _vtable_print(scheme_element *element);
 
 /**
- * Copy namespace.
+ * Compare namespace to another namespace.
+ * Will return 0 if either pointer is not a namespace.
  *
  * @param  element  Should be a Scheme namespace.
- *
- * @return A copy, or NULL if out of memory.
+ * @param  other    A Scheme element.
  */
-static scheme_element *_vtable_copy(scheme_element *element);
+static int _vtable_compare(scheme_element *element, scheme_element *other);
 
 /**
- * Compare namespace to another namespace.
- * Will return 0 if either pointer is not a namespace.
+ * Pass references held by a namespace to a visitor.
  *
  * @param  element  Should be a Scheme namespace.
- * @param  other    A Scheme element.
+ * @param  visit    A visitor.
  */
-static int _vtable_compare(scheme_element *element, scheme_element *other);
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit);
+
+/**
+ * Find the slot of an identifier in a namespace, not including its
+ * superset.
+ *
+ * @param  namespace   A Scheme namespace.
+ * @param  identifier  An interned symbol.
+ *
+ * @return Slot of identifier, or -1 if it is not in the namespace.
+ */
+static int _find_slot(scheme_namespace *namespace, scheme_symbol *identifier);
 
 /**
- * Initialize an already allocated namespace item.
+ * Add a slot to a namespace's index.
  *
- * @param  item        A namespace item.
- * @param  identifier  An identifier.
- * @param  elemnet     A Scheme element.
+ * @param  namespace  A Scheme namespace with an index.
+ * @param  slot       Slot of an item.
  */
-static void _namespace_item_init(struct _namespace_item *item, const char *identifier, scheme_element *element);
+static void _index_insert(scheme_namespace *namespace, int slot);
 
 /**
- * Free items in a namespace item.
+ * Rebuild a namespace's index with the given size.
+ *
+ * @param  namespace  A Scheme namespace.
+ * @param  size       New size, a power of 2.
  *
- * @param  item  A namespace item.
+ * @return 1 on success, 0 if out of memory.
  */
-static void _namespace_item_free_content(struct _namespace_item *item);
+static int _index_rebuild(scheme_namespace *namespace, int size);
 
 /**
- * Compare two namespace items.
+ * Allocate an item array, from the frame pool if possible.
+ *
+ * @param  size  Number of items, at least 1.
  *
- * @param  this  A namespace item.
- * @param  that  A namespace item.
+ * @return An item array, or NULL if out of memory.
+ */
+static struct _namespace_item *_items_allocate(int size);
+
+/**
+ * Return an item array to the frame pool, or deallocate it.
  *
- * @return 1 if they have the same identifiers and Scheme elements,
- *         0 otherwise.
+ * @param  items  An item array, may be NULL.
+ * @param  size   Number of items it was allocated with.
  */
-static int _namespace_item_compare(struct _namespace_item *this, struct _namespace_item *that);
+static void _items_release(struct _namespace_item *items, int size);
+
+/**
+ * Create a namespace with room for a given number of items.
+ *
+ * @param  superset  Superset, may be NULL.
+ * @param  size      Number of items.
+ *
+ * @return A Scheme namespace, or NULL if out of memory.
+ */
+static scheme_namespace *_namespace_new(scheme_namespace *superset, int size);
+
+/**
+ * Store a copy of a Scheme element, associated with an identifier, in a
+ * namespace, without invalidating inline caches.
+ *
+ * @param  namespace   A Scheme namespace.
+ * @param  identifier  A Scheme symbol.
+ * @param  element     A Scheme element.
+ */
+static void _set(scheme_namespace *namespace, scheme_symbol *identifier, scheme_element *element);
 
 /**** Private variables ****/
 
+// Version of every namespace, changed whenever an element remembered by an
+// inline cache may no longer be the one a lookup would find. Empty caches
+// hold version 0.
+static unsigned long _version = 1;
+
+// Use of inline caches.
+static struct {
+    long hitCount;
+    long missCount;
+    long invalidationCount;
+} _cacheStats;
+
+// Frame pool: unused item arrays, by size. The first item of an unused
+// array holds a pointer to the next one.
+static struct _namespace_item *_pool[SCHEME_NAMESPACE_POOL_LIMIT + 1];
+static int _poolCount[SCHEME_NAMESPACE_POOL_LIMIT + 1];
+
 // Global virtual function table.
 static struct scheme_element_vtable _scheme_namespace_vtable = {
     .get_type = scheme_namespace_get_type,
     .free = _vtable_free,
     .print = _vtable_print,
-    .copy = _vtable_copy,
-    .compare = _vtable_compare
+    .compare = _vtable_compare,
+    .traverse = _vtable_traverse
 };
 
 // Static struct for namespace's type.
@@ -110,12 +188,17 @@ static void _vtable_free(scheme_element *element)
     int itemCount = namespace->itemCount;
     for (int i = 0; i < itemCount; ++i)
     {
-        struct _namespace_item item = namespace->items[i];
-        _namespace_item_free_content(&item);
+        scheme_element_free(namespace->items[i].element);
     }
 
-    free(namespace->items);
-    free(namespace);
+    _items_release(namespace->items, namespace->itemSize);
+    free(namespace->index);
+
+    // Inline caches may refer to elements of a namespace without superset.
+    if (namespace->superset == NULL && itemCount > 0)
+        scheme_namespace_invalidate_caches();
+
+    scheme_element_free((scheme_element *)namespace->superset);
 }
 
 static void _vtable_print(scheme_element *element)
@@ -123,178 +206,347 @@ static void _vtable_print(scheme_element *element)
     printf("#<namespace>");
 }
 
-static scheme_element *_vtable_copy(scheme_element *element)
+static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    scheme_namespace *namespace = (scheme_namespace *)element;
+    if (!scheme_element_is_namespace(other)) return 0;
 
-    // Allocate copy.
-    scheme_namespace *copy;
-    if ((copy = malloc(sizeof(scheme_namespace))) == NULL)
-        return NULL;
+    scheme_namespace *this = (scheme_namespace *)element;
+    scheme_namespace *that = (scheme_namespace *)other;
 
-    // Set up virtual function table.
-    copy->super.vtable = &_scheme_namespace_vtable;
+    if (this->itemCount != that->itemCount) return 0;
 
-    // Copy attributes.
-    copy->superset = namespace->superset;
-    copy->itemCount = namespace->itemCount;
-    copy->itemSize = namespace->itemSize;
+    if (!scheme_element_compare((scheme_element *)this->superset, (scheme_element *)that->superset))
+        return 0;
 
-    // Allocate identifier lookup table.
-    struct _namespace_item *items;
-    if ((items = malloc(sizeof(struct _namespace_item) * copy->itemSize)) == NULL)
+    int count = this->itemCount;
+    for (int i = 0; i < count; ++i)
     {
-        free(copy);
-        return NULL;
+        if (this->items[i].identifier != that->items[i].identifier) return 0;
+        if (!scheme_element_compare(this->items[i].element, that->items[i].element)) return 0;
     }
 
-    // Copy items.
-    int itemCount = copy->itemCount;
+    return 1;
+}
+
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit)
+{
+    scheme_namespace *namespace = (scheme_namespace *)element;
+
+    int itemCount = namespace->itemCount;
     for (int i = 0; i < itemCount; ++i)
     {
-        // TODO: Properly free items array and copy pointer if we run out of memory.
-        _namespace_item_init(items + i, namespace->items[i].identifier, namespace->items[i].element);
+        visit(&namespace->items[i].element);
     }
 
-    copy->items = items;
-
-    return (scheme_element *)copy;
+    visit((scheme_element **)&namespace->superset);
 }
 
-static int _vtable_compare(scheme_element *element, scheme_element *other)
+static int _find_slot(scheme_namespace *namespace, scheme_symbol *identifier)
 {
-    if (!scheme_element_is_type(other, &_scheme_namespace_type)) return 0;
-
-    scheme_namespace *this = (scheme_namespace *)element;
-    scheme_namespace *that = (scheme_namespace *)other;
+    struct _namespace_item *items = namespace->items;
 
-    if (this->itemCount != that->itemCount) return 0;
+    if (namespace->index == NULL)
+    {
+        int count = namespace->itemCount;
+        for (int i = 0; i < count; ++i)
+        {
+            if (items[i].identifier == identifier)
+                return i;
+        }
 
-    if (!scheme_element_compare((scheme_element *)this->superset, (scheme_element *)that->superset))
-        return 0;
+        return -1;
+    }
 
-    int count = this->itemCount;
-    for (int i = 0; i < count; ++i)
+    // Index is never full, so an unused entry is always found.
+    unsigned int mask = namespace->indexSize - 1;
+    unsigned int position = scheme_symbol_get_hash(identifier) & mask;
+    while (namespace->index[position] != 0)
     {
-        if (!_namespace_item_compare(this->items + i, that->items + i))
-            return 0;
+        int slot = namespace->index[position] - 1;
+        if (items[slot].identifier == identifier)
+            return slot;
+
+        position = (position + 1) & mask;
     }
 
-    return 1;
+    return -1;
 }
 
-static void _namespace_item_init(struct _namespace_item *item, const char *identifier, scheme_element *element)
+static void _index_insert(scheme_namespace *namespace, int slot)
 {
-    int idLength = strlen(identifier);
-    if ((item->identifier = malloc(sizeof(char) * (idLength + 1))) == NULL)
-        return;
-    strcpy(item->identifier, identifier);
+    unsigned int mask = namespace->indexSize - 1;
+    unsigned int position = scheme_symbol_get_hash(namespace->items[slot].identifier) & mask;
+    while (namespace->index[position] != 0)
+        position = (position + 1) & mask;
 
-    if ((item->element = scheme_element_copy(element)) == NULL)
-    {
-        free(item->identifier);
-        return;
-    }
+    namespace->index[position] = slot + 1;
 }
 
-static void _namespace_item_free_content(struct _namespace_item *item)
+static int _index_rebuild(scheme_namespace *namespace, int size)
 {
-    free(item->identifier);
-    scheme_element_free(item->element);
+    int *index = calloc(size, sizeof(int));
+    if (index == NULL) return 0;
+
+    free(namespace->index);
+    namespace->index = index;
+    namespace->indexSize = size;
+
+    for (int i = 0; i < namespace->itemCount; ++i)
+        _index_insert(namespace, i);
+
+    return 1;
 }
 
-static int _namespace_item_compare(struct _namespace_item *this, struct _namespace_item *that)
+static struct _namespace_item *_items_allocate(int size)
 {
-    if (strcmp(this->identifier, that->identifier) != 0) return 0;
-    if (!scheme_element_compare(this->element, that->element)) return 0;
+    if (size <= SCHEME_NAMESPACE_POOL_LIMIT && _pool[size] != NULL)
+    {
+        struct _namespace_item *items = _pool[size];
+        _pool[size] = (struct _namespace_item *)items[0].identifier;
+        _poolCount[size] -= 1;
+        return items;
+    }
 
-    return 1;
+    return malloc(sizeof(struct _namespace_item) * size);
 }
 
-/**** Public function implementations ****/
+static void _items_release(struct _namespace_item *items, int size)
+{
+    if (items == NULL) return;
 
-scheme_namespace *scheme_namespace_new(scheme_namespace *superset)
+    if (size <= SCHEME_NAMESPACE_POOL_LIMIT && _poolCount[size] < SCHEME_NAMESPACE_POOL_DEPTH)
+    {
+        items[0].identifier = (scheme_symbol *)_pool[size];
+        _pool[size] = items;
+        _poolCount[size] += 1;
+        return;
+    }
+
+    free(items);
+}
+
+static scheme_namespace *_namespace_new(scheme_namespace *superset, int size)
 {
     // Allocate namespace.
     scheme_namespace *namespace;
-    if ((namespace = malloc(sizeof(scheme_namespace))) == NULL)
+    if ((namespace = (scheme_namespace *)scheme_element_new(sizeof(scheme_namespace), &_scheme_namespace_vtable, SCHEME_ELEMENT_TAG_NAMESPACE)) == NULL)
         return NULL;
 
-    // Set up virtual function table.
-    namespace->super.vtable = &_scheme_namespace_vtable;
+    namespace->items = NULL;
+    namespace->itemCount = 0;
+    namespace->itemSize = 0;
+    namespace->index = NULL;
+    namespace->indexSize = 0;
+    namespace->superset = NULL;
 
     // Set up identifier lookup table.
-    struct _namespace_item *items;
-    if ((items = malloc(sizeof(struct _namespace_item) * SCHEME_NAMESPACE_INITIAL_SIZE)) == NULL)
+    if (size > 0)
     {
-        free(namespace);
-        return NULL;
+        struct _namespace_item *items;
+        if ((items = _items_allocate(size)) == NULL)
+        {
+            scheme_element_free((scheme_element *)namespace);
+            return NULL;
+        }
+        namespace->items = items;
+        namespace->itemSize = size;
     }
-    namespace->items = items;
-    namespace->itemSize = SCHEME_NAMESPACE_INITIAL_SIZE;
-    namespace->itemCount = 0;
 
     // Store superset.
-    if (superset != NULL && scheme_element_is_type((scheme_element *)superset, &_scheme_namespace_type))
-        namespace->superset = superset;
-    else
-        namespace->superset = NULL;
+    if (superset != NULL && scheme_element_is_namespace((scheme_element *)superset))
+        namespace->superset = (scheme_namespace *)scheme_element_copy((scheme_element *)superset);
 
     return namespace;
 }
 
-scheme_element *scheme_namespace_get(scheme_namespace *namespace, const char *identifier)
+static void _set(scheme_namespace *namespace, scheme_symbol *identifier, scheme_element *element)
 {
-    // Search in namespace.
-    int count = namespace->itemCount;
-    for (int i = 0; i < count; ++i)
-    {
-        if (strcmp(identifier, namespace->items[i].identifier) == 0)
-        {
-            return scheme_element_copy(namespace->items[i].element);
-        }
-    }
+    // The symbol may no longer refer to its built-in element.
+    if (scheme_symbol_get_builtin(identifier) != NULL)
+        scheme_symbol_set_builtin(identifier, NULL);
 
-    // Search in superset if one exists.
-    if (namespace->superset != NULL)
-        return scheme_namespace_get(namespace->superset, identifier);
-
-    return NULL;
-}
+    int slot = _find_slot(namespace, identifier);
 
-void scheme_namespace_set(scheme_namespace *namespace, const char *identifier, scheme_element *element)
-{
-    // Search in namespace to see if identifier already exists.
-    int count = namespace->itemCount;
-    for (int i = 0; i < count; ++i)
+    if (slot >= 0)
     {
-        if (strcmp(identifier, namespace->items[i].identifier) == 0)
-        {
-            // Store given element under this identifier.
-            scheme_element_free(namespace->items[i].element);
-            namespace->items[i].element = scheme_element_copy(element);
+        // Store given element under this identifier.
+        struct _namespace_item *item = namespace->items + slot;
+        scheme_element_free(item->element);
+        item->element = scheme_element_copy(element);
+        scheme_gc_write_barrier((scheme_element *)namespace, element);
 
-            return;
-        }
+        return;
     }
 
     // Create new namespace item to store element.
     // Ensure we have enough space.
+    int count = namespace->itemCount;
+    // A frame only grows when something other than its arguments is
+    // defined in it.
     if (count >= namespace->itemSize)
     {
         int newSize = namespace->itemSize * 2;
-        struct _namespace_item *newItems = malloc(sizeof(struct _namespace_item) * newSize);
+        if (newSize < SCHEME_NAMESPACE_INITIAL_SIZE)
+            newSize = SCHEME_NAMESPACE_INITIAL_SIZE;
+
+        struct _namespace_item *newItems = _items_allocate(newSize);
         if (newItems == NULL) return;
 
-        memcpy(newItems, namespace->items, sizeof(struct _namespace_item) * namespace->itemSize);
-        free(namespace->items);
+        if (count > 0)
+            memcpy(newItems, namespace->items, sizeof(struct _namespace_item) * count);
+        _items_release(namespace->items, namespace->itemSize);
 
         namespace->items = newItems;
         namespace->itemSize = newSize;
     }
 
-    _namespace_item_init(namespace->items + count, identifier, element);
+    // Ensure the index stays at most three quarters full once the namespace
+    // is too large to be searched linearly.
+    if (count + 1 > SCHEME_NAMESPACE_LINEAR_LIMIT && (count + 1) * 4 > namespace->indexSize * 3)
+    {
+        int newSize = namespace->indexSize > 0 ? namespace->indexSize * 2 : SCHEME_NAMESPACE_LINEAR_LIMIT * 4;
+        if (!_index_rebuild(namespace, newSize)) return;
+    }
+
+    namespace->items[count].identifier = identifier;
+    namespace->items[count].element = scheme_element_copy(element);
     namespace->itemCount += 1;
+
+    if (namespace->index != NULL)
+        _index_insert(namespace, count);
+
+    scheme_gc_write_barrier((scheme_element *)namespace, element);
+}
+
+/**** Public function implementations ****/
+
+scheme_namespace *scheme_namespace_new(scheme_namespace *superset)
+{
+    return _namespace_new(superset, SCHEME_NAMESPACE_INITIAL_SIZE);
+}
+
+scheme_namespace *scheme_namespace_new_frame(scheme_namespace *superset, int size)
+{
+    return _namespace_new(superset, size > 0 ? size : 0);
+}
+
+scheme_namespace *scheme_namespace_get_root(scheme_namespace *namespace)
+{
+    while (namespace->superset != NULL)
+        namespace = namespace->superset;
+
+    return namespace;
+}
+
+scheme_element *scheme_namespace_get(scheme_namespace *namespace, const char *identifier)
+{
+    scheme_symbol *symbol = scheme_symbol_new(identifier);
+    if (symbol == NULL) return NULL;
+
+    return scheme_namespace_get_symbol(namespace, symbol);
+}
+
+scheme_element *scheme_namespace_get_symbol(scheme_namespace *namespace, scheme_symbol *identifier)
+{
+    return scheme_element_copy(scheme_namespace_lookup_ref(namespace, identifier));
+}
+
+scheme_element *scheme_namespace_lookup_ref(scheme_namespace *namespace, scheme_symbol *identifier)
+{
+    // Search in namespace, then in each superset.
+    while (namespace != NULL)
+    {
+        int slot = _find_slot(namespace, identifier);
+        if (slot >= 0)
+            return namespace->items[slot].element;
+
+        namespace = namespace->superset;
+    }
+
+    return NULL;
+}
+
+scheme_element *scheme_namespace_lookup_cached_ref(scheme_namespace *namespace,
+                                                   scheme_symbol *identifier,
+                                                   scheme_namespace_cache *cache)
+{
+    if (cache->version == _version)
+    {
+        ++_cacheStats.hitCount;
+        return cache->element;
+    }
+
+    ++_cacheStats.missCount;
+
+    // Search like scheme_namespace_lookup_ref(), but remember where the
+    // element was found.
+    cache->version = 0;
+    while (namespace != NULL)
+    {
+        int slot = _find_slot(namespace, identifier);
+        if (slot >= 0)
+        {
+            scheme_element *element = namespace->items[slot].element;
+            if (namespace->superset == NULL)
+            {
+                cache->element = element;
+                cache->version = _version;
+            }
+
+            return element;
+        }
+
+        namespace = namespace->superset;
+    }
+
+    return NULL;
+}
+
+scheme_element *scheme_namespace_lookup_slot_ref(scheme_namespace *namespace, int depth, int slot, scheme_symbol *identifier)
+{
+    for (int i = 0; i < depth && namespace != NULL; ++i)
+        namespace = namespace->superset;
+
+    if (namespace == NULL || slot >= namespace->itemCount) return NULL;
+    if (namespace->items[slot].identifier != identifier) return NULL;
+
+    return namespace->items[slot].element;
+}
+
+void scheme_namespace_set(scheme_namespace *namespace, const char *identifier, scheme_element *element)
+{
+    scheme_symbol *symbol = scheme_symbol_new(identifier);
+    if (symbol == NULL) return;
+
+    scheme_namespace_set_symbol(namespace, symbol, element);
+}
+
+void scheme_namespace_set_symbol(scheme_namespace *namespace, scheme_symbol *identifier, scheme_element *element)
+{
+    _set(namespace, identifier, element);
+
+    // The element may shadow or replace one remembered by an inline cache.
+    scheme_namespace_invalidate_caches();
+}
+
+void scheme_namespace_bind_symbol(scheme_namespace *namespace, scheme_symbol *identifier, scheme_element *element)
+{
+    _set(namespace, identifier, element);
+}
+
+void scheme_namespace_invalidate_caches()
+{
+    ++_version;
+    ++_cacheStats.invalidationCount;
+}
+
+void scheme_namespace_print_cache_stats()
+{
+    long total = _cacheStats.hitCount + _cacheStats.missCount;
+    fprintf(stderr, "Inline cache hits: %ld of %ld lookups (%.1f%%)\n",
+            _cacheStats.hitCount, total, total > 0 ? 100.0 * _cacheStats.hitCount / total : 0.0);
+    fprintf(stderr, "Inline cache misses: %ld\n", _cacheStats.missCount);
+    fprintf(stderr, "Inline cache invalidations: %ld\n", _cacheStats.invalidationCount);
 }
 
 scheme_element_type *scheme_namespace_get_type()
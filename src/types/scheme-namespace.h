@@ -12,32 +12,65 @@
 #define __SCHEME_NAMESPACE_H__
 
 #include "scheme-element.h"
+#include "scheme-symbol.h"
 
 // Scheme namespace.
 typedef struct scheme_namespace scheme_namespace;
 
+// Inline cache of the element an identifier refers to, kept by the code
+// that looks it up, such as the procedure of a call. A cache filled with
+// zeros is empty.
+typedef struct scheme_namespace_cache {
+    scheme_element *element;
+    unsigned long version;
+} scheme_namespace_cache;
+
 /**
  * Create new, empty Scheme namespace.
  *
- * Returned pointer must be freed with scheme_element_free(). Any element
- * stored in the freed namespace will also be freed. If you need to retain
- * any of them, consider making a copy with scheme_element_copy().
+ * Returned pointer must be freed with scheme_element_free(). References
+ * to elements stored in the freed namespace will also be released. If you
+ * need to retain any of them, consider making a copy with
+ * scheme_element_copy().
  *
- * A copy of a Scheme namespace created with scheme_element_copy() will
- * include a copy of every element it refers to.
+ * Unlike other Scheme elements, a namespace can be modified after it has
+ * been created. A copy of a Scheme namespace created with
+ * scheme_element_copy() refers to the same namespace.
  *
- * @param  superset  If not NULL, newly created namespace will keep a weak
+ * @param  superset  If not NULL, newly created namespace will keep a
  *                   reference to the given namespace and will be able to
  *                   refer to any identifier stored there.
  *
- *                   A copy of a Scheme namespace created with
- *                   scheme_element_copy() will also only store a weak
- *                   reference to this namespace.
- *
  * @return Newly created Scheme namespace.
  */
 scheme_namespace *scheme_namespace_new(scheme_namespace *superset);
 
+/**
+ * Create new, empty Scheme namespace with room for exactly the given number
+ * of identifiers, such as the arguments of a procedure.
+ *
+ * Small frames reuse memory from namespaces freed earlier instead of
+ * allocating it. Storing more identifiers than the frame has room for is
+ * allowed, but makes it allocate as much room as scheme_namespace_new().
+ *
+ * @param  superset  Same as in scheme_namespace_new().
+ * @param  size      Number of identifiers.
+ *
+ * @return Newly created Scheme namespace.
+ */
+scheme_namespace *scheme_namespace_new_frame(scheme_namespace *superset, int size);
+
+/**
+ * Get the namespace without superset at the end of a namespace's chain of
+ * supersets, such as the base namespace, where global identifiers are
+ * stored. The returned namespace must not be freed.
+ *
+ * @param  namespace  A Scheme namespace.
+ *
+ * @return Namespace without superset, which may be the given namespace.
+ */
+scheme_namespace *scheme_namespace_get_root(scheme_namespace *namespace);
+
 /**
  * Get element associated with an identifier in the namespace.
  *
@@ -53,9 +86,94 @@ scheme_namespace *scheme_namespace_new(scheme_namespace *superset);
  */
 scheme_element *scheme_namespace_get(scheme_namespace *namespace, const char *identifier);
 
+/**
+ * Get element associated with an identifier in the namespace.
+ *
+ * Same as scheme_namespace_get(), without having to look up the interned
+ * symbol for the identifier first.
+ *
+ * @param  namespace   A Scheme namespace.
+ * @param  identifier  A Scheme symbol.
+ *
+ * @return Associated element, or NULL if there is no element associated
+ *         with given identifier.
+ */
+scheme_element *scheme_namespace_get_symbol(scheme_namespace *namespace, scheme_symbol *identifier);
+
+/**
+ * Get element associated with an identifier in the namespace, without
+ * acquiring a reference to it.
+ *
+ * The returned element must not be freed. It is only guaranteed to remain
+ * valid until the identifier is associated with another element or the
+ * namespace is freed; copy it with scheme_element_copy() to keep it longer.
+ *
+ * @param  namespace   A Scheme namespace.
+ * @param  identifier  A Scheme symbol.
+ *
+ * @return Associated element, or NULL if there is no element associated
+ *         with given identifier.
+ */
+scheme_element *scheme_namespace_lookup_ref(scheme_namespace *namespace, scheme_symbol *identifier);
+
+/**
+ * Get element associated with an identifier in the namespace, without
+ * acquiring a reference to it, remembering it in an inline cache.
+ *
+ * An element found in a namespace without a superset, such as the base
+ * namespace, is remembered until an identifier is associated with an
+ * element in any namespace with scheme_namespace_set_symbol(), or until
+ * elements are moved by the garbage collector. Until then, the cached
+ * element is returned without searching any namespace. Elements found in
+ * other namespaces are never remembered.
+ *
+ * The same cache must only be given namespaces with the same enclosing
+ * namespaces, such as the local namespaces of a given procedure, which
+ * is the case for a call in the body of a procedure. The identifier must
+ * not be one that any of those namespaces may bind, since the cached element
+ * is returned without checking them. Identifiers left as symbols by the
+ * resolver qualify: those an enclosing body may define are replaced with
+ * dynamic references instead.
+ *
+ * The same rules as scheme_namespace_lookup_ref() apply to the returned
+ * element.
+ *
+ * @param  namespace   A Scheme namespace.
+ * @param  identifier  A Scheme symbol.
+ * @param  cache       Inline cache of this lookup.
+ *
+ * @return Associated element, or NULL if there is no element associated
+ *         with given identifier.
+ */
+scheme_element *scheme_namespace_lookup_cached_ref(scheme_namespace *namespace,
+                                                   scheme_symbol *identifier,
+                                                   scheme_namespace_cache *cache);
+
+/**
+ * Get element stored in a given slot of a namespace, without acquiring a
+ * reference to it.
+ *
+ * Identifiers are assigned slots 0, 1, 2... in the order they are first
+ * stored in a namespace, and keep them for as long as the namespace
+ * exists. The namespace searched is the one reached by following the
+ * superset chain 'depth' times.
+ *
+ * The same rules as scheme_namespace_lookup_ref() apply to the returned
+ * element.
+ *
+ * @param  namespace   A Scheme namespace.
+ * @param  depth       Number of supersets to go through.
+ * @param  slot        Slot in that namespace.
+ * @param  identifier  Identifier expected in that slot.
+ *
+ * @return Element in the slot, or NULL if the namespace does not exist or
+ *         the slot does not hold the expected identifier.
+ */
+scheme_element *scheme_namespace_lookup_slot_ref(scheme_namespace *namespace, int depth, int slot, scheme_symbol *identifier);
+
 /**
  * Store a copy of a Scheme element, associated with an identifier, in
- * the given namespace.
+ * the given namespace. The element itself is shared, not duplicated.
  *
  * @param  namespace   A Scheme namespace.
  * @param  identifier  An identifier.
@@ -63,6 +181,46 @@ scheme_element *scheme_namespace_get(scheme_namespace *namespace, const char *id
  */
 void scheme_namespace_set(scheme_namespace *namespace, const char *identifier, scheme_element *element);
 
+/**
+ * Store a copy of a Scheme element, associated with an identifier, in
+ * the given namespace.
+ *
+ * Same as scheme_namespace_set(), without having to look up the interned
+ * symbol for the identifier first.
+ *
+ * @param  namespace   A Scheme namespace.
+ * @param  identifier  A Scheme symbol.
+ * @param  element     A Scheme element.
+ */
+void scheme_namespace_set_symbol(scheme_namespace *namespace, scheme_symbol *identifier, scheme_element *element);
+
+/**
+ * Store a copy of a Scheme element, associated with an identifier, in a
+ * namespace that was just created to hold the arguments of a procedure.
+ *
+ * Same as scheme_namespace_set_symbol(), except that elements remembered
+ * by scheme_namespace_lookup_cached_ref() remain valid: arguments are
+ * stored before the body of their procedure is evaluated, so any lookup
+ * from the body that can find one always does, and is never cached.
+ *
+ * @param  namespace   A Scheme namespace being filled with arguments.
+ * @param  identifier  A Scheme symbol.
+ * @param  element     A Scheme element.
+ */
+void scheme_namespace_bind_symbol(scheme_namespace *namespace, scheme_symbol *identifier, scheme_element *element);
+
+/**
+ * Forget every element remembered by scheme_namespace_lookup_cached_ref(),
+ * such as after elements were moved.
+ */
+void scheme_namespace_invalidate_caches();
+
+/**
+ * Print how often elements remembered by
+ * scheme_namespace_lookup_cached_ref() were used to stderr.
+ */
+void scheme_namespace_print_cache_stats();
+
 /**
  * Get namespace's type.
  *
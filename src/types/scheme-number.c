@@ -13,7 +13,8 @@ struct scheme_number {
 /**** Private function declarations ****/
 
 /**
- * Free Scheme number.
+ * Scheme numbers do not own any other resource. This function does
+ * nothing.
  *
  * @param  element  Should be a Scheme number symbol.
  */
@@ -26,15 +27,6 @@ static void _vtable_free(scheme_element *element);
  */
 static void _vtable_print(scheme_element *element);
 
-/**
- * Copy number symbol.
- *
- * @param  element  Should be a Scheme number symbol.
- *
- * @return A copy, or NULL if out of memory.
- */
-static scheme_element *_vtable_copy(scheme_element *element);
-
 /**
  * Compare number symbol to another symbol.
  * Will return 0 if either pointer is not a number symbol.
@@ -53,7 +45,6 @@ static struct scheme_element_vtable _scheme_number_vtable = {
     .get_type = scheme_number_get_type,
     .free = _vtable_free,
     .print = _vtable_print,
-    .copy = _vtable_copy,
     .compare = _vtable_compare
 };
 
@@ -66,10 +57,7 @@ static int _scheme_number_type_initd = 0;
 
 /**** Private function implementations ****/
 
-static void _vtable_free(scheme_element *element)
-{
-    free(element);
-}
+static void _vtable_free(scheme_element *element) {}
 
 static void _vtable_print(scheme_element *element)
 {
@@ -77,31 +65,26 @@ static void _vtable_print(scheme_element *element)
     printf("%ld", symbol->value);
 }
 
-static scheme_element *_vtable_copy(scheme_element *element)
-{
-    scheme_number *num = (scheme_number *)element;
-    return (scheme_element *)scheme_number_new(num->value);
-}
-
 static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    if (!scheme_element_is_type(other, &_scheme_number_type)) return 0;
+    if (!scheme_element_is_number(other)) return 0;
 
-    return ((scheme_number *)element)->value == ((scheme_number *)other)->value;
+    return ((scheme_number *)element)->value == scheme_number_get_value((scheme_number *)other);
 }
 
 /**** Public function implementations ****/
 
 scheme_number *scheme_number_new(long value)
 {
+    // Small integers are stored in the pointer itself.
+    if (value >= SCHEME_ELEMENT_FIXNUM_MIN && value <= SCHEME_ELEMENT_FIXNUM_MAX)
+        return (scheme_number *)scheme_element_fixnum_new(value);
+
     // Allocate symbol.
     scheme_number *symbol;
-    if ((symbol = malloc(sizeof(scheme_number))) == NULL)
+    if ((symbol = (scheme_number *)scheme_element_new(sizeof(scheme_number), &_scheme_number_vtable, SCHEME_ELEMENT_TAG_NUMBER)) == NULL)
         return NULL;
 
-    // Set up virtual function table.
-    symbol->super.vtable = &_scheme_number_vtable;
-
     symbol->value = value;
 
     return symbol;
@@ -109,6 +92,9 @@ scheme_number *scheme_number_new(long value)
 
 long scheme_number_get_value(scheme_number *symbol)
 {
+    if (scheme_element_is_fixnum((scheme_element *)symbol))
+        return scheme_element_fixnum_get_value((scheme_element *)symbol);
+
     return symbol->value;
 }
 
@@ -17,7 +17,9 @@ typedef struct scheme_number scheme_number;
 /**
  * Create new Scheme number symbol.
  *
- * Returned pointer must be freed with scheme_element_free().
+ * Returned pointer must be freed with scheme_element_free(). Small values
+ * are stored in the pointer itself rather than allocated, so the pointer
+ * must only be passed to the functions of Scheme elements and numbers.
  *
  * @param  value  Symbol's initial value.
  *
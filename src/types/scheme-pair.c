@@ -4,46 +4,57 @@
 
 #include "scheme-pair.h"
 #include "scheme-element-private.h"
+#include "scheme-gc.h"
 
 // Scheme pair.
-struct scheme_pair {
-    struct scheme_element super;
-    scheme_element *first;
-    scheme_element *second;
-};
+//
+// struct scheme_pair is never defined. A pair is either the empty pair, an
+// element without fields, or a reference to a cell holding its first and
+// second element. Check scheme-element-private.h for details on cells.
+//
+// Lists are walked along their second elements in a loop, so that long lists
+// do not exhaust the C stack. Pairs nested in first elements are kept on a
+// stack of pending pairs instead of being handled recursively. Functions
+// using that stack may be called again while walking, for instance to free a
+// lambda procedure stored in a list, so each one only pops the pairs it
+// pushed itself.
 
 /**** Private function declarations ****/
 
 /**
- * Free pair. Will also free its first and second elements.
+ * Push a pair onto the stack of pending pairs.
  *
- * @param  element  Should be a Scheme pair.
+ * @param  pair  A Scheme pair other than the empty pair.
+ *
+ * @return 1 on success, 0 if out of memory.
  */
-static void _vtable_free(scheme_element *element);
+static int _push_pending(scheme_element *pair);
 
 /**
- * Copy pair.
+ * Release a reference held by a pair. If it was the last reference to a
+ * cell, the cell is left for the caller to free, so that lists are freed
+ * without recursion.
  *
- * @param  element  Should be a Scheme pair.
+ * @param  element  A Scheme element.
  *
- * @return Copy or NULL if out of memory.
+ * @return 1 if element is a cell whose fields must be released, then the
+ *         cell itself with scheme_gc_release_cell(), 0 otherwise.
  */
-static scheme_element *_vtable_copy(scheme_element *element);
+static int _release(scheme_element *element);
 
 /**
- * Print pair to stdout.
+ * Free pair. Will also free its first and second elements.
  *
  * @param  element  Should be a Scheme pair.
  */
-static void _vtable_print(scheme_element *element);
+static void _vtable_free(scheme_element *element);
 
 /**
- * Recursively print pair and its elements to stdout.
- * Used in _vtable_print().
+ * Print pair to stdout.
  *
- * @param  element  A Scheme pair.
+ * @param  element  Should be a Scheme pair.
  */
-static void _do_print(scheme_pair *pair);
+static void _vtable_print(scheme_element *element);
 
 /**
  * Compare a Scheme pair to another pair.
@@ -56,6 +67,14 @@ static void _do_print(scheme_pair *pair);
  */
 static int _vtable_compare(scheme_element *element, scheme_element *other);
 
+/**
+ * Pass references held by a Scheme pair to a visitor.
+ *
+ * @param  element  Should be a Scheme pair.
+ * @param  visit    A visitor.
+ */
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit);
+
 /**** Private variables ****/
 
 // Global virtual function table.
@@ -63,17 +82,21 @@ static struct scheme_element_vtable _scheme_pair_vtable = {
     .get_type = scheme_pair_get_type,
     .free = _vtable_free,
     .print = _vtable_print,
-    .copy = _vtable_copy,
-    .compare = _vtable_compare
+    .compare = _vtable_compare,
+    .traverse = _vtable_traverse
 };
 
 // Static variables for empty list.
-static struct scheme_pair _empty_pair = {
-    .super.vtable = &_scheme_pair_vtable,
-    .first = NULL,
-    .second = NULL
+static struct scheme_element _empty_pair = {
+    .vtable = &_scheme_pair_vtable,
+    .tag = SCHEME_ELEMENT_TAG_PAIR
 };
 
+// Stack of pending pairs.
+static scheme_element **_pending = NULL;
+static int _pendingCount = 0;
+static int _pendingSize = 0;
+
 // Global pair type.
 static struct scheme_element_type _scheme_pair_type = {
     .super = NULL,
@@ -83,115 +106,241 @@ static int _scheme_pair_type_initd = 0;
 
 /**** Private function implementations ****/
 
-static void _vtable_free(scheme_element *element)
+static int _push_pending(scheme_element *pair)
 {
-    scheme_pair *pair = (scheme_pair *)element;
+    if (_pendingCount == _pendingSize)
+    {
+        int newSize = _pendingSize > 0 ? _pendingSize * 2 : 64;
+        scheme_element **newPending = realloc(_pending, sizeof(scheme_element *) * newSize);
+        if (newPending == NULL) return 0;
 
-    // Do not free empty pair.
-    if (pair == &_empty_pair) return;
+        _pending = newPending;
+        _pendingSize = newSize;
+    }
 
-    scheme_element_free(pair->first);
-    scheme_element_free(pair->second);
-    free(pair);
+    _pending[_pendingCount++] = pair;
+    return 1;
 }
 
-static scheme_element *_vtable_copy(scheme_element *element)
+static int _release(scheme_element *element)
 {
-    scheme_pair *pair = (scheme_pair *)element;
+    if (!scheme_element_is_cell(element))
+    {
+        scheme_element_free(element);
+        return 0;
+    }
 
-    // Do not copy the empty pair.
-    if (pair == &_empty_pair)
-        return element;
+    // Unreachable cells being swept are deallocated by the garbage collector.
+    if (scheme_gc_is_sweeping()) return 0;
 
-    return (scheme_element *)scheme_pair_new(pair->first, pair->second);
+    int *refCount = &scheme_element_cell_get_block(element)->refCounts[scheme_element_cell_get_index(element)];
+    return --*refCount == 0;
+}
+
+static void _vtable_free(scheme_element *element)
+{
+    // Do not free empty pair.
+    if (!scheme_element_is_cell(element)) return;
+
+    // The cell itself is released by scheme_element_free(), the cells freed
+    // below are released here.
+    int base = _pendingCount;
+    scheme_element *cell = element;
+    while (1)
+    {
+        scheme_element **fields = scheme_element_cell_get_fields(cell);
+        scheme_element *first = fields[0];
+        scheme_element *second = fields[1];
+        if (cell != element)
+            scheme_gc_release_cell(cell);
+
+        if (_release(first) && !_push_pending(first))
+        {
+            // Out of memory, fall back to recursion.
+            _vtable_free(first);
+            scheme_gc_release_cell(first);
+        }
+
+        if (_release(second))
+        {
+            cell = second;
+        }
+        else if (_pendingCount > base)
+        {
+            cell = _pending[--_pendingCount];
+        }
+        else
+        {
+            break;
+        }
+    }
 }
 
 static void _vtable_print(scheme_element *element)
 {
     // Special treatment for empty pair.
-    if ((scheme_pair *)element == &_empty_pair)
+    if (element == &_empty_pair)
     {
         printf("()");
         return;
     }
 
-    scheme_pair *pair = (scheme_pair *)element;
-
+    // Pairs whose first element is being printed are pending, their second
+    // element is printed afterwards.
+    int base = _pendingCount;
+    scheme_element *pair = element;
     putchar('(');
-    _do_print(pair);
-    putchar(')');
+    while (1)
+    {
+        scheme_element *first = scheme_pair_get_first((scheme_pair *)pair);
+        if (scheme_element_is_cell(first) && _push_pending(pair))
+        {
+            putchar('(');
+            pair = first;
+            continue;
+        }
+
+        scheme_element_print(first);
+
+        // If second element is a pair, print it in condensed form.
+        // Else, use dot syntax. Then close every list that ended.
+        while (1)
+        {
+            scheme_element *second = scheme_pair_get_second((scheme_pair *)pair);
+            if (scheme_element_is_cell(second))
+            {
+                putchar(' ');
+                pair = second;
+                break;
+            }
+
+            if (second != &_empty_pair)
+            {
+                printf(" . ");
+                scheme_element_print(second);
+            }
+
+            putchar(')');
+
+            if (_pendingCount == base) return;
+            pair = _pending[--_pendingCount];
+        }
+    }
 }
 
-static void _do_print(scheme_pair *pair)
+static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    // Print first element.
-    scheme_element_print(pair->first);
+    if (!scheme_element_is_pair(other)) return 0;
 
-    // If second element is a pair, print it in condensed form.
-    // Else, use dot syntax.
-    if (scheme_element_is_type(pair->second, &_scheme_pair_type))
+    // Special treatment for empty pairs.
+    if (!scheme_element_is_cell(element) || !scheme_element_is_cell(other))
+        return element == other;
+
+    // Pairs found in first elements are pending, two by two, and compared
+    // after the current lists.
+    int base = _pendingCount;
+    int equal = 1;
+    scheme_element *this = element;
+    scheme_element *that = other;
+    while (equal)
     {
-        if ((scheme_pair *)pair->second != &_empty_pair)
+        scheme_element **thisFields = scheme_element_cell_get_fields(this);
+        scheme_element **thatFields = scheme_element_cell_get_fields(that);
+
+        int pushed = 0;
+        if (scheme_element_is_cell(thisFields[0]) && scheme_element_is_cell(thatFields[0]) && _push_pending(thisFields[0]))
         {
-            putchar(' ');
-            _do_print((scheme_pair *)pair->second);
+            if (_push_pending(thatFields[0]))
+                pushed = 1;
+            else
+                --_pendingCount;
+        }
+
+        // Out of memory or not both pairs, compare now.
+        if (!pushed && !scheme_element_compare(thisFields[0], thatFields[0]))
+        {
+            equal = 0;
+            break;
+        }
+
+        if (scheme_element_is_cell(thisFields[1]) && scheme_element_is_cell(thatFields[1]))
+        {
+            this = thisFields[1];
+            that = thatFields[1];
+        }
+        else if (!scheme_element_compare(thisFields[1], thatFields[1]))
+        {
+            equal = 0;
+        }
+        else if (_pendingCount > base)
+        {
+            that = _pending[--_pendingCount];
+            this = _pending[--_pendingCount];
+        }
+        else
+        {
+            break;
         }
     }
-    else
-    {
-        printf(" . ");
-        scheme_element_print(pair->second);
-    }
+
+    _pendingCount = base;
+    return equal;
 }
 
-static int _vtable_compare(scheme_element *element, scheme_element *other)
+static void _vtable_traverse(scheme_element *element, scheme_element_visitor_t visit)
 {
-    if (!scheme_element_is_type(other, &_scheme_pair_type)) return 0;
+    if (!scheme_element_is_cell(element)) return;
 
-    scheme_pair *this = (scheme_pair *)element;
-    scheme_pair *that = (scheme_pair *)other;
+    scheme_element **fields = scheme_element_cell_get_fields(element);
+    visit(&fields[0]);
+    visit(&fields[1]);
+}
 
-    // Special treatment for empty pairs.
-    if (scheme_pair_is_empty(this) && scheme_pair_is_empty(that))
-        return 1;
+/**** Implementations of functions from scheme-element-private.h ****/
 
-    return scheme_element_compare(this->first, that->first)
-        && scheme_element_compare(this->second, that->second);
+struct scheme_element_vtable *scheme_pair_get_cell_vtable()
+{
+    return &_scheme_pair_vtable;
 }
 
 /**** Public function implementations ****/
 
 scheme_pair *scheme_pair_new(scheme_element *first, scheme_element *second)
 {
-    scheme_pair *pair;
-    if ((pair = malloc(sizeof(scheme_pair))) == NULL)
-        return NULL;
+    first = scheme_element_copy(first);
+    second = scheme_element_copy(second);
 
-    pair->super.vtable = &_scheme_pair_vtable;
-    pair->first = scheme_element_copy(first);
-    pair->second = scheme_element_copy(second);
+    scheme_element *cell;
+    if ((cell = scheme_gc_allocate_cell(first, second)) == NULL)
+    {
+        scheme_element_free(first);
+        scheme_element_free(second);
+        return NULL;
+    }
 
-    return pair;
+    return (scheme_pair *)cell;
 }
 
 scheme_pair *scheme_pair_get_empty()
 {
-    return &_empty_pair;
+    return (scheme_pair *)&_empty_pair;
 }
 
 int scheme_pair_is_empty(scheme_pair *pair)
 {
-    return pair == &_empty_pair;
+    return (scheme_element *)pair == &_empty_pair;
 }
 
 scheme_element *scheme_pair_get_first(scheme_pair *pair)
 {
-    return pair->first;
+    if (!scheme_element_is_cell((scheme_element *)pair)) return NULL;
+    return scheme_element_cell_get_fields((scheme_element *)pair)[0];
 }
 
 scheme_element *scheme_pair_get_second(scheme_pair *pair)
 {
-    return pair->second;
+    if (!scheme_element_is_cell((scheme_element *)pair)) return NULL;
+    return scheme_element_cell_get_fields((scheme_element *)pair)[1];
 }
 
 scheme_element_type *scheme_pair_get_type()
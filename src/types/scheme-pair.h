@@ -20,6 +20,11 @@ typedef struct scheme_pair scheme_pair;
 /**
  * Create a new Scheme pair, which will store a copy of the given elements.
  *
+ * Elements are shared rather than duplicated, so creating a pair takes
+ * constant time no matter how large its elements are. In particular,
+ * adding an element to the front of an existing list does not copy the
+ * list.
+ *
  * Returned pointer must be freed with scheme_element_free(). The pair's first
  * and second element will also be freed.
  *
@@ -27,9 +32,6 @@ typedef struct scheme_pair scheme_pair;
  * freeing the pair, consider making a copy of those elements using
  * scheme_element_copy().
  *
- * A copy of a pair created by scheme_element_copy() will also include copies
- * of its first and second elements.
- *
  * @param  first   Pair's first element.
  * @param  second  Pair's second element.
  *
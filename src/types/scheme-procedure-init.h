@@ -23,16 +23,29 @@
  */
 typedef scheme_element *(*scheme_procedure_function_t)(scheme_procedure *, scheme_element *, scheme_namespace *);
 
+/**
+ * Typedef for function pointer that can be stored in a strict Scheme
+ * procedure, which receives its arguments already evaluated.
+ *
+ * @param Procedure that stores function pointer.
+ * @param Array of evaluated arguments, which still belong to the caller.
+ * @param Number of arguments.
+ */
+typedef scheme_element *(*scheme_procedure_strict_function_t)(scheme_procedure *, scheme_element **, int);
+
 // Scheme procedure struct.
 struct scheme_procedure {
     struct scheme_element super;
     char *name;
     scheme_procedure_function_t function;
+    // Function receiving evaluated arguments, or NULL if procedure is not
+    // strict.
+    scheme_procedure_strict_function_t strictFunction;
+    // 1 if procedure has no side effects and its result only depends on its
+    // arguments.
+    int pure;
 };
 
-// Global virtual function table.
-struct scheme_element_vtable scheme_procedure_vtable;
-
 /**
  * Initialize a scheme_procedure struct that has already been allocated.
  *
@@ -50,6 +63,22 @@ struct scheme_element_vtable scheme_procedure_vtable;
  * @param  name      Proecdure's name. If procedure is unnamed, pass NULL.
  * @param  function  A function pointer.
  */
-void scheme_procedure_init(scheme_procedure *proc, char *name, scheme_procedure_function_t function);
+void scheme_procedure_init(scheme_procedure *proc, const char *name, scheme_procedure_function_t function);
+
+/**
+ * Initialize a strict scheme_procedure struct that has already been
+ * allocated.
+ *
+ * Same as scheme_procedure_init(), except that the given function receives
+ * an array of arguments that have already been evaluated, from left to
+ * right. Evaluators that have evaluated the arguments themselves pass them
+ * to the function as is; otherwise, the procedure evaluates them into an
+ * array on the stack before calling the function.
+ *
+ * @param  proc      A Scheme procedure.
+ * @param  name      Proecdure's name. If procedure is unnamed, pass NULL.
+ * @param  function  A function pointer.
+ */
+void scheme_procedure_init_strict(scheme_procedure *proc, const char *name, scheme_procedure_strict_function_t function);
 
 #endif
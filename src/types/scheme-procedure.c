@@ -5,6 +5,11 @@
 #include "scheme-procedure.h"
 #include "scheme-procedure-init.h"
 #include "scheme-element-private.h"
+#include "eval.h"
+
+// Number of arguments a strict procedure evaluates without allocating an
+// array.
+#define SCHEME_PROCEDURE_ARGUMENT_COUNT 8
 
 /**** Private function declarations ****/
 
@@ -22,16 +27,6 @@ static void _vtable_free(scheme_element *element);
  */
 static void _vtable_print(scheme_element *element);
 
-/**
- * Copy a procedure.
- * Returned pointer must be freed with scheme_element_free().
- *
- * @param  element  Should be a Scheme procedure.
- *
- * @return Copy or NULL if out of memory.
- */
-static scheme_element *_vtable_copy(scheme_element *element);
-
 /**
  * Compare a Scheme procedure to another procedure.
  * Will return 0 if either pointer is not a procedure.
@@ -43,13 +38,51 @@ static scheme_element *_vtable_copy(scheme_element *element);
  */
 static int _vtable_compare(scheme_element *element, scheme_element *other);
 
+/**
+ * Implementation of the procedure wrapping evaluated arguments that do not
+ * evaluate to themselves. Returns its only argument unevaluated.
+ *
+ * @param  procedure  Procedure that refers to this function.
+ * @param  element    A list with a single element.
+ * @param  namespace  Active namespace.
+ *
+ * @return Element in list.
+ */
+static scheme_element *_value_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+
+/**
+ * Function of every strict procedure: evaluate each argument into an array
+ * and pass it to the procedure's strict function.
+ *
+ * @param  procedure  A strict procedure.
+ * @param  element    List of arguments.
+ * @param  namespace  Active namespace.
+ *
+ * @return Result of strict function, or NULL if element is not a list or
+ *         an argument could not be evaluated.
+ */
+static scheme_element *_strict_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+
+/**
+ * Get the virtual function table of statically allocated procedures.
+ *
+ * @return Virtual function table.
+ */
+static struct scheme_element_vtable *_static_procedure_vtable_get();
+
+/**
+ * Prevent freeing the statically allocated value procedure and tail call
+ * marker.
+ * This function does nothing.
+ */
+static void _static_procedure_free(scheme_element *element) {}
+
 /**** Variable initializations ****/
 
 // Global virtual function table.
 static struct scheme_element_vtable _scheme_procedure_vtable = {
     .get_type = scheme_procedure_get_type,
     .free = _vtable_free,
-    .copy = _vtable_copy,
     .print = _vtable_print,
     .compare = _vtable_compare
 };
@@ -61,6 +94,25 @@ static struct scheme_element_type _scheme_procedure_type = {
 };
 static int _scheme_procedure_type_initd = 0;
 
+// Virtual function table of statically allocated procedures.
+static struct scheme_element_vtable _static_procedure_vtable;
+static int _static_procedure_vtable_initd = 0;
+
+// Procedure wrapping evaluated arguments.
+static scheme_procedure _value_procedure;
+static int _value_procedure_initd = 0;
+
+// Marker returned by a procedure's function that deferred a call.
+static scheme_procedure _tail_call;
+static int _tail_call_initd = 0;
+
+// Call deferred by scheme_procedure_apply_tail().
+static struct {
+    scheme_procedure *procedure;
+    scheme_element *element;
+    scheme_namespace *namespace;
+} _deferred = {NULL, NULL, NULL};
+
 /**** Private function implementations ****/
 
 static void _vtable_free(scheme_element *element)
@@ -68,7 +120,6 @@ static void _vtable_free(scheme_element *element)
     scheme_procedure *procedure = (scheme_procedure *)element;
 
     free(procedure->name);
-    free(procedure);
 }
 
 static void _vtable_print(scheme_element *element)
@@ -81,24 +132,9 @@ static void _vtable_print(scheme_element *element)
         printf("#<procedure>");
 }
 
-static scheme_element *_vtable_copy(scheme_element *element)
-{
-    scheme_procedure *procedure = (scheme_procedure *)element;
-
-    // Create new copy.
-    scheme_procedure *procCopy = malloc(sizeof(scheme_procedure));
-    if (procCopy == NULL)
-        return NULL;
-
-    // Initialize copy.
-    scheme_procedure_init(procCopy, procedure->name, procedure->function);
-
-    return (scheme_element *)procCopy;
-}
-
 static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    if (!scheme_element_is_type(other, &_scheme_procedure_type)) return 0;
+    if (!scheme_element_is_procedure(other)) return 0;
 
     scheme_procedure *this = (scheme_procedure *)element;
     scheme_procedure *that = (scheme_procedure *)other;
@@ -112,10 +148,73 @@ static int _vtable_compare(scheme_element *element, scheme_element *other)
     }
 
     if (this->function != that->function) return 0;
+    if (this->strictFunction != that->strictFunction) return 0;
 
     return 1;
 }
 
+static struct scheme_element_vtable *_static_procedure_vtable_get()
+{
+    if (!_static_procedure_vtable_initd)
+    {
+        scheme_element_vtable_clone(&_static_procedure_vtable, &_scheme_procedure_vtable);
+        _static_procedure_vtable.free = _static_procedure_free;
+
+        _static_procedure_vtable_initd = 1;
+    }
+
+    return &_static_procedure_vtable;
+}
+
+static scheme_element *_value_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+{
+    return scheme_element_copy(scheme_pair_get_first((scheme_pair *)element));
+}
+
+static scheme_element *_strict_function(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+{
+    // Count arguments, making sure they form a list.
+    int count = 0;
+    scheme_element *list = element;
+    while (scheme_element_is_pair(list) && !scheme_pair_is_empty((scheme_pair *)list))
+    {
+        list = scheme_pair_get_second((scheme_pair *)list);
+        ++count;
+    }
+
+    if (!scheme_element_is_pair(list)) return NULL;
+
+    // Evaluate arguments from left to right, into an array on the stack
+    // unless there are many of them.
+    scheme_element *buffer[SCHEME_PROCEDURE_ARGUMENT_COUNT];
+    scheme_element **arguments = buffer;
+    if (count > SCHEME_PROCEDURE_ARGUMENT_COUNT && (arguments = malloc(sizeof(scheme_element *) * count)) == NULL)
+        return NULL;
+
+    int evaluatedCount = 0;
+    for (list = element; evaluatedCount < count; list = scheme_pair_get_second((scheme_pair *)list))
+    {
+        if ((arguments[evaluatedCount] = scheme_evaluate(scheme_pair_get_first((scheme_pair *)list), namespace)) == NULL)
+            break;
+
+        ++evaluatedCount;
+    }
+
+    scheme_element *result = NULL;
+    if (evaluatedCount == count)
+        result = procedure->strictFunction(procedure, arguments, count);
+
+    for (int i = 0; i < evaluatedCount; ++i)
+    {
+        scheme_element_free(arguments[i]);
+    }
+
+    if (arguments != buffer)
+        free(arguments);
+
+    return result;
+}
+
 /**** Implementations of public functions from scheme-procedure.h ****/
 
 char *scheme_procedure_get_name(scheme_procedure *proc)
@@ -133,15 +232,114 @@ char *scheme_procedure_get_name(scheme_procedure *proc)
 scheme_element *scheme_procedure_apply(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
 {
     if (procedure->function == NULL) return NULL;
-    return procedure->function(procedure, element, namespace);
+    scheme_element *result = procedure->function(procedure, element, namespace);
+
+    // Apply deferred procedures until one returns a result. The deferred
+    // call holds the only reference to its namespace, which is how the
+    // namespace of a procedure that made a call in tail position is
+    // released before the callee returns.
+    while (result == (scheme_element *)&_tail_call)
+    {
+        procedure = _deferred.procedure;
+        element = _deferred.element;
+        namespace = _deferred.namespace;
+        _deferred.procedure = NULL;
+        _deferred.element = NULL;
+        _deferred.namespace = NULL;
+
+        result = procedure->function != NULL ? procedure->function(procedure, element, namespace) : NULL;
+
+        scheme_element_free((scheme_element *)procedure);
+        scheme_element_free(element);
+        scheme_element_free((scheme_element *)namespace);
+    }
+
+    return result;
+}
+
+scheme_element *scheme_procedure_apply_tail(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace)
+{
+    if (!_tail_call_initd)
+    {
+        scheme_procedure_init(&_tail_call, "tail-call", NULL);
+        _tail_call.super.vtable = _static_procedure_vtable_get();
+
+        _tail_call_initd = 1;
+    }
+
+    _deferred.procedure = (scheme_procedure *)scheme_element_copy((scheme_element *)procedure);
+    _deferred.element = scheme_element_copy(element);
+    _deferred.namespace = (scheme_namespace *)scheme_element_copy((scheme_element *)namespace);
+
+    return (scheme_element *)&_tail_call;
+}
+
+int scheme_procedure_is_strict(scheme_procedure *procedure)
+{
+    return procedure->strictFunction != NULL;
+}
+
+int scheme_procedure_is_pure(scheme_procedure *procedure)
+{
+    return procedure->pure;
+}
+
+void scheme_procedure_set_pure(scheme_procedure *procedure, int pure)
+{
+    procedure->pure = pure;
+}
+
+scheme_element *scheme_procedure_apply_values(scheme_procedure *procedure,
+                                              scheme_element **arguments,
+                                              int count,
+                                              scheme_namespace *namespace)
+{
+    if (procedure->strictFunction != NULL)
+        return procedure->strictFunction(procedure, arguments, count);
+
+    if (!_value_procedure_initd)
+    {
+        scheme_procedure_init(&_value_procedure, "quote", _value_function);
+        _value_procedure.super.vtable = _static_procedure_vtable_get();
+
+        _value_procedure_initd = 1;
+    }
+
+    scheme_element *list = scheme_element_copy((scheme_element *)scheme_pair_get_empty());
+    for (int i = count - 1; i >= 0; --i)
+    {
+        scheme_element *argument = scheme_element_copy(arguments[i]);
+        enum scheme_element_tag tag = scheme_element_get_tag(argument);
+        if (tag == SCHEME_ELEMENT_TAG_SYMBOL || tag == SCHEME_ELEMENT_TAG_PAIR)
+        {
+            scheme_element *value = (scheme_element *)scheme_pair_new(argument, (scheme_element *)scheme_pair_get_empty());
+            scheme_element_free(argument);
+
+            argument = value != NULL ? (scheme_element *)scheme_pair_new((scheme_element *)&_value_procedure, value) : NULL;
+            scheme_element_free(value);
+        }
+
+        scheme_element *pair = argument != NULL ? (scheme_element *)scheme_pair_new(argument, list) : NULL;
+        scheme_element_free(argument);
+        scheme_element_free(list);
+        if (pair == NULL) return NULL;
+
+        list = pair;
+    }
+
+    scheme_element *result = scheme_procedure_apply(procedure, list, namespace);
+    scheme_element_free(list);
+
+    return result;
 }
 
 /**** Implementations of public functions from scheme-procedure-init.h ****/
 
-void scheme_procedure_init(scheme_procedure *proc, char *name, scheme_procedure_function_t function)
+void scheme_procedure_init(scheme_procedure *proc, const char *name, scheme_procedure_function_t function)
 {
-    // Initialize vtable.
+    // Initialize vtable and tag.
     proc->super.vtable = &_scheme_procedure_vtable;
+    proc->super.tag = SCHEME_ELEMENT_TAG_PROCEDURE;
 
     // Copy name.
     if (name != NULL)
@@ -162,6 +360,14 @@ void scheme_procedure_init(scheme_procedure *proc, char *name, scheme_procedure_
 
     // Copy function.
     proc->function = function;
+    proc->strictFunction = NULL;
+    proc->pure = 0;
+}
+
+void scheme_procedure_init_strict(scheme_procedure *proc, const char *name, scheme_procedure_strict_function_t function)
+{
+    scheme_procedure_init(proc, name, _strict_function);
+    proc->strictFunction = function;
 }
 
 scheme_element_type *scheme_procedure_get_type()
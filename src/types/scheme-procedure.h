@@ -34,6 +34,10 @@ char *scheme_procedure_get_name(scheme_procedure *proc);
  * function. The function stored in a procedure may return NULL as
  * necessary, usually to indicate that it could not evaluate an expression.
  *
+ * If the function defers a call with scheme_procedure_apply_tail(), the
+ * deferred procedure is applied in turn, until one of them returns a
+ * result.
+ *
  * @param  procedure  A Scheme procedure.
  * @param  element    A Scheme element.
  * @param  namespace  Active namespace.
@@ -43,6 +47,78 @@ char *scheme_procedure_get_name(scheme_procedure *proc);
  */
 scheme_element *scheme_procedure_apply(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
 
+/**
+ * Defer applying Scheme procedure on an element to the caller.
+ *
+ * Remember the procedure, element and namespace, and return a marker that
+ * the function stored in a procedure must return as is, right away. Once
+ * the function returns, scheme_procedure_apply() applies the deferred
+ * procedure in its place, so that a chain of calls in tail position runs
+ * in constant stack.
+ *
+ * May only be called by a function stored in a procedure, on its way out.
+ *
+ * @param  procedure  A Scheme procedure.
+ * @param  element    A Scheme element.
+ * @param  namespace  Active namespace.
+ *
+ * @return Marker to be returned by the calling function.
+ */
+scheme_element *scheme_procedure_apply_tail(scheme_procedure *procedure, scheme_element *element, scheme_namespace *namespace);
+
+/**
+ * Check if a Scheme procedure is strict, i.e. if it receives its arguments
+ * already evaluated.
+ *
+ * @param  procedure  A Scheme procedure.
+ *
+ * @return 1 if procedure is strict, 0 otherwise.
+ */
+int scheme_procedure_is_strict(scheme_procedure *procedure);
+
+/**
+ * Check if a Scheme procedure is pure, i.e. if it has no side effects and
+ * its result only depends on its arguments. A call to a pure procedure
+ * with constant arguments can be replaced with its result before it is
+ * evaluated.
+ *
+ * @param  procedure  A Scheme procedure.
+ *
+ * @return 1 if procedure is pure, 0 otherwise.
+ */
+int scheme_procedure_is_pure(scheme_procedure *procedure);
+
+/**
+ * Mark a Scheme procedure as pure or not. Procedures are not pure unless
+ * marked otherwise.
+ *
+ * @param  procedure  A Scheme procedure.
+ * @param  pure       1 if procedure is pure, 0 otherwise.
+ */
+void scheme_procedure_set_pure(scheme_procedure *procedure, int pure);
+
+/**
+ * Apply Scheme procedure on arguments that have already been evaluated.
+ *
+ * A strict procedure is given the arguments as is. Other built-in
+ * procedures evaluate their arguments themselves, so arguments that would
+ * not evaluate to themselves, such as symbols and pairs, are wrapped in a
+ * call to a procedure that returns them as is.
+ *
+ * Caller must free returned pointer with scheme_element_free().
+ *
+ * @param  procedure  A Scheme procedure that evaluates its arguments.
+ * @param  arguments  Array of evaluated arguments.
+ * @param  count      Number of arguments.
+ * @param  namespace  Active namespace.
+ *
+ * @return Result of applying procedure, or NULL if an error occurs.
+ */
+scheme_element *scheme_procedure_apply_values(scheme_procedure *procedure,
+                                              scheme_element **arguments,
+                                              int count,
+                                              scheme_namespace *namespace);
+
 /**
  * Get procedure's type.
  *
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "scheme-reference.h"
+#include "scheme-element-private.h"
+
+// Scheme variable reference.
+struct scheme_reference {
+    struct scheme_element super;
+    scheme_symbol *symbol;
+    int depth;
+    int slot;
+};
+
+/**** Private function declarations ****/
+
+/**
+ * Variable references do not own any other resource, since symbols are
+ * never deallocated. This function does nothing.
+ *
+ * @param  element  Should be a Scheme variable reference.
+ */
+static void _vtable_free(scheme_element *element);
+
+/**
+ * Print variable reference's identifier to stdout.
+ *
+ * @param  element  Should be a Scheme variable reference.
+ */
+static void _vtable_print(scheme_element *element);
+
+/**
+ * Compare variable reference to another element.
+ * Will return 0 if other element is not a variable reference.
+ *
+ * @param  element  Should be a Scheme variable reference.
+ * @param  other    Other element.
+ *
+ * @return 1 if equal, 0 otherwise.
+ */
+static int _vtable_compare(scheme_element *element, scheme_element *other);
+
+/**** Private variables ****/
+
+// Global virtual function table.
+static struct scheme_element_vtable _scheme_reference_vtable = {
+    .get_type = scheme_reference_get_type,
+    .free = _vtable_free,
+    .print = _vtable_print,
+    .compare = _vtable_compare
+};
+
+// Global variable reference type.
+static struct scheme_element_type _scheme_reference_type = {
+    .super = NULL,
+    .name = "scheme_reference"
+};
+static int _scheme_reference_type_initd = 0;
+
+/**** Private function implementations ****/
+
+static void _vtable_free(scheme_element *element) {}
+
+static void _vtable_print(scheme_element *element)
+{
+    scheme_reference *reference = (scheme_reference *)element;
+    scheme_element_print((scheme_element *)reference->symbol);
+}
+
+static int _vtable_compare(scheme_element *element, scheme_element *other)
+{
+    if (!scheme_element_is_reference(other)) return 0;
+
+    scheme_reference *this = (scheme_reference *)element;
+    scheme_reference *that = (scheme_reference *)other;
+
+    return this->symbol == that->symbol && this->depth == that->depth && this->slot == that->slot;
+}
+
+/**** Public function implementations ****/
+
+scheme_reference *scheme_reference_new(scheme_symbol *symbol, int depth, int slot)
+{
+    // Allocate reference.
+    scheme_reference *reference;
+    if ((reference = (scheme_reference *)scheme_element_new(sizeof(scheme_reference), &_scheme_reference_vtable, SCHEME_ELEMENT_TAG_REFERENCE)) == NULL)
+        return NULL;
+
+    reference->symbol = symbol;
+    reference->depth = depth;
+    reference->slot = slot;
+
+    return reference;
+}
+
+scheme_symbol *scheme_reference_get_symbol(scheme_reference *reference)
+{
+    return reference->symbol;
+}
+
+int scheme_reference_get_depth(scheme_reference *reference)
+{
+    return reference->depth;
+}
+
+int scheme_reference_get_slot(scheme_reference *reference)
+{
+    return reference->slot;
+}
+
+scheme_element *scheme_reference_lookup_ref(scheme_reference *reference, scheme_namespace *namespace)
+{
+    if (reference->depth != SCHEME_REFERENCE_DYNAMIC)
+    {
+        scheme_element *element = scheme_namespace_lookup_slot_ref(namespace, reference->depth, reference->slot, reference->symbol);
+        if (element != NULL) return element;
+    }
+
+    // Variable is not where the resolver expected it to be.
+    return scheme_namespace_lookup_ref(namespace, reference->symbol);
+}
+
+scheme_element_type *scheme_reference_get_type()
+{
+    if (!_scheme_reference_type_initd)
+    {
+        _scheme_reference_type.super = scheme_element_get_base_type();
+
+        _scheme_reference_type_initd = 1;
+    }
+
+    return &_scheme_reference_type;
+}
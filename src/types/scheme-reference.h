@@ -0,0 +1,92 @@
+/**
+ * Scheme variable reference.
+ *
+ * A symbol that the resolver has found to refer to a variable bound in an
+ * enclosing namespace, along with where that variable is stored: the number
+ * of supersets to go through from the active namespace, and the variable's
+ * slot in the namespace reached. Evaluating a reference looks the variable
+ * up by slot, falling back to looking up its symbol if the slot does not
+ * hold it.
+ *
+ * A reference with a depth of SCHEME_REFERENCE_DYNAMIC refers to a variable
+ * that an enclosing procedure body may define at run time, so it has no
+ * known slot and is always looked up by its symbol. Code that treats
+ * symbols specially, such as special forms and inline caches, must not
+ * treat such a variable as its symbol.
+ *
+ * This type is compatible with scheme_element.
+ * You may cast any scheme_reference pointer to scheme_element and pass it to
+ * any function that accepts a scheme_element pointer.
+ */
+
+#ifndef __SCHEME_REFERENCE_H__
+#define __SCHEME_REFERENCE_H__
+
+#include "scheme-element.h"
+#include "scheme-symbol.h"
+#include "scheme-namespace.h"
+
+// Scheme variable reference.
+typedef struct scheme_reference scheme_reference;
+
+// Depth of a reference to a variable that may be defined at run time.
+#define SCHEME_REFERENCE_DYNAMIC (-1)
+
+/**
+ * Create new Scheme variable reference.
+ *
+ * Returned pointer must be freed with scheme_element_free().
+ *
+ * @param  symbol  Variable's identifier.
+ * @param  depth   Number of supersets to go through, or
+ *                 SCHEME_REFERENCE_DYNAMIC.
+ * @param  slot    Variable's slot in the namespace reached, ignored if depth
+ *                 is SCHEME_REFERENCE_DYNAMIC.
+ *
+ * @return Newly created reference, or NULL if out of memory.
+ */
+scheme_reference *scheme_reference_new(scheme_symbol *symbol, int depth, int slot);
+
+/**
+ * Get variable's identifier.
+ *
+ * @param  reference  A variable reference.
+ */
+scheme_symbol *scheme_reference_get_symbol(scheme_reference *reference);
+
+/**
+ * Get number of supersets to go through, or SCHEME_REFERENCE_DYNAMIC.
+ *
+ * @param  reference  A variable reference.
+ */
+int scheme_reference_get_depth(scheme_reference *reference);
+
+/**
+ * Get variable's slot.
+ *
+ * @param  reference  A variable reference.
+ */
+int scheme_reference_get_slot(scheme_reference *reference);
+
+/**
+ * Look up the element a variable reference refers to, without acquiring a
+ * reference to it.
+ *
+ * The same rules as scheme_namespace_lookup_ref() apply to the returned
+ * element.
+ *
+ * @param  reference  A variable reference.
+ * @param  namespace  Active namespace.
+ *
+ * @return Element, or NULL if the variable is not bound.
+ */
+scheme_element *scheme_reference_lookup_ref(scheme_reference *reference, scheme_namespace *namespace);
+
+/**
+ * Get variable reference's type.
+ *
+ * @return Variable reference's type.
+ */
+scheme_element_type *scheme_reference_get_type();
+
+#endif
@@ -4,18 +4,24 @@
 
 #include "scheme-symbol.h"
 #include "scheme-element-private.h"
+#include "scheme-gc.h"
+
+#define SCHEME_SYMBOL_TABLE_INITIAL_SIZE 256
 
 // Scheme symbol.
 struct scheme_symbol {
     struct scheme_element super;
     char *value;
     int length;  // Length of value NOT including \0
+    unsigned int hash;
+    // Element the symbol refers to in every namespace, or NULL.
+    scheme_element *builtin;
 };
 
 /**** Private function declarations ****/
 
 /**
- * Free Scheme symbol.
+ * Symbols are interned and never deallocated. This function does nothing.
  *
  * @param  element  Should be a Scheme symbol.
  */
@@ -28,15 +34,6 @@ static void _vtable_free(scheme_element *element);
  */
 static void _vtable_print(scheme_element *element);
 
-/**
- * Copy symbol.
- *
- * @param  element  Should be a Scheme symbol.
- *
- * @return Copy or NULL if out of memory.
- */
-static scheme_element *_vtable_copy(scheme_element *element);
-
 /**
  * Compare Scheme symbol to another symbol.
  * Will return 0 if either pointers are not symbols.
@@ -48,6 +45,23 @@ static scheme_element *_vtable_copy(scheme_element *element);
  */
 static int _vtable_compare(scheme_element *element, scheme_element *other);
 
+/**
+ * Compute hash of a string.
+ *
+ * @param  value   A string.
+ * @param  length  Length of string.
+ *
+ * @return Hash of string.
+ */
+static unsigned int _hash(const char *value, int length);
+
+/**
+ * Double the capacity of the symbol table.
+ *
+ * @return 1 on success, 0 if out of memory.
+ */
+static int _grow_table();
+
 /**** Private variables ****/
 
 // Global virtual function table.
@@ -55,7 +69,6 @@ static struct scheme_element_vtable _scheme_symbol_vtable = {
     .get_type = scheme_symbol_get_type,
     .free = _vtable_free,
     .print = _vtable_print,
-    .copy = _vtable_copy,
     .compare = _vtable_compare
 };
 
@@ -66,15 +79,15 @@ static struct scheme_element_type _scheme_symbol_type = {
 };
 static int _scheme_symbol_type_initd = 0;
 
-/**** Private function implementations ****/
+// Table of every symbol ever created, using open addressing. Its size is
+// always a power of 2.
+static scheme_symbol **_table = NULL;
+static int _tableCount = 0;
+static int _tableSize = 0;
 
-void _vtable_free(scheme_element *element)
-{
-    scheme_symbol *symbol = (scheme_symbol *)element;
+/**** Private function implementations ****/
 
-    free((scheme_symbol *)symbol->value);
-    free(symbol);
-}
+static void _vtable_free(scheme_element *element) {}
 
 static void _vtable_print(scheme_element *element)
 {
@@ -82,47 +95,97 @@ static void _vtable_print(scheme_element *element)
     printf("%s", symbol->value);
 }
 
-static scheme_element *_vtable_copy(scheme_element *element)
+static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    scheme_symbol *symbol = (scheme_symbol *)element;
-    return (scheme_element *)scheme_symbol_new(symbol->value);
+    // Symbols are interned, so equal symbols are the same symbol.
+    return element == other;
 }
 
-static int _vtable_compare(scheme_element *element, scheme_element *other)
+static unsigned int _hash(const char *value, int length)
 {
-    if (!scheme_element_is_type(other, &_scheme_symbol_type)) return 0;
+    // FNV-1a.
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)value[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
 
-    char *firstVal = ((scheme_symbol *)element)->value;
-    char *secondVal = ((scheme_symbol *)other)->value;
+static int _grow_table()
+{
+    int newSize = _tableSize > 0 ? _tableSize * 2 : SCHEME_SYMBOL_TABLE_INITIAL_SIZE;
+    scheme_symbol **newTable = calloc(newSize, sizeof(scheme_symbol *));
+    if (newTable == NULL) return 0;
+
+    // Reinsert every symbol.
+    for (int i = 0; i < _tableSize; ++i)
+    {
+        scheme_symbol *symbol = _table[i];
+        if (symbol == NULL) continue;
 
-    return strcmp(firstVal, secondVal) == 0;
+        unsigned int index = symbol->hash & (newSize - 1);
+        while (newTable[index] != NULL)
+            index = (index + 1) & (newSize - 1);
+
+        newTable[index] = symbol;
+    }
+
+    free(_table);
+    _table = newTable;
+    _tableSize = newSize;
+    return 1;
 }
 
 /**** Public function implementations ****/
 
-scheme_symbol *scheme_symbol_new(char *value)
+scheme_symbol *scheme_symbol_new(const char *value)
 {
-    // Allocate symbol.
-    scheme_symbol *symbol;
-    if ((symbol = malloc(sizeof(scheme_symbol))) == NULL)
-        return NULL;
+    int length = strlen(value);
+    unsigned int hash = _hash(value, length);
 
-    // Set up virtual function table.
-    symbol->super.vtable = &_scheme_symbol_vtable;
+    // Look for an existing symbol with this value. Keep the table at most
+    // half full so that probe sequences stay short.
+    if (_tableCount * 2 >= _tableSize && !_grow_table())
+        return NULL;
 
-    // Copy value string.
-    char *idBuffer;
-    int bufLen = strlen(value) + 1;  // Make space for \0
-    if ((idBuffer = malloc(sizeof(char) * bufLen)) == NULL)
+    unsigned int index = hash & (_tableSize - 1);
+    while (_table[index] != NULL)
     {
-        free(symbol);
-        return NULL;
+        scheme_symbol *symbol = _table[index];
+        if (symbol->hash == hash && symbol->length == length && memcmp(symbol->value, value, length) == 0)
+            return symbol;
+
+        index = (index + 1) & (_tableSize - 1);
     }
 
-    strcpy(idBuffer, value);
+    // Allocate symbol, followed by its value string. Symbols live as long
+    // as the program and are neither reference counted nor moved by the
+    // garbage collector, since the table refers to them.
+    scheme_symbol *symbol;
+    if ((symbol = scheme_gc_allocate_permanent(sizeof(scheme_symbol) + sizeof(char) * (length + 1))) == NULL)
+        return NULL;
 
+    // Copy value string.
+    char *idBuffer = (char *)(symbol + 1);
+    memcpy(idBuffer, value, length + 1);
+
+    symbol->super.vtable = &_scheme_symbol_vtable;
+    symbol->super.tag = SCHEME_ELEMENT_TAG_SYMBOL;
+    symbol->super.refCount = 0;
+    symbol->super.gcFlags = 0;
+    symbol->super.gcSize = sizeof(scheme_symbol);
+    symbol->super.gcPrevious = NULL;
+    symbol->super.gcNext = NULL;
     symbol->value = idBuffer;
-    symbol->length = bufLen;
+    symbol->length = length;
+    symbol->hash = hash;
+    symbol->builtin = NULL;
+
+    _table[index] = symbol;
+    ++_tableCount;
 
     return symbol;
 }
@@ -131,23 +194,36 @@ char *scheme_symbol_get_value(scheme_symbol *symbol)
 {
     // Allocate return buffer.
     char *returnBuf;
-    int length = symbol->length + 1;  // Make room for \0
-    if ((returnBuf = malloc(sizeof(char) * length)) == NULL)
+    if ((returnBuf = malloc(sizeof(char) * (symbol->length + 1))) == NULL)
         return NULL;
 
     // Copy value.
-    char *value = symbol->value;
-    int i;
-    for (i = 0; i < length && value[i] != '\0'; ++i)
-    {
-        returnBuf[i] = value[i];
-    }
-    returnBuf[i] = '\0';
+    memcpy(returnBuf, symbol->value, symbol->length + 1);
 
     return returnBuf;
 }
 
-int scheme_symbol_value_equals(scheme_symbol *symbol, char *value)
+const char *scheme_symbol_get_value_ref(scheme_symbol *symbol)
+{
+    return symbol->value;
+}
+
+unsigned int scheme_symbol_get_hash(scheme_symbol *symbol)
+{
+    return symbol->hash;
+}
+
+scheme_element *scheme_symbol_get_builtin(scheme_symbol *symbol)
+{
+    return symbol->builtin;
+}
+
+void scheme_symbol_set_builtin(scheme_symbol *symbol, scheme_element *element)
+{
+    symbol->builtin = element;
+}
+
+int scheme_symbol_value_equals(scheme_symbol *symbol, const char *value)
 {
     if (symbol == NULL || value == NULL) return 0;
 
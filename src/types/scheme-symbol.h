@@ -15,14 +15,18 @@
 typedef struct scheme_symbol scheme_symbol;
 
 /**
- * Create new Scheme symbol.
- * Symbol must be freed afterwards with scheme_element_free().
+ * Get the Scheme symbol with the given value.
+ *
+ * Symbols are interned: there is only ever one symbol for a given value,
+ * so two symbols are equal if and only if they are the same pointer.
+ * Symbols are never deallocated; passing one to scheme_element_free() does
+ * nothing.
  *
  * @param  value  Symbol's value.
  *
- * @return Newly created symbol, or NULL if out of memory.
+ * @return The symbol, or NULL if out of memory.
  */
-scheme_symbol *scheme_symbol_new(char *value);
+scheme_symbol *scheme_symbol_new(const char *value);
 
 /**
  * Get value.
@@ -32,6 +36,43 @@ scheme_symbol *scheme_symbol_new(char *value);
  */
 char *scheme_symbol_get_value(scheme_symbol *symbol);
 
+/**
+ * Get value without copying it.
+ * Returned string belongs to the symbol and must not be modified or freed.
+ *
+ * @param  symbol  A symbol.
+ */
+const char *scheme_symbol_get_value_ref(scheme_symbol *symbol);
+
+/**
+ * Get hash of symbol's value, suitable for hash tables keyed on symbols.
+ *
+ * @param  symbol  A symbol.
+ */
+unsigned int scheme_symbol_get_hash(scheme_symbol *symbol);
+
+/**
+ * Get the built-in element a symbol refers to in every namespace, which can
+ * be used without looking the symbol up.
+ *
+ * @param  symbol  A symbol.
+ *
+ * @return The element, or NULL if the symbol has none or has been bound
+ *         since it was set.
+ */
+scheme_element *scheme_symbol_get_builtin(scheme_symbol *symbol);
+
+/**
+ * Set the built-in element a symbol refers to in every namespace. The
+ * element must outlive the symbol, and must be the one the symbol is bound
+ * to in the base namespace. Binding the symbol in any namespace afterwards
+ * unsets it for good.
+ *
+ * @param  symbol   A symbol.
+ * @param  element  A statically allocated element, or NULL to unset it.
+ */
+void scheme_symbol_set_builtin(scheme_symbol *symbol, scheme_element *element);
+
 /**
  * Compare Scheme symbol's value to a string.
  * Will return 0 if either pointer is NULL.
@@ -41,7 +82,7 @@ char *scheme_symbol_get_value(scheme_symbol *symbol);
  *
  * @return 1 if string and symbol's values are equal, 0 otherwise.
  */
-int scheme_symbol_value_equals(scheme_symbol *symbol, char *value);
+int scheme_symbol_value_equals(scheme_symbol *symbol, const char *value);
 
 /**
  * Get Scheme symbol's type.
@@ -27,16 +27,6 @@ static void _vtable_free(scheme_element *element);
  */
 static void _vtable_print(scheme_element *element);
 
-/**
- * A void symbol cannot be copied. This function returns the pointer
- * as-is.
- *
- * @param  element  Should be a Scheme void symbol.
- *
- * @return Given pointer as-is.
- */
-static scheme_element *_vtable_copy(scheme_element *element);
-
 /**
  * Compare void symbol to another symbol.
  *
@@ -54,13 +44,13 @@ static struct scheme_element_vtable _scheme_void_vtable = {
     .get_type = scheme_void_get_type,
     .free = _vtable_free,
     .print = _vtable_print,
-    .copy = _vtable_copy,
     .compare = _vtable_compare
 };
 
 // Static variable for void symbol.
 static struct scheme_void _scheme_void_symbol = {
-    .super.vtable = &_scheme_void_vtable
+    .super.vtable = &_scheme_void_vtable,
+    .super.tag = SCHEME_ELEMENT_TAG_VOID
 };
 
 // Static struct for void element's type.
@@ -80,14 +70,9 @@ static void _vtable_print(scheme_element *element)
 {
 }
 
-static scheme_element *_vtable_copy(scheme_element *element)
-{
-    return element;
-}
-
 static int _vtable_compare(scheme_element *element, scheme_element *other)
 {
-    if (!scheme_element_is_type(other, &_scheme_void_type)) return 0;
+    if (!scheme_element_is_void(other)) return 0;
 
     return element == other;
 }
@@ -0,0 +1,17 @@
+(and 1 (quote ()))
+(and (quote ()) 1)
+(and 1 #f)
+(and 1 2)
+(and (quote ()))
+(or #f (quote ()))
+(or (quote ()) 1)
+(or (quote ()) #f)
+(or 1 #f)
+(or (quote ()))
+(or #f #f)
+(and)
+(or)
+(and 1 2 (quote ()))
+(and #f 1)
+(define (loop n) (cond ((= n 0) (quote done)) (else (or #f (loop (- n 1))))))
+(loop 100000)
@@ -0,0 +1,12 @@
+(cond ((quote ()) 1) (else 2))
+(cond ((quote ())) (else 2))
+(cond (#f 1) (else 2))
+(cond (#f) (else 2))
+(cond (0 1) (else 2))
+(define (cn x) (cond (x 1) (else 2)))
+(cn (quote ()))
+(cn #f)
+(define (cs x) (cond (x) (else 2)))
+(cs (quote ()))
+(cs #f)
+(if (quote ()) 1 2)
@@ -0,0 +1,20 @@
+# Run the interpreter on a Scheme file and compare its output with the
+# expected output.
+#
+# Usage: cmake -DSCHEME=<path> -DPROCEDURES=<folder> -DENGINE=<engine>
+#              -DINPUT=<file> -DEXPECTED=<file> [-DOPTIONS=<options>]
+#              -P run-test.cmake
+
+EXECUTE_PROCESS(COMMAND ${SCHEME} --procedures=${PROCEDURES} --engine=${ENGINE} ${OPTIONS}
+                INPUT_FILE ${INPUT}
+                OUTPUT_VARIABLE OUTPUT
+                RESULT_VARIABLE RESULT)
+
+IF(NOT RESULT EQUAL 0)
+    MESSAGE(FATAL_ERROR "Interpreter exited with '${RESULT}', output:\n${OUTPUT}")
+ENDIF()
+
+FILE(READ ${EXPECTED} EXPECTED_OUTPUT)
+IF(NOT OUTPUT STREQUAL EXPECTED_OUTPUT)
+    MESSAGE(FATAL_ERROR "Output differs from '${EXPECTED}':\n${OUTPUT}")
+ENDIF()
@@ -0,0 +1,11 @@
+(define (f x) (quote global))
+(define (outer c) (if c (define f (lambda (x) (quote local))) 0) (lambda (x) (f x)))
+(define a (outer #t))
+(define b (outer #f))
+(a 1)
+(b 1)
+(a 1)
+(b 1)
+(define (f x) (quote redefined))
+(a 1)
+(b 1)
@@ -0,0 +1,17 @@
+(define (g2) (define if (lambda (a b c) 42)) (if 1 2 3))
+(g2)
+(define (g3 c) (if c (define if (lambda (a b c) 42)) 0) (if 1 2 3))
+(g3 #f)
+(g3 #t)
+(if 1 2 3)
+(define (g4 x) (define cond (lambda (a) (quote shadowed))) (cond x))
+(g4 5)
+(define (g5 x) (cond (x (quote builtin)) (else 0)))
+(g5 #t)
+((lambda (let) (let 7)) (lambda (x) x))
+(define (g) (define and (lambda (a b) 42)) (and 1 2))
+(g)
+(define (h) (define or (lambda (a b) 43)) (or #f 2))
+(h)
+((lambda (and) (and 1 2)) (lambda (a b) 44))
+(and 1 2)